@@ -0,0 +1,167 @@
+/*
+  ___ ___                _________        .__
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/
+
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+--- Description: ---
+Asset compiler. Draws the tags and labels that never change shape with
+the firmware's own draw functions on the mock panel, run-length encodes
+the pixels and writes them to ../source/assets.h for blitAsset(). Each
+asset is drawn in stand-in colors so every pixel can be traced back to
+fg_color, bg_color or plain black, and the blit can bring it back in
+any colors. An asset that comes out in some other color is an error.
+
+Usage: assetgen > ../source/assets.h   (or just `make` in this folder)
+*/
+
+#include <Arduino.h>
+#include "mock.h"
+
+#define HEXCALC_ASSETS  0                                                      // Rasterize from the font (this is what makes assets.h)
+#define HEXCALC_STATS   0
+#define HEXCALC_REMOTE  0
+#define HEXCALC_PERSIST 0
+
+#include "HexCalc.ino"
+
+#define ASSET_BLACK 0                                                          // Run colors (as assets.h defines them)
+#define ASSET_FG    1
+#define ASSET_BG    2
+
+#define STAND_IN_FG        0xF800                                              // fg_color while drawing
+#define STAND_IN_BG        0x001F                                              // bg_color while drawing
+#define STAND_IN_UNTOUCHED 0x07E0                                              // The panel before drawing (pixels the draw leaves alone come out black)
+
+static uint32_t total_bytes = 0;                                               // Flash taken by the runs
+static char     entry[64];                                                     // Asset initializer of the last emitRuns()
+
+static bool emitRuns( const char *name, const char *comment ){                 // Encodes the pixels drawn since clearPanel() as name_rle[] and returns false if it can't
+  mock_panel_flush();
+  int16_t x0 = MOCK_PANEL_WIDTH, y0 = MOCK_PANEL_HEIGHT, x1 = -1, y1 = -1;     // Bounding box of the touched pixels
+  for( int16_t y = 0; y < MOCK_PANEL_HEIGHT; y++ ){
+    for( int16_t x = 0; x < MOCK_PANEL_WIDTH; x++ ){
+      if( mock_framebuffer[y * MOCK_PANEL_WIDTH + x] == STAND_IN_UNTOUCHED ) continue;
+      if( x < x0 ) x0 = x;
+      if( x > x1 ) x1 = x;
+      if( y < y0 ) y0 = y;
+      if( y > y1 ) y1 = y;
+    }
+  }
+  if( x1 < 0 || x0 != 0 || y0 != 0 ){ fprintf( stderr, "assetgen: %s was not drawn at 0,0\n", name ); return false; }
+
+  uint8_t  runs[MOCK_PANEL_WIDTH * MOCK_PANEL_HEIGHT];
+  uint32_t num_runs = 0;
+  int8_t   color = -1;                                                         // ASSET_* of the run being collected
+  uint8_t  length = 0;
+  for( int16_t y = 0; y <= y1; y++ ){
+    for( int16_t x = 0; x <= x1; x++ ){
+      uint16_t pixel = mock_framebuffer[y * MOCK_PANEL_WIDTH + x];
+      int8_t   c = pixel == STAND_IN_FG ? ASSET_FG : pixel == STAND_IN_BG ? ASSET_BG :
+                   (pixel == ST77XX_BLACK || pixel == STAND_IN_UNTOUCHED) ? ASSET_BLACK : -1;
+      if( c < 0 ){ fprintf( stderr, "assetgen: %s has a pixel of 0x%04X at %d,%d\n", name, pixel, x, y ); return false; }
+      if( c != color || length == 64 ){
+        if( length ) runs[num_runs++] = (color << 6) | (length - 1);
+        color  = c;
+        length = 0;
+      }
+      length++;
+    }
+  }
+  runs[num_runs++] = (color << 6) | (length - 1);
+
+  printf( "const uint8_t %s[%u] = {                                             // %s, %dx%d\n", name, num_runs, comment, x1 + 1, y1 + 1 );
+  for( uint32_t i = 0; i < num_runs; i++ ){
+    printf( "%s0x%02X%s", i % 16 ? "" : "  ", runs[i], i == num_runs - 1 ? "\n" : i % 16 == 15 ? ",\n" : ", " );
+  }
+  printf( "};\n\n" );
+  snprintf( entry, sizeof(entry), "{ %d, %d, %u, %s }", x1 + 1, y1 + 1, num_runs, name );
+  total_bytes += num_runs;
+  return true;
+}
+
+static void clearPanel(){                                                      // Marks every pixel as untouched
+  mock_panel_flush();
+  for( uint32_t i = 0; i < MOCK_PANEL_WIDTH * MOCK_PANEL_HEIGHT; i++ ) mock_framebuffer[i] = STAND_IN_UNTOUCHED;
+}
+
+int main(){
+  printf( "#ifndef _ASSETS_H_\n#define _ASSETS_H_\n\n" );
+  printf( "// Generated by host/assetgen.cpp from the draw functions in HexCalc.ino. Do not edit, run make in host/ instead.\n" );
+  printf( "//\n" );
+  printf( "// Each byte is a run of pixels, left to right and top to bottom: the top two bits are its color\n" );
+  printf( "// (ASSET_*) and the low six its length less one. DxCore keeps const data in the memory-mapped\n" );
+  printf( "// flash, so none of this takes up RAM.\n\n" );
+  printf( "#include <stdint.h>\n\n" );
+  printf( "#define ASSET_BLACK 0                                                          // Always black (e.g. the corners around a pill)\n" );
+  printf( "#define ASSET_FG    1                                                          // The fg_color it was drawn with\n" );
+  printf( "#define ASSET_BG    2                                                          // The bg_color it was drawn with\n\n" );
+  printf( "struct Asset{\n" );
+  printf( "  uint8_t        width, height;                                               // Size in pixels\n" );
+  printf( "  uint16_t       runs;                                                        // Number of runs (bytes) in rle\n" );
+  printf( "  const uint8_t *rle;\n" );
+  printf( "};\n\n" );
+
+  char name[32], comment[32];
+  char tags[5][64], ops[OP_COUNT + 1][64], labels[2][64];                      // Initializers of the Asset tables
+  bool ok = true;
+  for( uint8_t i = 0; ok && i < 5; i++ ){                                      // Mode tags (as drawTagWidget draws them)
+    clearPanel();
+    drawTag( 0, 0, 1, 2, STAND_IN_FG, STAND_IN_BG, tag_label[i], 3 );
+    snprintf( name, sizeof(name), "asset_tag_%u", i );
+    snprintf( comment, sizeof(comment), "\"%s\" tag", tag_label[i] );
+    ok = emitRuns( name, comment );
+    strcpy( tags[i], entry );
+  }
+  for( uint8_t op = 0; ok && op <= OP_COUNT; op++ ){                           // Operator tags (as drawOpTag draws them), then the error tag
+    const char *label = op < OP_COUNT ? op_label[op] : "ERR";
+    clearPanel();
+    drawTag( 0, 0, 2, 2, STAND_IN_FG, STAND_IN_BG, label, strlen( label ) );
+    if( op < OP_COUNT ) snprintf( name, sizeof(name), "asset_op_%u", op );
+    else                snprintf( name, sizeof(name), "asset_op_error" );
+    snprintf( comment, sizeof(comment), "\"%s\" operator tag", label );
+    ok = emitRuns( name, comment );
+    strcpy( ops[op], entry );
+  }
+  for( uint8_t i = 0; ok && i < 2; i++ ){                                      // Decimal menu labels (as drawDecLabel draws them)
+    clearPanel();
+    drawString( 0, 0, dec_label_layout, STAND_IN_FG, STAND_IN_BG, 0, i ? "OCT:" : "HEX:" );
+    snprintf( name, sizeof(name), "asset_dec_label_%u", i );
+    snprintf( comment, sizeof(comment), "\"%s\" label", i ? "OCT:" : "HEX:" );
+    ok = emitRuns( name, comment );
+    strcpy( labels[i], entry );
+  }
+  if( !ok ) return 1;
+
+  printf( "const Asset tag_assets[5] = {                                                   // By tag_label\n" );
+  for( uint8_t i = 0; i < 5; i++ ) printf( "  %s%s\n", tags[i], i == 4 ? "" : "," );
+  printf( "};\n" );
+  printf( "const Asset op_assets[%d] = {                                                  // By op_command\n", OP_COUNT );
+  for( uint8_t op = 0; op < OP_COUNT; op++ ) printf( "  %s%s\n", ops[op], op == OP_COUNT - 1 ? "" : "," );
+  printf( "};\n" );
+  printf( "const Asset op_error_asset = %s;\n", ops[OP_COUNT] );
+  printf( "const Asset dec_label_assets[2] = {                                             // HEX: and OCT:\n" );
+  for( uint8_t i = 0; i < 2; i++ ) printf( "  %s%s\n", labels[i], i == 1 ? "" : "," );
+  printf( "};\n\n" );
+  printf( "// %u bytes of runs in all\n\n", total_bytes );
+  printf( "#endif\n" );
+  return 0;
+}
@@ -0,0 +1,1904 @@
+/*
+  ___ ___                _________        .__
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/
+
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+--- Description: ---
+Render-cost benchmark for the host build. It boots the real firmware
+against the mock panel, replays scripted key sequences through
+manageKeyPress() in every menu mode and bit depth, and reports the SPI
+traffic and host time spent per renderScreen() call. With --format it
+instead checks the decimal formatter in format.h against the original
+"% 10, / 10" loop and compares their cost at full 64-bit values. With
+--keypad it presses keys on the mock keypad matrix, contact bounce and
+all, while loop() runs, and checks that every key reaches
+manageKeyPress() once and in order, and how long it takes to get there
+(build with -DKEYPAD_INTERRUPTS=0 to compare against the polled scan).
+With --ops it checks every Calculator kernel in every bit depth against
+the 64-bit-and-mask version and estimates what each costs on the AVR,
+then checks the extended precision operations against the compiler's
+128-bit integers and that the slowest of them still fits in a frame.
+With --calc it fuzzes the Calculator against a plain reference model in
+every bit depth, base and color mode, checks a table of edge cases and
+reports the operations per second of every operation. With --stats it
+types on the keypad like --keypad does, then asks the firmware's stats
+block (stats.h, built in here) for its CSV dumps of the counters and the
+stack use over the mock serial port and checks that the reset command
+clears them. With --remote it drives the calculator through the serial
+remote control (remote.h) instead of the keypad, checks the answers and
+that a batch is drawn once, streams register dumps through stream.h
+(checked against printf, then at 115200 baud on a paced port for line
+rate and flow control), and runs a line over a real pty. With --boot it
+power cycles the firmware, each boot in a fresh process on a panel full
+of noise, and checks how soon the first frame is up, that the state
+saved in the EEPROM (persist.h) comes back, that a save cut short falls
+back to the one before it and how evenly the saves wear the EEPROM.
+With --profile it replays a fixed key script at the real SPI speed and
+writes a CSV line per key (the calculator operation's estimated AVR
+cycles, the SPI traffic and the time of every render stage) that can be
+diffed between commits.
+
+Usage: bench [-n reps] [-v] [--csv] [--dump dir] [--no-decode] [--format] [--keypad] [--ops] [--calc] [--stats] [--remote] [--boot] [--profile]
+  -n reps     Number of timed repetitions of each script (default 20)
+  -v          Print the cost of every individual frame
+  --csv       Machine-readable output
+  --dump dir  Write a PPM screenshot of every scenario into dir
+  --no-decode Count SPI traffic without decoding it into the framebuffer, so
+              host time reflects the firmware alone (fb hash is not meaningful)
+  --format    Run the decimal conversion comparison instead of the render benchmark
+  --keypad    Run the keypad latency / lost key test instead of the render benchmark
+  --ops       Run the Calculator kernel check / cost table instead of the render benchmark
+  --calc      Run the Calculator fuzz / edge case / throughput test (-n runs of the fuzz)
+  --stats     Run a keypad test at 12MHz and dump the firmware's render / keypad stats and memory use
+  --remote    Drive the calculator over the serial remote control (-n thousands of random lines)
+  --boot      Power cycle the firmware: first frame time, resume from the EEPROM, torn saves and wear
+  --profile   Replay a fixed key script and write a CSV line of costs per key (for diffing between commits)
+*/
+
+#include <algorithm>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <Arduino.h>
+#include "mock.h"
+
+#ifndef HEXCALC_STATS
+#define HEXCALC_STATS 1                                                        // Build the stats block in (for --stats)
+#endif
+#ifndef HEXCALC_REMOTE
+#define HEXCALC_REMOTE 1                                                       // Build the remote control in (for --remote)
+#endif
+
+static uint32_t wide_steps;                                                    // Limb steps taken by the WideInt operations (see wideint.h)
+#define WIDE_STEPS( limbs ) (wide_steps += (limbs))
+
+#include "HexCalc.ino"
+
+/*******************************************
+* Key Scripts                              *
+*******************************************/
+#define END_OF_SCRIPT 0xFF                                                     // Terminates a key script
+
+static const uint8_t script_number[] = {                                       // Digit entry, a two-step operation and the one-step operations
+  KEY_ALL_CLEAR, KEY_1, KEY_2, KEY_3, KEY_4, KEY_5, KEY_6, KEY_7,
+  KEY_PLUS, KEY_7, KEY_6, KEY_5, KEY_EQUALS,
+  KEY_ROL, KEY_LSHIFT, KEY_BYTE_FLIP, KEY_1S, KEY_FF, KEY_CLR, END_OF_SCRIPT
+};
+
+static const uint8_t script_color[] = {                                        // Channel adjustments in the color menu
+  KEY_R_UP, KEY_R_UP, KEY_R_UP, KEY_G_UP, KEY_G_UP, KEY_G_UP,
+  KEY_B_DN, KEY_B_DN, KEY_B_DN, KEY_WORD_FLIP, KEY_CLR, END_OF_SCRIPT
+};
+
+struct Scenario{
+  const char    *name;                                                         // Label used in the report
+  uint8_t        mode_key;                                                     // Key that selects the menu mode
+  uint8_t        depth_key;                                                    // Key that selects the bit depth (0xFF for none)
+  const uint8_t *script;                                                       // Keys replayed once the mode is selected
+};
+
+static const Scenario scenarios[] = {
+  { "HEX/8",   KEY_BASE_16, KEY_8_BIT,  script_number },
+  { "HEX/16",  KEY_BASE_16, KEY_16_BIT, script_number },
+  { "HEX/32",  KEY_BASE_16, KEY_32_BIT, script_number },
+  { "HEX/64",  KEY_BASE_16, KEY_64_BIT, script_number },
+  { "OCT/8",   KEY_BASE_8,  KEY_8_BIT,  script_number },
+  { "OCT/16",  KEY_BASE_8,  KEY_16_BIT, script_number },
+  { "OCT/32",  KEY_BASE_8,  KEY_32_BIT, script_number },
+  { "OCT/64",  KEY_BASE_8,  KEY_64_BIT, script_number },
+  { "DEC/8",   KEY_BASE_10, KEY_8_BIT,  script_number },
+  { "DEC/16",  KEY_BASE_10, KEY_16_BIT, script_number },
+  { "DEC/32",  KEY_BASE_10, KEY_32_BIT, script_number },
+  { "DEC/64",  KEY_BASE_10, KEY_64_BIT, script_number },
+  { "RGB/565", KEY_RGB_565, 0xFF,       script_color  },
+  { "RGB/888", KEY_RGB_888, 0xFF,       script_color  },
+  { "HEX/128", KEY_BASE_16, KEY_128_BIT, script_number },
+  { "DEC/128", KEY_BASE_10, KEY_128_BIT, script_number },
+};
+#define NUM_SCENARIOS (sizeof(scenarios) / sizeof(scenarios[0]))
+
+/*******************************************
+* Frame Measurement                        *
+*******************************************/
+struct FrameCost{
+  uint32_t words;                                                              // Pixel words pushed
+  uint32_t bytes;                                                              // Bytes on the wire
+  uint32_t windows;                                                            // Address windows opened
+  uint64_t ns;                                                                 // Host time
+};
+
+static bool verbose = false;
+
+static FrameCost pressKey( uint8_t key ){                                      // Injects one key code and measures the render loop() runs for it
+  FrameCost cost;
+  mock_panel_reset_stats();
+  hw.last_pressed_key = key;
+  uint64_t start = mock_host_ns();
+  manageKeyPress();
+  loop();
+  cost.ns      = mock_host_ns() - start;
+  mock_panel_flush();
+  cost.words   = mock_panel.spi_words;
+  cost.bytes   = mock_panel.spi_bytes;
+  cost.windows = mock_panel.addr_windows;
+  return cost;
+}
+
+struct Totals{
+  uint32_t frames;
+  uint64_t words, bytes, windows, ns;
+  uint32_t max_words;
+  uint64_t max_ns;
+
+  void add( const FrameCost &c ){
+    frames++; words += c.words; bytes += c.bytes; windows += c.windows; ns += c.ns;
+    if( c.words > max_words ) max_words = c.words;
+    if( c.ns > max_ns ) max_ns = c.ns;
+  }
+};
+
+static void leaveMode( const Scenario &s ){                                    // Puts the calculator in a different mode so selecting s is a real mode switch
+  if( s.mode_key == KEY_RGB_888 ){ pressKey( KEY_BASE_10 ); pressKey( KEY_64_BIT ); }
+  else pressKey( KEY_RGB_888 );
+}
+
+/*******************************************
+* Decimal Conversion Comparison            *
+*******************************************/
+// Rough cost of the libgcc helpers on the AVR, used to turn the call counts into an estimate. Measure
+// them on the target (or its simulator) and override with -D to tighten the numbers up.
+#ifndef AVR_CYCLES_DIV64
+#define AVR_CYCLES_DIV64 2800                                                  // __udivmoddi4: 64 shift/subtract steps over 8 byte operands
+#endif
+#ifndef AVR_CYCLES_DIV32
+#define AVR_CYCLES_DIV32 650                                                   // __udivmodsi4: 32 shift/subtract steps over 4 byte operands
+#endif
+#ifndef AVR_CYCLES_MUL16
+#define AVR_CYCLES_MUL16 20                                                    // __umulhisi3: four hardware 8x8 multiplies
+#endif
+
+static uint8_t formatDecimalLoop( uint64_t val, char *buffer ){                // The conversion loop drawSmallNumber/drawLargeNumber used before format.h
+  uint8_t  num_digits = 0;
+  uint64_t tmp = val;
+  for( int8_t i = 26; i >= 0; i-- ){
+    if( tmp > 0 ){
+      if( i % 4 == 3 ){
+        buffer[i] = ',';
+      } else {
+        buffer[i] = 0x30 + (tmp % 10);
+        tmp /= 10;
+      }
+      num_digits++;
+    } else {
+      buffer[i] = 0x30;
+    }
+  }
+  if( num_digits == 0 ) num_digits = 1;
+  return num_digits;
+}
+
+static bool sameDecimal( uint64_t v ){                                         // True if both converters produce the same characters for v
+  char a[27];
+  NumberText b;
+  uint8_t na = formatDecimalLoop( v, a );
+  formatDecimal( v, b );
+  if( na == b.length && !memcmp( a + 27 - na, b.str(), na ) ) return true;
+  printf( "mismatch at %llu: %.*s vs %.*s\n", (unsigned long long)v, na, a + 27 - na, b.length, b.str() );
+  return false;
+}
+
+static int formatComparison( uint32_t reps ){                                  // Checks formatDecimal() against the loop and times both
+  const uint32_t count = 4096;
+  static uint64_t values[count];
+  uint64_t seed = 0x9E3779B97F4A7C15ull;
+  for( uint32_t i = 0; i < count; i++ ){                                       // Full-width values (top bit set) so the loop runs all 20 digits
+    seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+    values[i] = seed | 0x8000000000000000ull;
+  }
+  const uint64_t edges[] = { 0, 1, 9, 10, 999, 1000, 9999, 10000, 65535, 65536, 99999999, 0xFFFFFFFFull,
+                             0x100000000ull, 10000000000000000000ull, 0xFFFFFFFFFFFFFFFFull };
+  uint32_t mismatches = 0, checked = 0;
+  uint64_t p10 = 1;
+  for( int i = 0; i < 20; i++, p10 *= 10 ){                                    // Every power of ten and its neighbours
+    mismatches += !sameDecimal( p10 - 1 ) + !sameDecimal( p10 ) + !sameDecimal( p10 + 1 );
+    checked += 3;
+  }
+  for( uint64_t v : edges ){ mismatches += !sameDecimal( v ); checked++; }
+  for( uint32_t i = 0; i < count; i++ ){ mismatches += !sameDecimal( values[i] ); checked++; }
+
+  volatile uint32_t sink = 0;                                                  // Keeps the optimizer from dropping the conversions
+  char buf[27];
+  NumberText text;
+  uint64_t start = mock_host_ns();
+  for( uint32_t r = 0; r < reps; r++ ) for( uint32_t i = 0; i < count; i++ ) sink = sink + formatDecimalLoop( values[i], buf ) + buf[26];
+  uint64_t loop_ns = mock_host_ns() - start;
+  start = mock_host_ns();
+  for( uint32_t r = 0; r < reps; r++ ) for( uint32_t i = 0; i < count; i++ ) { formatDecimal( values[i], text ); sink = sink + text.length + text.chars[26]; }
+  uint64_t fast_ns = mock_host_ns() - start;
+
+  uint64_t loop_divs = 0, fast_divs = 0, fast_muls = 0;                       // Library calls each converter makes over the value set
+  for( uint32_t i = 0; i < count; i++ ){
+    char a[27];
+    uint8_t chars = formatDecimalLoop( values[i], a );
+    uint8_t digits = chars - (chars - 1) / 4;                                  // Take the commas back out
+    loop_divs += 2 * digits;                                                   // One % 10 and one / 10 per digit
+    for( uint64_t v = values[i]; v; v /= 10000 ){
+      for( uint64_t w = v; w; w >>= 16 ) fast_divs++;                          // One 32/16 division per non-zero word per pass
+      fast_muls += 4;
+    }
+  }
+
+  double n = double(reps) * count;
+  printf( "checked %u values, %u mismatches\n", checked, mismatches );
+  printf( "%-16s %10s %12s %12s %12s %14s\n", "converter", "host ns", "64b div", "32b div", "16x16 mul", "est. AVR cyc" );
+  printf( "%-16s %10.1f %12.1f %12.1f %12.1f %14.0f\n", "% 10, / 10 loop", loop_ns / n, loop_divs / double(count), 0.0, 0.0,
+          loop_divs * double(AVR_CYCLES_DIV64) / count );
+  printf( "%-16s %10.1f %12.1f %12.1f %12.1f %14.0f\n", "formatDecimal", fast_ns / n, 0.0, fast_divs / double(count), fast_muls / double(count),
+          (fast_divs * double(AVR_CYCLES_DIV32) + fast_muls * double(AVR_CYCLES_MUL16)) / count );
+  printf( "(host ns is only a sanity check: x86 divides by a constant with a multiply, the AVR calls into libgcc)\n" );
+  return mismatches ? 1 : 0;
+}
+
+/*******************************************
+* Keypad Test                              *
+*******************************************/
+// The keypad test works on the virtual clock. Each press is a timeline of switch changes: the
+// contacts chatter for KEYPAD_BOUNCE_US on the way down and again on the way up. The switches are
+// flipped from a clock hook, so they change on time wherever the firmware happens to be, including
+// in the middle of a frame. loop() runs back to back, an idle pass taking KEYPAD_LOOP_US. In the
+// "spi" runs every byte sent to the screen also takes its time on the SPI at KEYPAD_SPI_HZ, so a
+// frame takes as long as it would on the real thing and keys arrive while it is being drawn.
+#ifndef KEYPAD_BOUNCE_US
+#define KEYPAD_BOUNCE_US 1500                                                  // Contact chatter after each edge
+#endif
+#ifndef KEYPAD_LOOP_US
+#define KEYPAD_LOOP_US 100                                                     // Time an idle pass of loop() takes
+#endif
+#ifndef KEYPAD_SPI_HZ
+#define KEYPAD_SPI_HZ 12000000                                                 // SPI clock of the spi runs (F_CPU / 2, the fastest the AVR can go)
+#endif
+#define KEYPAD_PRESSES 400                                                     // Presses per run
+#define KEYPAD_MAX_EVENTS (KEYPAD_PRESSES * 48)
+
+struct SwitchEvent{ uint64_t at_us; uint8_t button; bool down; };
+
+static SwitchEvent keypad_events[KEYPAD_MAX_EVENTS];
+static uint32_t keypad_event_count, keypad_next_event;
+static uint64_t keypad_now_us;                                                 // Virtual time since the test started
+static uint8_t  keypad_expected[KEYPAD_PRESSES];                               // Key codes in the order they were pressed
+static uint64_t keypad_pressed_us[KEYPAD_PRESSES];                             // When each of those presses first closed its switch
+static uint32_t keypad_received, keypad_wrong;
+static uint64_t keypad_latency_sum, keypad_latency_max;
+static uint32_t keypad_frames, keypad_aborted;                                 // Frames started, and how many of those newer input cut short
+static uint32_t keypad_stale;                                                  // Finished frames that left the screen different from a from-scratch render
+static uint32_t keypad_spi_hz;
+
+static uint32_t keypad_rand_state = 1;
+static uint32_t keypadRand( uint32_t range ){ keypad_rand_state = keypad_rand_state * 1103515245 + 12345; return (keypad_rand_state >> 8) % range; }
+
+static void addSwitch( uint64_t &t, uint8_t button, bool down ){               // One edge plus its chatter
+  keypad_events[keypad_event_count++] = { t, button, down };
+  uint64_t end = t + KEYPAD_BOUNCE_US;
+  for( uint64_t b = t + 50 + keypadRand( 300 ); b + 100 < end; b += 100 + keypadRand( 400 ) ){
+    keypad_events[keypad_event_count++] = { b, button, !down };
+    keypad_events[keypad_event_count++] = { b + 30 + keypadRand( 60 ), button, down };
+  }
+  t = end;
+}
+
+static void buildKeyTimeline( uint32_t seed ){                                 // Rollover typing: a press every 20 to 120 ms, each held for 10 to 80 ms
+  keypad_rand_state = seed;
+  keypad_event_count = 0;
+  uint64_t t = keypad_now_us + 1000;
+  uint64_t released = t;                                                       // When the last key held so far lets go
+  uint8_t recent[5] = { KEY_ALT, KEY_ALT, KEY_ALT, KEY_ALT, KEY_ALT };         // Buttons that may still be down (or debouncing their release)
+  for( uint32_t i = 0; i < KEYPAD_PRESSES; i++ ){
+    uint8_t button;
+    do button = keypadRand( 35 ); while( button == KEY_ALT || memchr( recent, button, sizeof(recent) ) );
+    memmove( recent + 1, recent, sizeof(recent) - 1 );
+    recent[0] = button;
+
+    bool alt = keypadRand( 4 ) == 0;                                           // ALT chords happen on their own, so which keys get ALT is unambiguous
+    if( alt ){
+      t = released + 15000;
+      addSwitch( t, KEY_ALT, true );
+      t += 5000 + keypadRand( 20000 );
+    }
+    keypad_expected[i]   = button_map[button] + (alt ? 35 : 0);
+    keypad_pressed_us[i] = t;
+    uint64_t up = t;
+    addSwitch( up, button, true );
+    up += 10000 + keypadRand( 70000 );
+    addSwitch( up, button, false );
+    if( up > released ) released = up;
+    if( alt ){
+      t = up + keypadRand( 5000 );
+      addSwitch( t, KEY_ALT, false );
+      released = t;
+      t += 15000;
+    } else {
+      t += 20000 + keypadRand( 100000 );
+    }
+  }
+  std::sort( keypad_events, keypad_events + keypad_event_count, []( const SwitchEvent &x, const SwitchEvent &y ){ return x.at_us < y.at_us; } );
+}
+
+static void keypadClock( uint64_t now_us ){                                     // Clock hook: flips the switches that are due
+  while( keypad_next_event < keypad_event_count && keypad_events[keypad_next_event].at_us <= now_us ){
+    const SwitchEvent &e = keypad_events[keypad_next_event++];
+    if( e.down ) mock_key_down( e.button ); else mock_key_up( e.button );
+  }
+  keypad_now_us = now_us;
+}
+
+static bool screenMatchesState(){                                              // True if the screen is what a from-scratch render of the current state draws
+  mock_panel_flush();
+  uint32_t hash = mock_framebuffer_hash();
+#if HEXCALC_STATS
+  StatCounter saved[STAT_COUNT];                                               // The check's frame is not one the firmware would draw, so keep it out of the stats
+  memcpy( saved, stats, sizeof(stats) );
+#endif
+  screen.fillScreen( ST77XX_BLACK );
+  rendered_valid = false;
+  pending_widgets = 0;
+  renderScreen( false );
+  mock_panel_flush();
+#if HEXCALC_STATS
+  memcpy( stats, saved, sizeof(stats) );
+#endif
+  return hash == mock_framebuffer_hash();
+}
+
+static void keypadLoop(){                                                      // One pass of loop(), noting whether it started a frame and finished it
+  bool rendering = screen_dirty;                                               // (a key handled in this pass sets screen_dirty before the render)
+  uint32_t words = mock_panel.spi_words + mock_spi_queued;
+  loop();
+  mock_panel_flush();
+  if( mock_panel.spi_words != words || rendering ){
+    keypad_frames++;
+    if( screen_dirty ) keypad_aborted++;
+    else {                                                                     // A finished frame has to leave nothing stale behind from the aborted ones
+      mock_spi_set_rate( 0 );                                                  // (the check itself takes no time)
+      if( !screenMatchesState() ) keypad_stale++;
+      mock_spi_set_rate( keypad_spi_hz );
+    }
+  }
+  mock_clock_advance_us( KEYPAD_LOOP_US );
+}
+
+static void keypadReceived(){                                                  // Key press callback: check the key, then hand it to the firmware
+  if( keypad_received < KEYPAD_PRESSES ){
+    uint64_t latency = keypad_now_us - keypad_pressed_us[keypad_received];
+    if( (uint8_t)hw.last_pressed_key != keypad_expected[keypad_received] ){
+      keypad_wrong++;
+      if( verbose ) printf( "  press %u: expected key %u, got %u\n", keypad_received, keypad_expected[keypad_received], (uint8_t)hw.last_pressed_key );
+    }
+    keypad_latency_sum += latency;
+    if( latency > keypad_latency_max ) keypad_latency_max = latency;
+  } else {
+    keypad_wrong++;                                                            // More keys than presses: a bounce got through
+  }
+  keypad_received++;
+  manageKeyPress();
+}
+
+static bool keypadRun( const char *name, uint32_t seed, uint32_t spi_hz ){
+  buildKeyTimeline( seed );
+  keypad_next_event = 0;
+  keypad_received = keypad_wrong = 0;
+  keypad_latency_sum = keypad_latency_max = 0;
+  keypad_frames = keypad_aborted = keypad_stale = 0;
+  keypad_spi_hz = spi_hz;
+  mock_spi_set_rate( spi_hz );
+  uint64_t end = keypad_events[keypad_event_count - 1].at_us + 200000;
+  while( keypad_now_us < end ) keypadLoop();
+  mock_spi_set_rate( 0 );
+  bool screen_ok = !screen_dirty && keypad_stale == 0;
+  uint32_t got = keypad_received < KEYPAD_PRESSES ? keypad_received : KEYPAD_PRESSES;
+  printf( "%-12s %8u %8u %8u %8u %10.2f %10.2f %8u %8u %8u  %s\n", name, KEYPAD_PRESSES, keypad_received, KEYPAD_PRESSES - got, keypad_wrong,
+          got ? keypad_latency_sum / 1000.0 / got : 0.0, keypad_latency_max / 1000.0, hw.keys_dropped, keypad_frames, keypad_aborted,
+          screen_ok ? "ok" : "STALE" );
+  return got == KEYPAD_PRESSES && keypad_received == KEYPAD_PRESSES && keypad_wrong == 0 && screen_ok;
+}
+
+static uint32_t repeat_count, repeat_long_presses, repeat_releases;
+static uint64_t repeat_last_us, repeat_first_gap, repeat_min_gap;
+
+static void keypadRepeatEvent(){                                               // Key event callback for keypadRepeat()
+  if( hw.last_key_event == KEY_EVENT_RELEASE ) repeat_releases++;
+  if( hw.last_key_event == KEY_EVENT_LONG_PRESS ) repeat_long_presses++;
+  if( hw.last_key_event != KEY_EVENT_PRESS && hw.last_key_event != KEY_EVENT_REPEAT ) return;
+  if( hw.last_key_event == KEY_EVENT_REPEAT ){
+    uint64_t gap = keypad_now_us - repeat_last_us;
+    if( repeat_count == 0 ) repeat_first_gap = gap;
+    if( repeat_count == 0 || gap < repeat_min_gap ) repeat_min_gap = gap;
+    repeat_count++;
+  }
+  repeat_last_us = keypad_now_us;
+}
+
+static bool keypadRepeat( uint8_t button, uint32_t hold_ms ){                  // Holds one key down and reports how it repeats
+  keypad_spi_hz = 0;
+  hw.onKeyEvent( keypadRepeatEvent );
+  hw.onKeyPress( NULL );
+  repeat_count = repeat_long_presses = repeat_releases = 0;
+  keypad_event_count = keypad_next_event = 0;
+  uint64_t t = keypad_now_us + 1000;
+  addSwitch( t, button, true );
+  t += (uint64_t)hold_ms * 1000;
+  addSwitch( t, button, false );
+  while( keypad_now_us < t + 100000 ) keypadLoop();
+  hw.onKeyEvent( NULL );
+  hw.onKeyPress( keypadReceived );
+  uint8_t key = button_map[button];
+  if( repeat_count ) printf( "held key %-3u %5u ms: %3u repeats, first after %.0f ms, fastest every %.0f ms, %u long press, %u release\n", key, hold_ms,
+                             repeat_count, repeat_first_gap / 1000.0, repeat_min_gap / 1000.0, repeat_long_presses, repeat_releases );
+  else              printf( "held key %-3u %5u ms: no repeats, %u long press, %u release\n", key, hold_ms, repeat_long_presses, repeat_releases );
+  bool repeats = Hardware::keyRepeats( key );
+  return (repeats ? repeat_count > 0 : repeat_count == 0) && repeat_releases == 1 && repeat_long_presses == (hold_ms >= LONG_PRESS_TIME);
+}
+
+static int keypadTest( uint32_t reps ){                                        // Latency and lost keys with an idle and a busy main loop
+  setup();
+  hw.onKeyPress( keypadReceived );
+  keypad_now_us = micros();
+  mock_clock_set_hook( keypadClock );
+  printf( "%-12s %8s %8s %8s %8s %10s %10s %8s %8s %8s  %s\n", "spi", "presses", "received", "lost", "wrong", "avg ms", "max ms", "dropped", "frames", "aborted", "screen" );
+  bool ok = true;
+  for( uint32_t r = 0; r < reps && r < 4; r++ ){
+    ok &= keypadRun( "free", 11 + r, 0 );
+    ok &= keypadRun( "spi 12MHz", 101 + r, KEYPAD_SPI_HZ );
+  }
+  printf( "(latency is from the first contact to manageKeyPress(); in the spi runs it includes waiting for the widget being drawn)\n\n" );
+
+  uint8_t shift_button = 0, plus_button = 0;
+  for( uint8_t b = 0; b < 35; b++ ){
+    if( button_map[b] == KEY_LSHIFT ) shift_button = b;
+    if( button_map[b] == KEY_PLUS ) plus_button = b;
+  }
+  ok &= keypadRepeat( shift_button, 2000 );
+  ok &= keypadRepeat( plus_button, 2000 );
+  mock_clock_set_hook( NULL );
+  return ok ? 0 : 1;
+}
+
+/*******************************************
+* Stats Dump                               *
+*******************************************/
+// Runs one of the keypad test's 12MHz runs, so frames get cut short and keys wait on the SPI like
+// they would on the calculator, then sends the stats commands over the mock serial port the way
+// they would come in from a terminal. The stack numbers are the host's (x86 frames are bigger than the
+// AVR's), so they only show that the painting and probes work and which draws are the deepest.
+#define STATS_PORT 2                                                           // STATS_SERIAL is Serial2
+
+#if HEXCALC_STATS
+
+static char stats_output[MOCK_SERIAL_BUFFER];
+
+static const char *serialCommand( const char *command ){                        // Sends a command line and returns what the firmware wrote back
+  mock_serial_input( STATS_PORT, command );
+  loop();
+  mock_serial_output( STATS_PORT, stats_output, sizeof(stats_output) );
+  return stats_output;
+}
+
+static uint32_t statsCount( const char *csv, const char *name ){               // The count column of one counter's line (0 if it isn't there)
+  size_t len = strlen( name );
+  for( const char *line = csv; line && *line; line = strchr( line, '\n' ), line = line ? line + 1 : NULL ){
+    if( !strncmp( line, name, len ) && line[len] == ',' ) return strtoul( line + len + 1, NULL, 10 );
+  }
+  return 0;
+}
+
+static int statsTest(){
+  setup();
+  hw.onKeyPress( keypadReceived );
+  keypad_now_us = micros();
+  mock_clock_set_hook( keypadClock );
+  printf( "%-12s %8s %8s %8s %8s %10s %10s %8s %8s %8s  %s\n", "spi", "presses", "received", "lost", "wrong", "avg ms", "max ms", "dropped", "frames", "aborted", "screen" );
+  bool ok = keypadRun( "spi 12MHz", 101, KEYPAD_SPI_HZ );
+  mock_clock_set_hook( NULL );
+
+  printf( "\n%s", serialCommand( "stats\r\n" ) );
+  for( uint8_t n = 0; n < STAT_COUNT; n++ ){                                   // Every counter should have seen something in a run like that
+    if( statsCount( stats_output, stat_names[n] ) ) continue;
+    printf( "%s: nothing recorded\n", stat_names[n] );
+    ok = false;
+  }
+  uint32_t latencies = statsCount( stats_output, "key_latency" );
+  if( latencies > keypad_received ){
+    printf( "key_latency: %u recorded for %u keys\n", latencies, keypad_received );
+    ok = false;
+  }
+
+  printf( "\n%s", serialCommand( "mem\n" ) );
+  const char *used[] = { "static", "heap", "stack_peak", "stack_free", "drawTagWidget", "drawLargeNumberWidget", "drawSmallNumberWidget", "fillBox" };
+  for( const char *name : used ){                                              // There is static data and heap, the stack has been somewhere, and so has every widget drawn in every frame
+    if( statsCount( stats_output, name ) ) continue;
+    printf( "%s: no stack use recorded\n", name );
+    ok = false;
+  }
+  if( statsCount( stats_output, "stack_peak" ) < statsCount( stats_output, "drawLargeNumberWidget" ) ){
+    printf( "stack_peak is below the peak of a single draw\n" );
+    ok = false;
+  }
+
+  serialCommand( "reset\nstats\n" );
+  for( uint8_t n = 0; n < STAT_COUNT; n++ ){
+    if( !statsCount( stats_output, stat_names[n] ) ) continue;
+    printf( "%s: not cleared by reset\n", stat_names[n] );
+    ok = false;
+  }
+  serialCommand( "mem\n" );
+  for( uint8_t n = 0; n < MEM_PROBES; n++ ){
+    if( !mem_probe_names[n] || !statsCount( stats_output, mem_probe_names[n] ) ) continue;
+    printf( "%s: stack peak not cleared by reset\n", mem_probe_names[n] );
+    ok = false;
+  }
+  printf( "\n(times in us, memory in bytes of the host's own stack; the lt<n> columns count values below n, ge<n> the rest; reset %s)\n", ok ? "ok" : "FAILED" );
+  return ok ? 0 : 1;
+}
+#else
+static int statsTest(){
+  printf( "built with HEXCALC_STATS=0, nothing to dump\n" );
+  return 0;
+}
+#endif
+
+/*******************************************
+* Boot & Resume Test                       *
+*******************************************/
+// Each boot runs in a child process, so every firmware global starts over like it does after a
+// power cycle, while the mock EEPROM carries over from one boot to the next (the child inherits
+// it and sends it back). The panel powers up full of BOOT_NOISE and the SPI runs at 12MHz. A boot
+// is checked against the screen the old setup() drew (fill the whole screen black, then draw every
+// widget) and, after a save, against the screen the last boot left behind.
+#if HEXCALC_PERSIST
+#define BOOT_NOISE      0xF81F                                                 // Power-on contents of the mock panel (magenta, which no state below draws)
+#define BOOT_WEAR_SAVES 1000                                                   // Saves in the wear run
+
+struct BootRun{
+  const char    *name;
+  const uint8_t *keys;                                                         // Pressed after the boot, then saved (END_OF_SCRIPT terminated)
+  uint8_t        tear;                                                         // Cut the power once this many bytes of the record are written (0 lets it finish)
+  uint16_t       saves;                                                        // Or: save this many single digit changes in a row
+};
+
+struct BootResult{
+  bool     done;                                                               // The child got all the way through
+  uint32_t boot_us, boot_words;                                                // Virtual time from reset to the end of setup(), and the pixel words it sent
+  uint32_t noise;                                                              // Pixels still showing BOOT_NOISE after setup()
+  uint32_t boot_hash;                                                          // Screen after setup()
+  uint32_t old_us, old_words, old_hash;                                        // The same for the old first frame (10ms, fillScreen, every widget)
+  uint32_t end_hash;                                                           // Screen after the keys
+  uint32_t saves, idle_ms;                                                     // Saves made, and the time from the last key until each was written (summed)
+  uint8_t  eeprom[EEPROM_SIZE];
+  uint32_t writes[EEPROM_SIZE];
+};
+
+static uint32_t bootIdle(){                                                    // Runs loop() until the state is saved, returns how long that took (0 if it never was)
+  for( uint32_t ms = 5; ms < 60000; ms += 5 ){
+    delay( 5 );
+    loop();
+    if( !state_unsaved && !persistWriting() ) return ms;
+  }
+  return 0;
+}
+
+static void bootChild( const BootRun &run, BootResult &r ){                   // One power cycle
+  mock_panel_set_power_on_fill( BOOT_NOISE );
+  mock_spi_set_rate( KEYPAD_SPI_HZ );
+  setup();
+  r.boot_us    = micros();
+  r.boot_words = (mock_panel_flush(), mock_panel.spi_words);
+  r.boot_hash  = mock_framebuffer_hash();
+  for( uint32_t i = 0; i < MOCK_PANEL_WIDTH * MOCK_PANEL_HEIGHT; i++ ) r.noise += mock_framebuffer[i] == BOOT_NOISE;
+
+  uint32_t start = micros();                                                   // The old way of drawing the first frame
+  mock_panel_reset_stats();
+  screen.fillScreen( ST77XX_BLACK );
+  RenderState cur = captureState();
+  WidgetRect  rect;
+  digitalWrite( PIN_SCREEN_DC, HIGH );
+  SPI.beginTransaction( SPISettings( 20000000, MSBFIRST, SPI_MODE2 ) );
+  for( uint8_t n = 0; n < NUM_WIDGETS; n++ ){
+    for( uint8_t i = 0; i < widgets[n].count; i++ ) if( widgets[n].place( cur, i, rect ) ) widgets[n].draw( cur, i );
+  }
+  SPI.endTransaction();
+  mock_panel_flush();
+  r.old_us    = 10000 + micros() - start;                                      // (it waited the whole 10ms first)
+  r.old_words = mock_panel.spi_words;
+  r.old_hash  = mock_framebuffer_hash();
+
+  for( const uint8_t *k = run.keys; k && *k != END_OF_SCRIPT; k++ ){ applyKey( *k ); loop(); }
+  r.end_hash = mock_framebuffer_hash();
+  if( run.tear ){                                                              // Pull the plug part way through the save
+    for( uint32_t ms = 0; ms < 60000 && (!persistWriting() || persist_written < run.tear); ms++ ){ delay( 1 ); loop(); }
+    r.done = persistWriting();
+  } else if( run.saves ){
+    r.done = true;
+    for( uint16_t n = 0; n < run.saves; n++ ){
+      applyKey( KEY_0 + n % 10 );
+      loop();
+      uint32_t ms = bootIdle();
+      if( !ms ) r.done = false;
+      r.saves++;
+      r.idle_ms += ms;
+    }
+    r.end_hash = mock_framebuffer_hash();
+  } else {
+    r.idle_ms = bootIdle();
+    r.saves   = r.idle_ms != 0;
+    r.done    = r.saves || !run.keys;
+  }
+  memcpy( r.eeprom, mock_eeprom, EEPROM_SIZE );
+  memcpy( r.writes, mock_eeprom_writes, sizeof(r.writes) );
+}
+
+static bool bootRun( const BootRun &run, BootResult &r ){                      // Boots in a child process and takes its EEPROM back
+  int fds[2];
+  if( pipe( fds ) ) return false;
+  fflush( stdout );
+  pid_t pid = fork();
+  if( pid < 0 ) return false;
+  if( pid == 0 ){
+    close( fds[0] );
+    BootResult *child = new BootResult();
+    bootChild( run, *child );
+    const uint8_t *p = (const uint8_t *)child;
+    for( size_t sent = 0; sent < sizeof(BootResult); ){
+      ssize_t n = write( fds[1], p + sent, sizeof(BootResult) - sent );
+      if( n <= 0 ) _exit( 1 );
+      sent += n;
+    }
+    _exit( 0 );
+  }
+  close( fds[1] );
+  size_t got = 0;
+  for( ssize_t n; got < sizeof(BootResult) && (n = read( fds[0], (uint8_t *)&r + got, sizeof(BootResult) - got )) > 0; ) got += n;
+  close( fds[0] );
+  int status;
+  waitpid( pid, &status, 0 );
+  if( got != sizeof(BootResult) || !r.done ) return false;
+  memcpy( mock_eeprom, r.eeprom, EEPROM_SIZE );
+  memcpy( mock_eeprom_writes, r.writes, sizeof(r.writes) );
+  return true;
+}
+
+static const uint8_t boot_keys_dec[] = {                                       // A sum in progress in decimal
+  KEY_BASE_10, KEY_1, KEY_2, KEY_3, KEY_4, KEY_PLUS, KEY_5, KEY_6, END_OF_SCRIPT
+};
+static const uint8_t boot_keys_wide[] = {                                      // An 80-bit value in extended precision, mid-XOR
+  KEY_128_BIT, KEY_BASE_16, KEY_F, KEY_E, KEY_D, KEY_C, KEY_B, KEY_A, KEY_9, KEY_8, KEY_7, KEY_6,
+  KEY_5, KEY_4, KEY_3, KEY_2, KEY_1, KEY_0, KEY_F, KEY_E, KEY_D, KEY_C, KEY_XOR, KEY_A, END_OF_SCRIPT
+};
+static const uint8_t boot_keys_color[] = {                                     // The color menu in 888 mode
+  KEY_ALL_CLEAR, KEY_64_BIT, KEY_RGB_888, KEY_R_UP, KEY_G_UP, KEY_G_UP, END_OF_SCRIPT
+};
+
+static int bootTest(){
+  const BootRun runs[] = {
+    { "cold",    boot_keys_dec,   0,  0 },                                     // Erased EEPROM: the default state
+    { "decimal", boot_keys_wide,  0,  0 },                                     // Back in the decimal sum
+    { "wide",    boot_keys_color, 20, 0 },                                     // Back in extended precision, then the power goes mid-save
+    { "torn",    boot_keys_color, 0,  0 },                                     // The torn record is skipped: extended precision again
+    { "color",   NULL,            0,  BOOT_WEAR_SAVES },                       // Back in the color menu, then the wear run
+    { "wear",    NULL,            0,  0 },                                     // The last of the wear run's saves
+  };
+  bool     ok = true;
+  uint32_t expect = 0;                                                         // Screen the next boot should come back to (0: the first boot has nothing to match)
+  BootResult *r = new BootResult();
+  mock_eeprom_erase();
+  printf( "%-8s %9s %9s %9s %9s %7s  %s\n", "boot", "ms", "words", "old ms", "old words", "noise", "screen" );
+  for( const BootRun &run : runs ){
+    memset( r, 0, sizeof(BootResult) );
+    if( !bootRun( run, *r ) ){
+      printf( "%-8s the child did not finish\n", run.name );
+      ok = false;
+      break;
+    }
+    bool matches = r->noise == 0 && r->boot_hash == r->old_hash && (!expect || r->boot_hash == expect);
+    printf( "%-8s %9.2f %9u %9.2f %9u %7u  %08x %s\n", run.name, r->boot_us / 1000.0, r->boot_words,
+            r->old_us / 1000.0, r->old_words, r->noise, r->boot_hash, matches ? "ok" : "WRONG" );
+    ok &= matches;
+    if( !run.tear ) expect = r->end_hash;                                      // A torn save leaves the boot before it in place
+  }
+
+  uint32_t most = 0, total = 0;
+  for( uint16_t i = 0; i < EEPROM_SIZE; i++ ){ total += mock_eeprom_writes[i]; if( mock_eeprom_writes[i] > most ) most = mock_eeprom_writes[i]; }
+  uint32_t limit = (BOOT_WEAR_SAVES + 3) / PERSIST_SLOTS + 2;                  // Every save is one slot along (plus the three saves before the wear run)
+  printf( "\n%u saves of a %u byte record in %u slots: %u byte writes, at most %u to one byte (limit %u, %u without the ring)\n",
+          BOOT_WEAR_SAVES + 3, (unsigned)sizeof(PersistRecord), (unsigned)PERSIST_SLOTS, total, most, limit, BOOT_WEAR_SAVES + 3 );
+  ok &= most <= limit;
+  delete r;
+  printf( "(ms of the virtual clock at 12MHz SPI; the boot is %s)\n", ok ? "ok" : "FAILED" );
+  return ok ? 0 : 1;
+}
+#else
+static int bootTest(){
+  printf( "built with HEXCALC_PERSIST=0, nothing to resume\n" );
+  return 0;
+}
+#endif
+
+/*******************************************
+* Calculator Kernel Benchmark              *
+*******************************************/
+// Runs every Calculator kernel in every bit depth over a set of operands, checks it against the
+// plain "do it in 64 bits, then mask" version the Calculator used before the kernels, and times
+// both. The host does a 64-bit multiply as fast as an 8-bit one, so the host time can't show what
+// the narrower words save. The cycle columns estimate that for the AVR instead: library routines
+// for multiply and divide (see AVR_CYCLES_DIV64 above), a few cycles per byte for the simple
+// operations, and a pass over every byte per bit for variable shifts.
+#ifndef AVR_CYCLES_DIV8
+#define AVR_CYCLES_DIV8 70                                                     // __udivmodqi4: 8 shift/subtract steps
+#endif
+#ifndef AVR_CYCLES_DIV16
+#define AVR_CYCLES_DIV16 210                                                   // __udivmodhi4: 16 shift/subtract steps over 2 byte operands
+#endif
+#ifndef AVR_CYCLES_MUL8
+#define AVR_CYCLES_MUL8 2                                                      // One hardware 8x8 multiply
+#endif
+#ifndef AVR_CYCLES_MUL32
+#define AVR_CYCLES_MUL32 60                                                    // __mulsi3: the low half of ten 8x8 multiplies
+#endif
+#ifndef AVR_CYCLES_MUL64
+#define AVR_CYCLES_MUL64 320                                                   // __muldi3: the low half of 36 8x8 multiplies
+#endif
+#define AVR_CYCLES_BYTE 3                                                      // Load, operate on and store one byte of a simple operation
+#define AVR_CYCLES_SHIFT_BYTE 1                                                // One byte of a one-bit shift (shift / rotate through carry)
+#define AVR_CYCLES_SHIFT_LOOP 3                                                // Loop overhead per bit of a variable shift
+
+#define OPS_ONE_STEP 0x80                                                      // Flags an entry of ops_table as a one-step operation
+
+struct OpEntry{ const char *name; uint8_t op; };                              // op: OP_* or OPS_ONE_STEP | index into the one-step kernels
+
+static const OpEntry ops_table[] = {
+  { "plus", OP_PLUS }, { "minus", OP_MINUS }, { "multiply", OP_MULTIPLY }, { "divide", OP_DIVIDE }, { "mod", OP_MOD },
+  { "rol by", OP_ROL }, { "ror by", OP_ROR }, { "lshift by", OP_LEFT_SHIFT }, { "rshift by", OP_RIGHT_SHIFT },
+  { "and", OP_AND }, { "or", OP_OR }, { "nor", OP_NOR }, { "xor", OP_XOR },
+  { "lshift", OPS_ONE_STEP | 0 }, { "rshift", OPS_ONE_STEP | 1 }, { "rol", OPS_ONE_STEP | 2 }, { "ror", OPS_ONE_STEP | 3 },
+  { "1s comp", OPS_ONE_STEP | 4 }, { "2s comp", OPS_ONE_STEP | 5 }, { "byte flip", OPS_ONE_STEP | 6 }, { "word flip", OPS_ONE_STEP | 7 },
+};
+#define NUM_OPS (sizeof(ops_table) / sizeof(ops_table[0]))
+
+static UnaryKernel oneStepKernel( const CalcKernels &k, uint8_t index ){
+  const UnaryKernel kernels[] = { k.leftShift, k.rightShift, k.rol, k.ror, k.onesCompliment, k.twosCompliment, k.byteFlip, k.wordFlip };
+  return kernels[index];
+}
+
+static uint64_t maskedOp( uint8_t op, uint64_t l, uint64_t r, uint8_t bits ){ // The operation done on 64 bits and masked to the bit depth
+  uint64_t mask = ~0ull >> (64 - bits);
+  uint64_t raw = l;                                                            // The flips leave values they can't flip as they are
+  l &= mask; r &= mask;
+  switch( op ){
+    case OP_PLUS:        return (l + r) & mask;
+    case OP_MINUS:       return (l - r) & mask;
+    case OP_MULTIPLY:    return (l * r) & mask;
+    case OP_DIVIDE:      return r ? l / r : mask;                              // Dividing by zero gives all ones
+    case OP_MOD:         return r ? l % r : l;                                 // and leaves the dividend as the remainder
+    case OP_ROL:         r %= bits; return r ? ((l << r) | (l >> (bits - r))) & mask : l;
+    case OP_ROR:         r %= bits; return r ? ((l >> r) | (l << (bits - r))) & mask : l;
+    case OP_LEFT_SHIFT:  return r >= bits ? 0 : (l << r) & mask;
+    case OP_RIGHT_SHIFT: return r >= bits ? 0 : l >> r;
+    case OP_AND:         return l & r;
+    case OP_OR:          return l | r;
+    case OP_NOR:         return ~(l | r) & mask;
+    case OP_XOR:         return l ^ r;
+    case OPS_ONE_STEP | 0: return (l << 1) & mask;
+    case OPS_ONE_STEP | 1: return l >> 1;
+    case OPS_ONE_STEP | 2: return ((l << 1) | (l >> (bits - 1))) & mask;
+    case OPS_ONE_STEP | 3: return ((l >> 1) | (l << (bits - 1))) & mask;
+    case OPS_ONE_STEP | 4: return ~l & mask;
+    case OPS_ONE_STEP | 5: return (~l + 1) & mask;
+    case OPS_ONE_STEP | 6: return bits == 8 ? raw : __builtin_bswap64( l ) >> (64 - bits);
+    case OPS_ONE_STEP | 7:
+      if( bits <= 16 ) return raw;
+      if( bits == 24 ) return ((l >> 16) | (l << 8)) & mask;
+      if( bits == 32 ) return ((l >> 16) | (l << 16)) & mask;
+      return (l >> 48) | ((l >> 16) & 0xFFFF0000ull) | ((l << 16) & 0xFFFF00000000ull) | (l << 48);
+  }
+  return 0;
+}
+
+static const uint32_t avr_div_cycles[] = { 0, AVR_CYCLES_DIV8, AVR_CYCLES_DIV16, 0, AVR_CYCLES_DIV32, 0, 0, 0, AVR_CYCLES_DIV64 }; // By operand bytes
+
+static uint32_t divideCycles( uint8_t op, uint8_t bytes, uint64_t l, uint64_t r ){ // Estimated AVR cycles of divideAdaptive()
+  if( r == 0 || l < r ) return bytes * AVR_CYCLES_BYTE;
+  if( (r & (r - 1)) == 0 ){
+    if( op == OP_MOD ) return bytes * AVR_CYCLES_BYTE;
+    return __builtin_ctzll( r ) * (bytes * AVR_CYCLES_SHIFT_BYTE + AVR_CYCLES_SHIFT_LOOP);
+  }
+  uint64_t both = l | r;
+  return avr_div_cycles[ both >> 32 ? 8 : both >> 16 ? 4 : both >> 8 ? 2 : 1 ];
+}
+
+static uint32_t avrCycles( uint8_t op, uint8_t bytes, uint8_t bits, uint64_t l, uint64_t r, bool kernel ){ // Estimated AVR cycles of op on words of the given size
+  const uint32_t mul[] = { 0, AVR_CYCLES_MUL8, AVR_CYCLES_MUL16, 0, AVR_CYCLES_MUL32, 0, 0, 0, AVR_CYCLES_MUL64 };
+  uint32_t shift_bit = bytes * AVR_CYCLES_SHIFT_BYTE + AVR_CYCLES_SHIFT_LOOP;
+  uint64_t n = r & (~0ull >> (64 - bits));
+  switch( op ){
+    case OP_MULTIPLY:    return mul[bytes];
+    case OP_DIVIDE:
+    case OP_MOD:         return kernel ? divideCycles( op, bytes, l & (~0ull >> (64 - bits)), n ) : avr_div_cycles[bytes];
+    case OP_ROL:
+    case OP_ROR:         return (n % bits ? bits : 0) * shift_bit;            // Two variable shifts that add up to the whole word
+    case OP_LEFT_SHIFT:
+    case OP_RIGHT_SHIFT: return (n < bits ? n : 0) * shift_bit;
+    case OPS_ONE_STEP | 0:
+    case OPS_ONE_STEP | 1: return shift_bit;
+    case OPS_ONE_STEP | 2:
+    case OPS_ONE_STEP | 3: return 2 * shift_bit;
+    case OPS_ONE_STEP | 6:
+    case OPS_ONE_STEP | 7: return bytes * 2;                                   // Byte moves
+  }
+  return bytes * AVR_CYCLES_BYTE;
+}
+
+struct OpCost{ uint32_t checked, mismatches; double masked_ns, kernel_ns, masked_cycles, kernel_cycles; };
+
+static OpCost measureOp( const OpEntry &e, const CalcKernels &k, uint8_t bits, uint8_t bytes, const uint64_t *l, const uint64_t *r,
+                         uint32_t count, uint32_t reps ){
+  OpCost c = {};
+  bool one_step = e.op & OPS_ONE_STEP;
+  UnaryKernel  unary  = one_step ? oneStepKernel( k, e.op & ~OPS_ONE_STEP ) : NULL;
+  BinaryKernel binary = one_step ? NULL : k.binary[e.op];
+  for( uint32_t i = 0; i < count; i++ ){
+    uint64_t got  = one_step ? unary( l[i] ) : binary( l[i], r[i] );
+    uint64_t want = maskedOp( e.op, l[i], r[i], bits );
+    c.checked++;
+    if( got != want ){
+      if( c.mismatches++ < 4 ) printf( "mismatch: %u-bit %s %llx, %llx gave %llx, expected %llx\n", bits, e.name,
+                                       (unsigned long long)l[i], (unsigned long long)r[i], (unsigned long long)got, (unsigned long long)want );
+    }
+    c.masked_cycles += avrCycles( e.op, 8, bits, l[i], r[i], false ) + (bits < 64 ? 8 : 0); // The masked version works on all 8 bytes, then masks them
+    c.kernel_cycles += avrCycles( e.op, bytes, bits, l[i], r[i], true );
+  }
+  c.masked_cycles /= count;
+  c.kernel_cycles /= count;
+
+  volatile uint64_t sink = 0;                                                  // Keeps the optimizer from dropping the operations
+  uint64_t start = mock_host_ns();
+  for( uint32_t rep = 0; rep < reps; rep++ ) for( uint32_t i = 0; i < count; i++ ) sink = sink + maskedOp( e.op, l[i], r[i], bits );
+  c.masked_ns = (mock_host_ns() - start) / double(reps * count);
+  start = mock_host_ns();
+  for( uint32_t rep = 0; rep < reps; rep++ ) for( uint32_t i = 0; i < count; i++ ) sink = sink + (one_step ? unary( l[i] ) : binary( l[i], r[i] ));
+  c.kernel_ns = (mock_host_ns() - start) / double(reps * count);
+  return c;
+}
+
+/*******************************************
+* Extended Precision Check                 *
+*******************************************/
+// Runs every operation of the extended precision mode through the Calculator itself and compares
+// the results with the compiler's unsigned __int128. The 256-bit WideInt is checked with identities
+// instead (q * d + rem == dividend, rotates undo each other, ...). WIDE_STEPS counts the limb steps
+// each operation takes, and AVR_CYCLES_WIDE_STEP turns the worst of them into an AVR estimate that
+// has to fit in one frame.
+#ifndef AVR_CYCLES_WIDE_STEP
+#define AVR_CYCLES_WIDE_STEP 8                                                 // Load, operate, store and loop for one limb (the multiply's inner step is about this)
+#endif
+#define FRAME_CYCLES (F_CPU / 60)                                              // One frame at 60 Hz
+
+typedef unsigned __int128 u128;
+
+static u128 wideValue( const WideInt<16> &w ){ u128 v; memcpy( &v, w.b, 16 ); return v; }
+static WideInt<16> wideFrom( u128 v ){ WideInt<16> w; memcpy( w.b, &v, 16 ); return w; }
+
+static u128 wideReference( uint8_t op, u128 l, u128 r ){                       // The operation on the compiler's 128-bit integers
+  switch( op ){
+    case OP_PLUS:        return l + r;
+    case OP_MINUS:       return l - r;
+    case OP_MULTIPLY:    return l * r;
+    case OP_DIVIDE:      return r ? l / r : ~(u128)0;
+    case OP_MOD:         return r ? l % r : l;
+    case OP_ROL:         r %= 128; return r ? (l << (int)r) | (l >> (int)(128 - r)) : l;
+    case OP_ROR:         r %= 128; return r ? (l >> (int)r) | (l << (int)(128 - r)) : l;
+    case OP_LEFT_SHIFT:  return r >= 128 ? 0 : l << (int)r;
+    case OP_RIGHT_SHIFT: return r >= 128 ? 0 : l >> (int)r;
+    case OP_AND:         return l & r;
+    case OP_OR:          return l | r;
+    case OP_NOR:         return ~(l | r);
+    case OP_XOR:         return l ^ r;
+    case OPS_ONE_STEP | 0: return l << 1;
+    case OPS_ONE_STEP | 1: return l >> 1;
+    case OPS_ONE_STEP | 2: return (l << 1) | (l >> 127);
+    case OPS_ONE_STEP | 3: return (l >> 1) | (l << 127);
+    case OPS_ONE_STEP | 4: return ~l;
+    case OPS_ONE_STEP | 5: return -l;
+    case OPS_ONE_STEP | 6: return ((u128)__builtin_bswap64( (uint64_t)l ) << 64) | __builtin_bswap64( (uint64_t)(l >> 64) );
+    case OPS_ONE_STEP | 7: {
+      u128 flipped = 0;
+      for( int i = 0; i < 8; i++ ) flipped |= ((l >> (i * 16)) & 0xFFFF) << ((7 - i) * 16);
+      return flipped;
+    }
+  }
+  return 0;
+}
+
+static u128 wideRandom( uint64_t &seed, uint32_t i ){                          // Operands of every length, some with a single bit set
+  uint64_t hi, lo;
+  seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17; hi = seed;
+  seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17; lo = seed;
+  u128 v = ((u128)hi << 64) | lo;
+  if( i % 9 == 0 ) return (u128)1 << (lo % 128);
+  return v >> (i * 11 % 128);
+}
+
+static uint32_t wideCheck(){                                                   // Returns the number of failures
+  static_assert( WIDE_BITS == 128, "the reference check needs the default WIDE_BITS" );
+  Calculator c;
+  c.setBitDepthWide();
+  uint64_t seed = 0x2545F4914F6CDD1Dull;
+  uint32_t failures = 0, checked = 0;
+  uint32_t worst_cycles = 0;
+
+  printf( "\n%-10s %10s %10s\n", "128-bit op", "max steps", "max cyc" );
+  for( const OpEntry &e : ops_table ){
+    bool one_step = e.op & OPS_ONE_STEP;
+    bool shifts   = e.op == OP_ROL || e.op == OP_ROR || e.op == OP_LEFT_SHIFT || e.op == OP_RIGHT_SHIFT;
+    uint32_t max_steps = 0;
+    for( uint32_t i = 0; i < 4096; i++ ){
+      u128 l = i < 2 ? ~(u128)0 : wideRandom( seed, i );                       // Start with the full-width operands that cost the most
+      u128 r = i == 0 ? ~(u128)0 >> 1 : i == 1 ? 3 : wideRandom( seed, i );
+      if( shifts ) r = i < 3000 ? i % 140 : r;                                 // Counts around the width (and a few enormous ones)
+      if( i % 64 == 5 ) r = 0;
+      c.allClear();
+      c.wide_current = wideFrom( l );
+      wide_steps = 0;
+      if( one_step ){
+        switch( e.op & ~OPS_ONE_STEP ){
+          case 0: c.leftShift();      break;
+          case 1: c.rightShift();     break;
+          case 2: c.rol();            break;
+          case 3: c.ror();            break;
+          case 4: c.onesCompliment(); break;
+          case 5: c.twosCompliment(); break;
+          case 6: c.byteFlip();       break;
+          case 7: c.wordFlip();       break;
+        }
+      } else {
+        c.wide_stored  = wideFrom( l );
+        c.wide_current = wideFrom( r );
+        c.op_command   = e.op;
+        c.equals();
+      }
+      if( wide_steps > max_steps ) max_steps = wide_steps;
+      u128 got  = wideValue( c.wide_current );
+      u128 want = wideReference( e.op, l, r );
+      checked++;
+      if( got != want || c.val_current != (uint64_t)want ){
+        if( failures++ < 4 ) printf( "mismatch: 128-bit %s %016llx%016llx, %016llx%016llx\n", e.name,
+                                     (unsigned long long)(l >> 64), (unsigned long long)l, (unsigned long long)(r >> 64), (unsigned long long)r );
+      }
+    }
+    uint32_t cycles = max_steps * AVR_CYCLES_WIDE_STEP;
+    if( cycles > worst_cycles ) worst_cycles = cycles;
+    printf( "%-10s %10u %10u\n", e.name, max_steps, cycles );
+  }
+
+  wide_steps = 0;                                                              // Showing the top decimal page takes a division per page below it
+  c.wide_current = wideFrom( ~(u128)0 );
+  c.setBase10();
+  c.page = c.pages() - 1;
+  c.pageValue( c.wide_current );
+  printf( "%-10s %10u %10u\n", "dec page", wide_steps, wide_steps * AVR_CYCLES_WIDE_STEP );
+  if( wide_steps * AVR_CYCLES_WIDE_STEP > worst_cycles ) worst_cycles = wide_steps * AVR_CYCLES_WIDE_STEP;
+
+  typedef WideInt<32> Wide256;                                                 // The widest WIDE_BITS, checked with identities
+  uint32_t worst_256 = 0;
+  for( uint32_t i = 0; i < 2048; i++ ){
+    Wide256 l, d, q, rem, back, rot;
+    for( uint8_t j = 0; j < 32; j++ ){ l.b[j] = keypadRand( 256 ); d.b[j] = keypadRand( 256 ); }
+    if( i ){ l.shiftRight( i * 13 % 256 ); d.shiftRight( i * 29 % 256 ); }    // (the first pair is full width: the slowest division)
+    else d.b[31] = 0x7F;
+    if( d.isZero() ) d.addSmall( 1 );
+    q = l;
+    wide_steps = 0;
+    q.divide( d, rem );
+    if( wide_steps > worst_256 ) worst_256 = wide_steps;
+    back.mul( q, d );
+    back.add( rem );
+    rot = l; rot.rotateLeft( i % 300 ); rot.rotateRight( i % 300 );
+    bool ok = back.compare( l ) == 0 && rem.compare( d ) < 0 && rot.compare( l ) == 0;
+    back = l; back.add( d ); back.sub( d ); ok = ok && back.compare( l ) == 0;
+    checked++;
+    if( !ok && failures++ < 4 ) printf( "mismatch: 256-bit identities, pair %u\n", i );
+  }
+  printf( "%-10s %10u %10u\n", "256 divide", worst_256, worst_256 * AVR_CYCLES_WIDE_STEP );
+  if( worst_256 * AVR_CYCLES_WIDE_STEP > worst_cycles ) worst_cycles = worst_256 * AVR_CYCLES_WIDE_STEP;
+
+  bool fits = worst_cycles <= FRAME_CYCLES;
+  printf( "checked %u extended precision results, %u mismatches\n", checked, failures );
+  printf( "slowest: %u cycles of a %lu cycle frame (%s)\n", worst_cycles, (unsigned long)FRAME_CYCLES, fits ? "ok" : "OVER BUDGET" );
+  return failures + (fits ? 0 : 1);
+}
+
+static int opsBenchmark( uint32_t reps ){                                      // Checks and times the Calculator kernels in every bit depth
+  struct Depth{ uint8_t bits, bytes; const CalcKernels *kernels; };
+  const Depth depths[] = {
+    {  8, 1, &WidthKernels<uint8_t,   8>::table },
+    { 16, 2, &WidthKernels<uint16_t, 16>::table },
+    { 24, 4, &WidthKernels<uint32_t, 24>::table },
+    { 32, 4, &WidthKernels<uint32_t, 32>::table },
+    { 64, 8, &WidthKernels<uint64_t, 64>::table },
+  };
+  const uint32_t count = 4096;
+  static uint64_t l[count], r[count], shift[count];
+  uint64_t seed = 0x9E3779B97F4A7C15ull;
+  for( uint32_t i = 0; i < count; i++ ){                                       // Full 64-bit operands, so the kernels have to cut them down
+    seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17; l[i] = seed;
+    seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17; r[i] = seed | 1;
+    shift[i] = i % 72;                                                         // Shift and rotate counts, past the end of the widest word
+  }
+  uint32_t mismatches = 0, checked = 0;
+  printf( "%-6s %-10s %9s %9s %10s %10s\n", "depth", "op", "64b ns", "kernel ns", "64b cyc", "kernel cyc" );
+  for( const Depth &d : depths ){
+    static uint64_t dividend[count], divisor[count];
+    for( uint32_t i = 0; i < count; i++ ){                                     // Operands of every size the depth holds, with some zero
+      dividend[i] = l[i] >> (i * 7 % d.bits);                                  // and power-of-two divisors mixed in
+      switch( i % 8 ){
+        case 0:  divisor[i] = 0;                                   break;
+        case 1:  divisor[i] = 1ull << (i / 8 % d.bits);            break;
+        default: divisor[i] = (r[i] & (~0ull >> (64 - d.bits))) >> (i / 8 % d.bits); break;
+      }
+    }
+    for( const OpEntry &e : ops_table ){
+      bool shifts = e.op == OP_ROL || e.op == OP_ROR || e.op == OP_LEFT_SHIFT || e.op == OP_RIGHT_SHIFT;
+      bool divides = e.op == OP_DIVIDE || e.op == OP_MOD;
+      OpCost c = measureOp( e, *d.kernels, d.bits, d.bytes, divides ? dividend : l, shifts ? shift : divides ? divisor : r, count, reps );
+      mismatches += c.mismatches;
+      checked += c.checked;
+      printf( "%-6u %-10s %9.2f %9.2f %10.0f %10.0f\n", d.bits, e.name, c.masked_ns, c.kernel_ns, c.masked_cycles, c.kernel_cycles );
+    }
+  }
+  printf( "checked %u results, %u mismatches\n", checked, mismatches );
+  printf( "(cyc is an estimate for the AVR; the host runs every width at about the same speed)\n" );
+  uint32_t wide_failures = wideCheck();
+  return mismatches || wide_failures ? 1 : 0;
+}
+
+/*******************************************
+* Calculator Fuzz & Throughput             *
+*******************************************/
+// RefCalc is the calculator written as plainly as possible: 128-bit values, the operations from
+// maskedOp() / wideReference() and none of the kernels, shadows or limbs. calcFuzz() drives it and a
+// real Calculator through the same random presses in every bit depth, base and color mode, and
+// compares everything the display or the next press depends on after each one. calcEdges() checks
+// a table of hand-worked results, and calcThroughput() times every operation through equals() and
+// the one-step functions, so a rewrite of the state machine has a baseline to beat.
+typedef void (Calculator::*CalcAction)();
+
+static const CalcAction calc_op_setters[OP_COUNT] = {                          // Operator keys by OP_* (none for OP_NONE)
+  NULL, &Calculator::plusBy, &Calculator::minusBy, &Calculator::multiplyBy, &Calculator::divideBy, &Calculator::modBy,
+  &Calculator::rolBy, &Calculator::rorBy, &Calculator::leftShiftBy, &Calculator::rightShiftBy,
+  &Calculator::andWith, &Calculator::orWith, &Calculator::norWith, &Calculator::xorWith,
+};
+static const CalcAction calc_one_steps[8] = {                                  // In the order of OPS_ONE_STEP | n
+  &Calculator::leftShift, &Calculator::rightShift, &Calculator::rol, &Calculator::ror,
+  &Calculator::onesCompliment, &Calculator::twosCompliment, &Calculator::byteFlip, &Calculator::wordFlip,
+};
+static const CalcAction calc_depths[6] = {
+  &Calculator::setBitDepth8, &Calculator::setBitDepth16, &Calculator::setBitDepth24,
+  &Calculator::setBitDepth32, &Calculator::setBitDepth64, &Calculator::setBitDepthWide,
+};
+static const uint8_t calc_depth_bits[6] = { 8, 16, 24, 32, 64, WIDE_BITS };
+static const CalcAction calc_channels[6] = {
+  &Calculator::incRed, &Calculator::incGreen, &Calculator::incBlue, &Calculator::decRed, &Calculator::decGreen, &Calculator::decBlue,
+};
+
+struct RefCalc{
+  u128    cur = 0, sto = 0, res = 0;                                           // The values (only ever past 64 bits in the extended precision mode)
+  uint8_t op = OP_NONE, error = CALC_ERROR_NONE;
+  uint8_t bits = 16, base = 16, color = RGB_565, page = 0;
+  bool    store_flag = false, result_active = false;
+
+  bool     wide() const { return bits > 64; }
+  uint64_t mask() const { return wide() ? ~0ull : ~0ull >> (64 - bits); }
+  uint8_t  pages() const { return !wide() ? 1 : base == 10 ? 3 : 2; }
+
+  void depth( uint8_t b ){                                                     // Leaving the extended precision mode keeps the low 64 bits
+    if( wide() && b <= 64 ){ cur = (uint64_t)cur; sto = (uint64_t)sto; res = (uint64_t)res; }
+    if( b > 64 ) page = 0;
+    bits = b;
+  }
+  void setBase( uint8_t b ){ base = b; page = 0; }
+  void digit( uint8_t d ){
+    if( store_flag ){ sto = cur; cur = 0; store_flag = false; }
+    result_active = false;
+    cur = wide() ? cur * base + d : (u128)(uint64_t)((uint64_t)cur * base + d);
+  }
+  void setOp( uint8_t o ){ store_flag = true; result_active = false; op = o; }
+  void equals(){
+    u128 l = result_active ? cur : sto;
+    u128 r = result_active ? sto : cur;
+    bool divides = op == OP_DIVIDE || op == OP_MOD;
+    error = divides && (wide() ? r == 0 : ((uint64_t)r & mask()) == 0) ? CALC_ERROR_DIV_BY_ZERO : CALC_ERROR_NONE;
+    if( op != OP_NONE ) res = wide() ? wideReference( op, l, r ) : maskedOp( op, (uint64_t)l, (uint64_t)r, bits );
+    if( !result_active ) sto = cur;
+    result_active = true;
+    cur = res;
+  }
+  void oneStep( uint8_t n ){
+    cur = wide() ? wideReference( OPS_ONE_STEP | n, cur, 0 ) : maskedOp( OPS_ONE_STEP | n, (uint64_t)cur, 0, bits );
+  }
+  void clear(){ cur = 0; result_active = false; }
+  void allClear(){ cur = 0; sto = 0; result_active = false; op = OP_NONE; }
+
+  void color888(){
+    depth( 24 ); setBase( 16 );
+    if( color == RGB_565 ){
+      uint64_t v = (uint64_t)cur;
+      color = RGB_888;
+      cur = (((v >> 11) & 31) << 19) | (((v >> 5) & 63) << 10) | ((v & 31) << 3);
+    }
+  }
+  void color565(){
+    setBase( 16 );
+    if( color == RGB_888 ){
+      uint64_t v = (uint64_t)cur;
+      color = RGB_565;
+      cur = (((v >> 19) & 31) << 11) | (((v >> 10) & 63) << 5) | ((v >> 3) & 31);
+    }
+    depth( 16 );
+  }
+  void channel( uint8_t ch, int8_t delta ){                                    // Steps one channel, wrapping inside it and dropping the bits above the color
+    static const uint8_t shift_565[3] = { 11, 5, 0 }, width_565[3] = { 5, 6, 5 };
+    uint64_t v = (uint64_t)cur;
+    uint8_t  shift = color == RGB_888 ? 16 - 8 * ch : shift_565[ch];
+    uint64_t field = (color == RGB_888 ? 0xFFull : (1ull << width_565[ch]) - 1) << shift;
+    uint64_t top   = color == RGB_888 ? 0xFFFFFF : 0xFFFF;
+    v = (v & top & ~field) | ((((v & field) >> shift) + delta) << shift & field);
+    cur = wide() ? (cur >> 64 << 64) | v : v;
+  }
+  uint64_t pageValue( u128 v ) const {
+    if( base != 10 ) return (uint64_t)(v >> (64 * page));
+    for( uint8_t i = 0; i < page; i++ ) v /= WIDE_DEC_LIMB;
+    return (uint64_t)(v % WIDE_DEC_LIMB);
+  }
+};
+
+static uint64_t calc_rand_state;
+static uint64_t calcRand(){ calc_rand_state ^= calc_rand_state << 13; calc_rand_state ^= calc_rand_state >> 7; calc_rand_state ^= calc_rand_state << 17; return calc_rand_state; }
+
+static void typeValue( Calculator &c, RefCalc &ref, uint64_t v ){             // Clears the current value and keys in v, most significant digit first
+  uint8_t digits[64], n = 0;
+  do{ digits[n++] = v % ref.base; v /= ref.base; } while( v );
+  c.clear(); ref.clear();
+  while( n-- ){ c.enterDigit( digits[n] ); ref.digit( digits[n] ); }
+}
+
+static const char *calcDiffers( Calculator &c, const RefCalc &ref ){          // Names the first thing that doesn't match (NULL if nothing)
+  if( c.val_current != (uint64_t)ref.cur )            return "val_current";
+  if( c.val_stored  != (uint64_t)ref.sto )            return "val_stored";
+  if( c.op_command  != ref.op )                       return "op_command";
+  if( c.error       != ref.error )                    return "error";
+  if( c.store_flag  != ref.store_flag || c.result_active != ref.result_active ) return "flags";
+  if( c.bitDepth    != ref.bits || c.base != ref.base || c.color_mode != ref.color ) return "mode";
+  uint8_t bcd[BCD_BYTES];
+  bcdFromBinary( c.val_current, bcd );
+  if( memcmp( c.decimal( c.val_current ), bcd, BCD_BYTES ) ) return "decimal current";
+  bcdFromBinary( c.val_stored, bcd );
+  if( memcmp( c.decimal( c.val_stored ), bcd, BCD_BYTES ) )  return "decimal stored";
+  if( ref.wide() ){
+    if( wideValue( c.wide_current ) != ref.cur || wideValue( c.wide_stored ) != ref.sto ) return "wide values";
+    if( c.page != ref.page || c.pages() != ref.pages() ) return "page";
+    if( c.pageValue( c.wide_current ) != ref.pageValue( ref.cur ) ) return "page value";
+  }
+  return NULL;
+}
+
+static uint32_t calcFuzz( uint32_t runs, uint32_t presses ){                   // Returns the number of runs that went wrong
+  static_assert( WIDE_BITS == 128, "the reference model needs the default WIDE_BITS" );
+  uint32_t failures = 0;
+  for( uint32_t run = 0; run < runs; run++ ){
+    Calculator c;
+    RefCalc    ref;
+    calc_rand_state = 0x9E3779B97F4A7C15ull * (run + 1);
+    char last[48] = "start";
+    for( uint32_t p = 0; p < presses; p++ ){
+      uint32_t pick = calcRand() % 100;
+      uint64_t arg  = calcRand();
+      if( pick < 30 ){                                                         // A digit key (any of them, in any base, like the keypad)
+        uint8_t d = arg % 16;
+        c.enterDigit( d ); ref.digit( d );
+        snprintf( last, sizeof(last), "digit %x", d );
+      } else if( pick < 42 ){
+        uint8_t op = 1 + arg % (OP_COUNT - 1);
+        (c.*calc_op_setters[op])(); ref.setOp( op );
+        snprintf( last, sizeof(last), "op %u", op );
+      } else if( pick < 54 ){
+        c.equals(); ref.equals();
+        snprintf( last, sizeof(last), "equals" );
+      } else if( pick < 64 ){
+        uint8_t n = arg % 8;
+        (c.*calc_one_steps[n])(); ref.oneStep( n );
+        snprintf( last, sizeof(last), "one-step %u", n );
+      } else if( pick < 72 ){                                                  // Counts and divisors at the edges of the bit depth
+        uint16_t b = ref.wide() ? WIDE_BITS : ref.bits;
+        const uint64_t edges[] = { 0, 1, 2, b - 1u, b, b + 1u, 2u * b, ref.mask(), ref.mask() - 1, ref.mask() >> 1, arg };
+        uint64_t v = edges[(arg >> 32) % (sizeof(edges) / sizeof(edges[0]))];
+        typeValue( c, ref, v );
+        snprintf( last, sizeof(last), "type %llx", (unsigned long long)v );
+      } else if( pick < 78 ){
+        uint8_t n = arg % 6;
+        (c.*calc_depths[n])(); ref.depth( calc_depth_bits[n] );
+        snprintf( last, sizeof(last), "depth %u", calc_depth_bits[n] );
+      } else if( pick < 83 ){
+        const uint8_t bases[3] = { 8, 10, 16 };
+        uint8_t b = bases[arg % 3];
+        if( b == 8 ) c.setBase8(); else if( b == 10 ) c.setBase10(); else c.setBase16();
+        ref.setBase( b );
+        snprintf( last, sizeof(last), "base %u", b );
+      } else if( pick < 87 ){
+        if( arg & 1 ){ c.setColorMode888(); ref.color888(); } else { c.setColorMode565(); ref.color565(); }
+        snprintf( last, sizeof(last), "color %s", (arg & 1) ? "888" : "565" );
+      } else if( pick < 94 ){
+        uint8_t n = arg % 6;
+        (c.*calc_channels[n])(); ref.channel( n % 3, n < 3 ? 1 : -1 );
+        snprintf( last, sizeof(last), "channel %u", n );
+      } else if( pick < 96 ){
+        c.nextPage(); if( ref.wide() ) ref.page = (ref.page + 1) % ref.pages();
+        snprintf( last, sizeof(last), "next page" );
+      } else if( pick < 98 ){
+        c.clear(); ref.clear();
+        snprintf( last, sizeof(last), "clear" );
+      } else {
+        c.allClear(); ref.allClear();
+        snprintf( last, sizeof(last), "all clear" );
+      }
+      const char *what = calcDiffers( c, ref );
+      if( what ){
+        if( failures++ < 4 ) printf( "run %u press %u (%s, %u-bit base %u): %s differs (%llx, expected %llx)\n", run, p, last, ref.bits, ref.base,
+                                     what, (unsigned long long)c.val_current, (unsigned long long)(uint64_t)ref.cur );
+        break;
+      }
+    }
+  }
+  return failures;
+}
+
+struct CalcEdge{ uint8_t depth; uint8_t op; uint64_t l, r, want; };           // depth: index into calc_depths; op: OP_* or OPS_ONE_STEP | n
+
+static const CalcEdge calc_edges[] = {
+  { 0, OP_ROL,         0x81,               0,    0x81 },                       // Rotates by 0 and by the whole width change nothing
+  { 0, OP_ROL,         0x81,               8,    0x81 },
+  { 0, OP_ROR,         0x81,               8,    0x81 },
+  { 0, OP_ROL,         0x81,               9,    0x03 },
+  { 1, OP_ROR,         0x8001,             16,   0x8001 },
+  { 2, OP_ROL,         0x800001,           24,   0x800001 },
+  { 2, OP_ROL,         0x800001,           1,    0x000003 },
+  { 3, OP_ROR,         0x80000001,         0,    0x80000001 },
+  { 4, OP_ROL,         0x8000000000000001, 64,   0x8000000000000001 },
+  { 4, OP_ROR,         0x8000000000000001, 65,   0xC000000000000000 },
+  { 5, OP_ROL,         0x8000000000000001, 128,  0x8000000000000001 },
+  { 0, OP_LEFT_SHIFT,  0xFF,               8,    0 },                          // Shifts by the whole width clear the value
+  { 4, OP_RIGHT_SHIFT, ~0ull,              64,   0 },
+  { 2, OPS_ONE_STEP | 6, 0x123456,         0,    0x563412 },                   // 24-bit flips: three bytes, and the word rotates the channels
+  { 2, OPS_ONE_STEP | 7, 0x123456,         0,    0x345612 },
+  { 0, OPS_ONE_STEP | 6, 0xA5,             0,    0xA5 },
+  { 1, OPS_ONE_STEP | 7, 0x1234,           0,    0x1234 },
+  { 3, OPS_ONE_STEP | 7, 0x12345678,       0,    0x56781234 },
+  { 4, OPS_ONE_STEP | 6, 0x0102030405060708, 0,  0x0807060504030201 },
+  { 1, OP_DIVIDE,      1234,               0,    0xFFFF },                     // Division by zero
+  { 1, OP_MOD,         1234,               0,    1234 },
+  { 2, OP_DIVIDE,      0xFFFFFF,           0x10, 0x0FFFFF },
+  { 0, OP_MINUS,       0,                  1,    0xFF },
+  { 3, OP_MULTIPLY,    0x10000,            0x10000, 0 },
+};
+
+static uint32_t calcEdges(){                                                   // Returns the number of failures
+  uint32_t failures = 0;
+  for( const CalcEdge &e : calc_edges ){
+    Calculator c;
+    (c.*calc_depths[e.depth])();
+    if( e.op & OPS_ONE_STEP ){
+      c.val_current = e.l; c.wide_current.set( e.l );
+      (c.*calc_one_steps[e.op & ~OPS_ONE_STEP])();
+    } else {
+      c.val_stored = e.l; c.wide_stored.set( e.l );
+      c.val_current = e.r; c.wide_current.set( e.r );
+      c.op_command = e.op;
+      c.equals();
+    }
+    if( c.val_current != e.want && failures++ < 4 ) printf( "edge: %u-bit op %02x of %llx, %llx gave %llx, expected %llx\n", calc_depth_bits[e.depth], e.op,
+                                                            (unsigned long long)e.l, (unsigned long long)e.r, (unsigned long long)c.val_current, (unsigned long long)e.want );
+  }
+  for( uint32_t v = 0; v < 0x10000; v++ ){                                     // 565 -> 888 -> 565 gives back every color
+    Calculator c;
+    c.val_current = v;
+    c.setColorMode888();
+    c.setColorMode565();
+    if( c.val_current != v && failures++ < 4 ) printf( "edge: 565 %04x came back from 888 as %04llx\n", v, (unsigned long long)c.val_current );
+  }
+  Calculator c;                                                                // and 888 -> 565 -> 888 keeps the top bits of each channel
+  c.setColorMode888(); c.val_current = 0xFFFFFF;
+  c.setColorMode565(); c.setColorMode888();
+  if( c.val_current != 0xF8FCF8 && failures++ < 4 ) printf( "edge: 888 ffffff came back from 565 as %06llx\n", (unsigned long long)c.val_current );
+  return failures;
+}
+
+static void calcThroughput( uint32_t reps ){                                   // Operations per second through equals() and the one-step functions
+  const uint32_t count = 1024;
+  static uint64_t l[count], r[count], shift[count];
+  static WideWord wl[count], wr[count], wshift[count];
+  calc_rand_state = 0x2545F4914F6CDD1Dull;
+  for( uint32_t i = 0; i < count; i++ ){
+    l[i] = calcRand(); r[i] = calcRand() | 1; shift[i] = i % 72;
+    wl[i].set( l[i] ); wl[i].setWord( 1, calcRand() );
+    wr[i].set( r[i] ); wr[i].setWord( 1, calcRand() >> (i % 64) );
+    wshift[i].set( i % 140 );
+  }
+  printf( "\n%-10s", "Mops/s" );
+  for( uint8_t d = 0; d < 6; d++ ) printf( " %7u", calc_depth_bits[d] );
+  printf( "\n" );
+  for( const OpEntry &e : ops_table ){
+    bool one_step = e.op & OPS_ONE_STEP;
+    bool shifts   = e.op == OP_ROL || e.op == OP_ROR || e.op == OP_LEFT_SHIFT || e.op == OP_RIGHT_SHIFT;
+    printf( "%-10s", e.name );
+    for( uint8_t d = 0; d < 6; d++ ){
+      Calculator c;
+      (c.*calc_depths[d])();
+      bool wide = c.wide();
+      volatile uint64_t sink = 0;
+      uint64_t start = mock_host_ns();
+      for( uint32_t rep = 0; rep < reps; rep++ ){
+        for( uint32_t i = 0; i < count; i++ ){
+          if( one_step ){
+            if( wide ) c.wide_current = wl[i]; else c.val_current = l[i];
+            (c.*calc_one_steps[e.op & ~OPS_ONE_STEP])();
+          } else {
+            c.result_active = false;
+            c.op_command = e.op;
+            if( wide ){ c.wide_stored = wl[i]; c.wide_current = shifts ? wshift[i] : wr[i]; }
+            else      { c.val_stored  = l[i];  c.val_current  = shifts ? shift[i]  : r[i]; }
+            c.equals();
+          }
+          sink = sink + c.val_current;
+        }
+      }
+      double ns = (mock_host_ns() - start) / double(reps * count);
+      printf( " %7.1f", 1000.0 / ns );
+    }
+    printf( "\n" );
+  }
+  printf( "(host operations per second, including the operand setup; --ops estimates the AVR cost)\n" );
+}
+
+static int calcTest( uint32_t reps ){                                          // Fuzz, edge cases and throughput of the Calculator
+  uint32_t fuzz_failures = calcFuzz( reps, 20000 );
+  printf( "fuzz: %u runs of %u presses against the reference model, %u failed\n", reps, 20000, fuzz_failures );
+  uint32_t edge_failures = calcEdges();
+  printf( "edges: %u cases plus the 565/888 round trips, %u failed\n", (unsigned)(sizeof(calc_edges) / sizeof(calc_edges[0])), edge_failures );
+  calcThroughput( reps );
+  return fuzz_failures || edge_failures ? 1 : 0;
+}
+
+/*******************************************
+* Remote Control                           *
+*******************************************/
+// Drives the calculator through remote.h the way a test rig would: a table of lines with known
+// answers, random conversions and operations checked against the compiler's integers, a batch that
+// must not draw anything until it ends, and the same lines again over a real pty. The throughput
+// is the host's, plus what the port itself allows at REMOTE_BAUD (10 bits a byte), which is the
+// limit on the calculator.
+#define REMOTE_PORT 2                                                          // REMOTE_SERIAL is Serial2
+
+#if HEXCALC_REMOTE
+
+static char remote_output[MOCK_SERIAL_BUFFER];
+
+static const char *remoteCommand( const char *line ){                           // Sends one line (without the newline) and returns the answer (without its "\r\n")
+  mock_serial_input( REMOTE_PORT, line );
+  mock_serial_input( REMOTE_PORT, "\n" );
+  loop();
+  size_t n = mock_serial_output( REMOTE_PORT, remote_output, sizeof(remote_output) );
+  while( n && (remote_output[n - 1] == '\n' || remote_output[n - 1] == '\r') ) remote_output[--n] = 0;
+  return remote_output;
+}
+
+struct RemoteCase{ const char *line; const char *answer; };
+
+static const RemoteCase remote_cases[] = {                                     // Run in order (each starts from where the last one left the calculator)
+  { "ac b16 w64 vFF ?",                  "h:FF d:255 o:377 b:11111111" },
+  { "b10 v1234 ?h ?d ?o",                "4D2 1234 2322" },
+  { "b16 vdeadBEEF ?d",                  "3735928559" },
+  { "w8 ?h",                             "EF" },
+  { "w16 ac v7 + v5 = ?d",               "12" },
+  { "v5 - v7 = ?h",                      "FFFE" },
+  { "v10 * v10 = ?h",                    "100" },
+  { "vFF00 >> v4 = ?h",                  "FF0" },
+  { "vF00F rol v4 = ?h",                 "FF" },
+  { "v8001 rol1 ?h",                     "3" },
+  { "v1234 bswap ?h",                    "3412" },
+  { "v1 neg ?h",                         "FFFF" },
+  { "v0 not ?b",                         "1111111111111111" },
+  { "v5 / v0 = ?",                       "h:FFFF d:65535 o:177777 b:1111111111111111 e:div0" },
+  { "ac ?",                              "h:0 d:0 o:0 b:0" },
+  { "w64 vFFFFFFFFFFFFFFFF ?d",          "18446744073709551615" },
+  { "w128 vFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF + v1 = ?h", "0" },
+  { "b10 v340282366920938463463374607431768211455 ?h ?o", "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF 3777777777777777777777777777777777777777777" },
+  { "v123456789012345678901234567890 ?h ?d", "18EE90FF6C373E0EE4E3F0AD2 123456789012345678901234567890" },
+  { "b16 v1 << v7F = ?h",                "80000000000000000000000000000000" },
+  { "w64 ac k1 k2 ?h",                   "12" },
+  { "{ ac v1 }",                         "ok" },
+  { "b8 v9",                             "! v9" },
+  { "b16 v:",                            "! v:" },                      // (the characters between '9' and 'A' aren't digits)
+  { "b16 v1@",                           "! v1@" },
+  { "vfF ?h",                            "FF" },
+  { "xyz ?h",                            "! xyz" },
+  { "k99",                               "! k99" },
+  { "?x",                                "! ?x" },
+  { "stream w64 =oooo",                  "! =oooo" },                   // (a field twice would overrun the answer's line)
+  { "stream =hdh",                       "! =hdh" },
+  { "stream =aa",                        "! =aa" },
+  { "stream b16 &:",                     "! &:" },
+};
+#define NUM_REMOTE_CASES (sizeof(remote_cases) / sizeof(remote_cases[0]))
+
+typedef unsigned __int128 u128;
+
+static void remoteFormat( u128 val, uint8_t base, char *out ){                 // The compiler's idea of val in base
+  char text[132];
+  uint8_t n = 0;
+  do { text[n++] = "0123456789ABCDEF"[val % base]; val /= base; } while( val );
+  while( n ) *out++ = text[--n];
+  *out = 0;
+}
+
+static u128 remoteRandom( uint16_t bits ){                                     // Random value of up to bits bits (biased to short ones now and then)
+  u128 val = ((u128)calcRand() << 64) | calcRand();
+  if( calcRand() % 4 == 0 ) val >>= calcRand() % bits;
+  return bits < 128 ? val & (((u128)1 << bits) - 1) : val;
+}
+
+// Streams (stream.h): register dumps through a few settings, checked against the compiler, then a
+// long dump at 115200 baud on a paced port to see that the answers keep the line busy and that flow
+// control stops the sender before the receive buffer overruns. The mock doesn't charge the
+// firmware's own time, so loop() is taken to run every STREAM_PASS_US.
+#define STREAM_PASS_US 100
+#define STREAM_BAUD    115200
+
+static char stream_output[1 << 16];
+
+static size_t streamRun( const char *settings, const char *values, uint32_t baud, uint32_t &pauses, uint64_t &elapsed_us ){ // Streams values (ending with ".") and returns the length of everything that came back
+  size_t length = 0;
+  pauses = 0;
+  mock_serial_set_rate( REMOTE_PORT, baud );
+  mock_serial_input( REMOTE_PORT, settings );
+  mock_serial_input( REMOTE_PORT, "\n" );
+  mock_serial_input( REMOTE_PORT, values );
+  uint64_t start = micros();
+  bool started = false;
+  for( uint32_t pass = 0; pass < 200000 && (!started || stream_active); pass++ ){
+    loop();
+    started |= stream_active;
+    mock_clock_advance_us( STREAM_PASS_US );
+    char chunk[MOCK_SERIAL_BUFFER];
+    size_t n = mock_serial_output( REMOTE_PORT, chunk, sizeof(chunk) );
+    for( size_t i = 0; i < n && length < sizeof(stream_output) - 1; i++ ){    // (XON / XOFF out of the way)
+      if( chunk[i] == STREAM_XOFF ) pauses++;
+      if( chunk[i] != STREAM_XOFF && chunk[i] != STREAM_XON ) stream_output[length++] = chunk[i];
+    }
+  }
+  elapsed_us = micros() - start;
+  stream_output[length] = 0;
+  mock_serial_set_rate( REMOTE_PORT, 0 );
+  return length;
+}
+
+static void streamExpect( uint64_t val, uint8_t bits, const char *fields, char *out ){ // The answer the compiler's printf gives
+  for( const char *f = fields; *f; f++ ){
+    if( f != fields ) *out++ = ' ';
+    if( *f == 'h' ) out += sprintf( out, "%0*llX", bits / 4, (unsigned long long)val );
+    if( *f == 'o' ) out += sprintf( out, "%0*llo", (bits + 2) / 3, (unsigned long long)val );
+    if( *f == 'd' ) out += sprintf( out, "%llu", (unsigned long long)val );
+    if( *f == 'a' ) for( int i = bits / 8 - 1; i >= 0; i-- ){ uint8_t c = val >> (i * 8); *out++ = c >= 0x20 && c < 0x7F ? c : '.'; }
+  }
+  strcpy( out, "\r\n" );
+}
+
+static uint64_t streamBswap32( uint64_t v ){ return __builtin_bswap32( (uint32_t)v ); }
+static uint64_t streamMask16( uint64_t v ){  return v & 4080; }
+static uint64_t streamRol8( uint64_t v ){    return (uint8_t)((v << 3) | (v >> 5)); }
+static uint64_t streamShr64( uint64_t v ){   return v >> 4; }
+static uint64_t streamNeg32( uint64_t v ){   return (uint32_t)(0 - v); }
+static uint64_t streamNeg24( uint64_t v ){   return (0 - v) & 0xFFFFFF; }
+
+struct StreamCase{ const char *settings; uint8_t base, bits; uint64_t (*op)( uint64_t ); const char *fields; };
+
+static const StreamCase stream_cases[] = {
+  { "stream b16 w32 bswap =hdoa", 16, 32, streamBswap32, "hdoa" },
+  { "stream b10 w16 &4080",       10, 16, streamMask16,  "hd" },
+  { "stream b8 w8 rol3 =ho",       8,  8, streamRol8,    "ho" },
+  { "b16 w64 stream >>4 =d",      16, 64, streamShr64,   "d" },
+  { "stream b16 w32 neg =ha",     16, 32, streamNeg32,   "ha" },
+  { "rgb888 stream neg",          16, 24, streamNeg24,   "hd" },           // (depth and base from the calculator)
+};
+
+static bool streamCheck( const StreamCase &sc ){                               // Streams a random dump through one setting and checks every answer
+  static char values[MOCK_SERIAL_BUFFER / 2];
+  uint64_t expect[160];
+  char     *p = values;
+  uint8_t  count = 0;
+  uint64_t mask = sc.bits < 64 ? (1ull << sc.bits) - 1 : ~0ull;
+  const char *format = sc.base == 16 ? "%llX" : sc.base == 10 ? "%llu" : "%llo";
+  for( uint8_t line = 0; line < 32; line++ ){                                  // Lines like "0040: 1A2B 3C4D 5E6F 7081"
+    p += sprintf( p, "%04X:", line * 16 );
+    for( uint8_t i = 0; i < 4; i++ ){
+      uint64_t v = calcRand() & mask;
+      expect[count++] = v;
+      *p++ = i == 2 ? ',' : ' ';                                               // (and the odd comma)
+      p += sprintf( p, format, (unsigned long long)v );
+    }
+    p += sprintf( p, line % 3 ? "\n" : "\r\n" );
+  }
+  p += sprintf( p, "0x1F zz 1@ .\n" );
+  expect[count++] = 0x1F & mask;
+
+  uint32_t pauses;
+  uint64_t us;
+  bool     quiet = !strncmp( sc.settings, "stream", 6 );                       // Nothing but the stream on the line, so nothing to draw
+  uint32_t words = (mock_panel_flush(), mock_panel.spi_words);
+  streamRun( sc.settings, values, 0, pauses, us );
+  mock_panel_flush();
+  if( quiet && mock_panel.spi_words != words ){ printf( "%s: the screen was drawn\n", sc.settings ); return false; }
+  char want[STREAM_LINE + 8];
+  const char *got = stream_output;
+  bool ok = !strncmp( got, "ok\r\n", 4 );
+  got += 4;
+  for( uint8_t i = 0; ok && i <= count + 1; i++ ){
+    if( i >= count ) strcpy( want, "!\r\n" );                                 // (zz, and 1@ since '@' isn't a digit)
+    else {
+      streamExpect( sc.op( expect[i] ) & mask, sc.bits, sc.fields, want );
+    }
+    if( strncmp( got, want, strlen( want ) ) ){
+      printf( "%s: value %u came back as %.*s, not %s", sc.settings, i, (int)strcspn( got, "\n" ) + 1, got, want );
+      ok = false;
+    }
+    got += strlen( want );
+  }
+  if( ok && strcmp( got, "ok\r\n" ) ){ printf( "%s: ended with %s\n", sc.settings, got ); ok = false; }
+  printf( "%-30s %3u values %s\n", sc.settings, count + 2, ok ? "ok" : "FAILED" );
+  return ok;
+}
+
+static bool streamLineRate( const char *settings ){                            // A long dump at STREAM_BAUD, one value a line
+  static char values[MOCK_SERIAL_BUFFER - 64];                                 // (room for the settings in the port's queue)
+  char *p = values;
+  uint32_t count = 0;
+  while( p < values + sizeof(values) - 16 ){ p += sprintf( p, "%08X\n", (uint32_t)calcRand() ); count++; }
+  strcpy( p, ".\n" );
+  uint32_t in_bytes = p - values + 2 + strlen( settings ) + 1, pauses;
+  uint64_t us;
+  uint32_t overruns = mock_serial_overruns( REMOTE_PORT );
+  size_t   out_bytes = streamRun( settings, values, STREAM_BAUD, pauses, us );
+  overruns = mock_serial_overruns( REMOTE_PORT ) - overruns;
+  uint32_t lines = 0;
+  for( const char *c = stream_output; *c; c++ ) lines += *c == '\n';
+  double byte_us = 10e6 / STREAM_BAUD;
+  double busiest = std::max( in_bytes, (uint32_t)out_bytes ) * byte_us;      // The direction with more to send sets the pace
+  printf( "%-30s %u values in %.0f ms: %.0f values/s, %u B in / %u B out, line busy %.0f%%, %u XOFF, %u overruns\n", settings, count,
+          us / 1000.0, count / (us / 1e6), in_bytes, (unsigned)out_bytes, 100 * busiest / us, pauses, overruns );
+  return !overruns && lines == count + 2 && busiest / us > 0.95;
+}
+
+static int remoteTest( uint32_t reps ){
+  setup();
+  bool ok = true;
+
+  printf( "%-52s %s\n", "line", "answer" );
+  for( const RemoteCase &rc : remote_cases ){
+    const char *answer = remoteCommand( rc.line );
+    bool match = !strcmp( answer, rc.answer );
+    printf( "%-52s %s%s%s\n", rc.line, answer, match ? "" : "  expected ", match ? "" : rc.answer );
+    ok &= match;
+  }
+  if( !screenMatchesState() ){ printf( "screen doesn't show the state the lines left\n" ); ok = false; }
+
+  // Random conversions and operations in every width and base, checked against the compiler
+  static const uint16_t widths[] = { 8, 16, 32, 64, 128 };
+  static const uint8_t  bases[]  = { 8, 10, 16 };
+  static const char    *ops[]    = { "+", "-", "*", "&", "|", "^" };
+  calc_rand_state = 0x2545F4914F6CDD1DULL;
+  uint32_t lines = 1000 * reps, wrong = 0;
+  uint64_t bytes = 0;
+  remoteCommand( "{" );                                                        // (no frames in the timed part)
+  uint64_t start = mock_host_ns();
+  for( uint32_t i = 0; i < lines; i++ ){
+    uint16_t bits = widths[calcRand() % 5];
+    uint8_t  base = bases[calcRand() % 3];
+    u128     mask = bits < 128 ? ((u128)1 << bits) - 1 : ~(u128)0;
+    u128     x = remoteRandom( bits ), y = remoteRandom( bits ), expect = x;
+    char     line[REMOTE_LINE], xs[132], ys[132], hs[40], ds[48], os[48], bs[132], want[300];
+    remoteFormat( x, base, xs );
+    int n = snprintf( line, sizeof(line), "w%u b%u v%s", bits, base, xs );
+    if( i & 1 ){                                                               // Every other line is an operation rather than a plain conversion
+      uint8_t op = calcRand() % 6;
+      remoteFormat( y, base, ys );
+      snprintf( line + n, sizeof(line) - n, " %s v%s = ?", ops[op], ys );
+      switch( op ){
+        case 0: expect = x + y; break;  case 1: expect = x - y; break;  case 2: expect = x * y; break;
+        case 3: expect = x & y; break;  case 4: expect = x | y; break;  case 5: expect = x ^ y; break;
+      }
+      expect &= mask;
+    } else {
+      snprintf( line + n, sizeof(line) - n, " ?" );
+    }
+    remoteFormat( expect, 16, hs ); remoteFormat( expect, 10, ds ); remoteFormat( expect, 8, os ); remoteFormat( expect, 2, bs );
+    snprintf( want, sizeof(want), "h:%s d:%s o:%s b:%s", hs, ds, os, bs );
+    const char *answer = remoteCommand( line );
+    bytes += strlen( line ) + 1 + strlen( answer ) + 2;
+    if( strcmp( answer, want ) && wrong++ < 5 ) printf( "%s\n  got      %s\n  expected %s\n", line, answer, want );
+  }
+  double ns = mock_host_ns() - start;
+  uint32_t words = (mock_panel_flush(), mock_panel.spi_words);
+  remoteCommand( "}" );
+  mock_panel_flush();
+  if( mock_panel.spi_words == words ){ printf( "the end of the batch drew nothing\n" ); ok = false; }
+  if( !screenMatchesState() ){ printf( "screen doesn't show the state the batch left\n" ); ok = false; }
+  ok &= !wrong;
+
+  // A batch draws nothing until it ends, lines outside one draw a frame each
+  remoteCommand( "{" );
+  mock_panel_flush();
+  words = mock_panel.spi_words;
+  for( uint8_t i = 0; i < 50; i++ ) remoteCommand( "w32 b10 v123 + v1 = ?" );
+  mock_panel_flush();
+  bool held = mock_panel.spi_words == words;
+  remoteCommand( "}" );
+  remoteCommand( "v7 ?d" );
+  mock_panel_flush();
+  bool drawn = mock_panel.spi_words != words;
+  printf( "\nbatch %s, redraw after it %s\n", held ? "held" : "DREW", drawn ? "done" : "MISSING" );
+  ok &= held && drawn && screenMatchesState();
+
+  printf( "%u random lines: %u wrong, %.0f lines/s on the host, %.1f bytes a line, port limit %.0f lines/s at %u baud\n",
+          lines, wrong, lines / (ns / 1e9), (double)bytes / lines, REMOTE_BAUD / 10.0 / ((double)bytes / lines), REMOTE_BAUD );
+  const char *single = "b16 vDEADBEEFCAFE ?d";                               // One value in, one base out, as a converting rig would ask
+  uint32_t single_bytes = strlen( single ) + 1 + strlen( remoteCommand( single ) ) + 2;
+  printf( "\"%s\": %u bytes, port limit %.0f conversions/s\n", single, single_bytes, REMOTE_BAUD / 10.0 / single_bytes );
+
+  printf( "\n" );
+  for( const StreamCase &sc : stream_cases ) ok &= streamCheck( sc );
+  ok &= streamLineRate( "stream b16 w32 =h" );
+  ok &= streamLineRate( "stream b16 w32 bswap =hda" );
+
+  // The same over a pty, as a rig on the other end of a serial port would see it
+  const char *path = mock_serial_open_pty( REMOTE_PORT );
+  int fd = path ? open( path, O_RDWR | O_NOCTTY ) : -1;
+  if( fd < 0 ){
+    printf( "pty: could not open one (skipped)\n" );
+  } else {
+    struct termios tio;
+    tcgetattr( fd, &tio );
+    cfmakeraw( &tio );
+    tcsetattr( fd, TCSANOW, &tio );
+    const char *send = "ac b10 w32 v42 ?h\n", *want = "2A\r\n";
+    char got[64] = "";
+    size_t length = 0;
+    bool sent = write( fd, send, strlen( send ) ) == (ssize_t)strlen( send );
+    fcntl( fd, F_SETFL, O_NONBLOCK );
+    for( int tries = 0; sent && tries < 1000 && !strchr( got, '\n' ); tries++ ){
+      loop();
+      ssize_t n = read( fd, got + length, sizeof(got) - 1 - length );
+      if( n > 0 ) got[length += n] = 0; else usleep( 1000 );
+    }
+    close( fd );
+    bool match = !strcmp( got, want );
+    printf( "pty %s: %s", path, match ? "2A ok\n" : "no answer, or the wrong one\n" );
+    ok &= match;
+  }
+  printf( "\nremote %s\n", ok ? "ok" : "FAILED" );
+  return ok ? 0 : 1;
+}
+#else
+static int remoteTest( uint32_t reps ){
+  printf( "built with HEXCALC_REMOTE=0, nothing to drive\n" );
+  return 0;
+}
+#endif
+
+/*******************************************
+* Profile                                  *
+*******************************************/
+// Replays a fixed key script (every scenario's mode switch and keys, once) and writes a CSV line per
+// key with nothing in it that changes from run to run, so two commits' profiles can be diffed
+// (make profile writes build/profile.csv). The SPI runs at KEYPAD_SPI_HZ on the virtual clock, so
+// the stage columns, which are the firmware's own stats.h stage times in us, are the time each stage
+// keeps the SPI busy. words, bytes and windows are exact counts. op_cyc is the --ops estimate of the
+// Calculator operation the key ran (in extended precision, AVR_CYCLES_WIDE_STEP per limb step of
+// anything the key did). No simulator runs the AVR Dx parts, so the CPU side of a frame can only
+// be measured on the calculator itself (a HEXCALC_STATS build).
+#if HEXCALC_STATS
+
+static const uint8_t profile_one_step[][2] = {                                 // One-step keys and their index in oneStepKernel() (applyKey swaps the rotates)
+  { KEY_LSHIFT, 0 }, { KEY_RSHIFT, 1 }, { KEY_ROR, 2 }, { KEY_ROL, 3 },
+  { KEY_1S, 4 }, { KEY_2S, 5 }, { KEY_BYTE_FLIP, 6 }, { KEY_WORD_FLIP, 7 },
+};
+#define PROFILE_NO_OP 0xFF
+
+static const char *opName( uint8_t op ){
+  for( const OpEntry &e : ops_table ) if( e.op == op ) return e.name;
+  return "-";
+}
+
+static void profileKey( const char *scenario, uint8_t key ){                   // Presses one key and prints its line
+  uint8_t  op = PROFILE_NO_OP;
+  uint64_t l = calc.result_active ? calc.val_current : calc.val_stored;        // The operands equals() is about to use
+  uint64_t r = calc.result_active ? calc.val_stored  : calc.val_current;
+  if( key == KEY_EQUALS && calc.op_command != OP_NONE ) op = calc.op_command;
+  for( const uint8_t *k : profile_one_step ) if( k[0] == key ){ op = OPS_ONE_STEP | k[1]; l = calc.val_current; }
+  bool    wide  = calc.wide();
+  uint8_t bits  = calc.bitDepth;
+  uint8_t bytes = bits > 32 ? 8 : bits > 16 ? 4 : bits >> 3;                  // Word the kernels work in (see opsBenchmark)
+
+  StatCounter before[STAT_COUNT];
+  memcpy( before, stats, sizeof(stats) );
+  wide_steps = 0;
+  FrameCost c = pressKey( key );
+  uint32_t cycles = wide ? wide_steps * AVR_CYCLES_WIDE_STEP : op == PROFILE_NO_OP ? 0 : avrCycles( op, bytes, bits, l, r, true );
+
+  printf( "%s,%u,%s,%u,%u,%u,%u", scenario, key, opName( op ), cycles, c.words, c.bytes, c.windows );
+  for( uint8_t stat = 0; stat <= STAT_FRAME; stat++ ) printf( ",%llu", (unsigned long long)(stats[stat].sum - before[stat].sum) );
+  printf( "\n" );
+}
+
+static int profileRun(){
+  setup();
+  statsReset();
+  mock_spi_set_rate( KEYPAD_SPI_HZ );
+  printf( "scenario,key,op,op_cyc,words,bytes,windows" );
+  for( uint8_t stat = 0; stat <= STAT_FRAME; stat++ ) printf( ",%s_us", stat_names[stat] );
+  printf( "\n" );
+  for( const Scenario &sc : scenarios ){
+    leaveMode( sc );                                                           // (not profiled, like the render benchmark)
+    profileKey( sc.name, sc.mode_key );
+    if( sc.depth_key != 0xFF ) profileKey( sc.name, sc.depth_key );
+    for( const uint8_t *k = sc.script; *k != END_OF_SCRIPT; k++ ) profileKey( sc.name, *k );
+  }
+  mock_spi_set_rate( 0 );
+  return 0;
+}
+#else
+static int profileRun(){
+  printf( "built with HEXCALC_STATS=0, nothing to profile\n" );
+  return 0;
+}
+#endif
+
+static void report( bool csv, const char *name, const char *phase, const Totals &t, uint32_t hash ){
+  double frames = t.frames ? t.frames : 1;
+  if( csv ){
+    printf( "%s,%s,%u,%.1f,%u,%.1f,%.1f,%.2f,%.2f,%08x\n", name, phase, t.frames, t.words / frames, t.max_words,
+            t.bytes / frames, t.windows / frames, t.ns / frames / 1000.0, t.max_ns / 1000.0, hash );
+  } else {
+    printf( "%-8s %-6s %6u %10.1f %9u %10.1f %8.1f %9.2f %9.2f  %08x\n", name, phase, t.frames, t.words / frames, t.max_words,
+            t.bytes / frames, t.windows / frames, t.ns / frames / 1000.0, t.max_ns / 1000.0, hash );
+  }
+}
+
+int main( int argc, char **argv ){
+  uint32_t reps = 20;
+  bool csv = false;
+  const char *dump_dir = NULL;
+  bool format = false;
+  bool keypad = false;
+  bool calc_test = false;
+  bool ops = false;
+  bool stats_test = false;
+  bool remote_test = false;
+  bool boot_test = false;
+  bool profile = false;
+  for( int i = 1; i < argc; i++ ){
+    if( !strcmp( argv[i], "-n" ) && i + 1 < argc ) reps = atoi( argv[++i] );
+    else if( !strcmp( argv[i], "-v" ) ) verbose = true;
+    else if( !strcmp( argv[i], "--csv" ) ) csv = true;
+    else if( !strcmp( argv[i], "--dump" ) && i + 1 < argc ) dump_dir = argv[++i];
+    else if( !strcmp( argv[i], "--no-decode" ) ) mock_panel_set_decode( false );
+    else if( !strcmp( argv[i], "--format" ) ) format = true;
+    else if( !strcmp( argv[i], "--keypad" ) ) keypad = true;
+    else if( !strcmp( argv[i], "--ops" ) ) ops = true;
+    else if( !strcmp( argv[i], "--calc" ) ) calc_test = true;
+    else if( !strcmp( argv[i], "--stats" ) ) stats_test = true;
+    else if( !strcmp( argv[i], "--remote" ) ) remote_test = true;
+    else if( !strcmp( argv[i], "--boot" ) ) boot_test = true;
+    else if( !strcmp( argv[i], "--profile" ) ) profile = true;
+    else { fprintf( stderr, "usage: %s [-n reps] [-v] [--csv] [--dump dir] [--no-decode] [--format] [--keypad] [--ops] [--calc] [--stats] [--remote] [--boot] [--profile]\n", argv[0] ); return 2; }
+  }
+  if( reps == 0 ) reps = 1;
+  if( format ) return formatComparison( reps );
+  if( keypad ) return keypadTest( reps );
+  if( ops ) return opsBenchmark( reps );
+  if( calc_test ) return calcTest( reps );
+  if( stats_test ) return statsTest();
+  if( remote_test ) return remoteTest( reps );
+  if( boot_test ) return bootTest();
+  if( profile ) return profileRun();
+
+  setup();                                                                     // Boot the firmware (initial full-screen render)
+
+  if( csv ) printf( "scenario,phase,frames,words_avg,words_max,bytes_avg,windows_avg,host_us_avg,host_us_max,fb_hash\n" );
+  else      printf( "%-8s %-6s %6s %10s %9s %10s %8s %9s %9s  %s\n", "scenario", "phase", "frames", "words/frm", "words max",
+                    "bytes/frm", "win/frm", "us/frm", "us max", "fb hash" );
+
+  Totals all = {};
+  for( uint32_t s = 0; s < NUM_SCENARIOS; s++ ){
+    const Scenario &sc = scenarios[s];
+    Totals t_switch = {}, t_keys = {};
+    for( uint32_t rep = 0; rep < reps; rep++ ){
+      leaveMode( sc );                                                         // Not measured: just sets up a genuine mode switch
+      FrameCost c = pressKey( sc.mode_key );
+      if( sc.depth_key != 0xFF ){                                              // The depth key is part of the switch (sum both frames)
+        FrameCost d = pressKey( sc.depth_key );
+        c.words += d.words; c.bytes += d.bytes; c.windows += d.windows; c.ns += d.ns;
+      }
+      t_switch.add( c );
+      if( verbose && rep == 0 ) printf( "  %-8s switch   words=%u windows=%u us=%.2f\n", sc.name, c.words, c.windows, c.ns / 1000.0 );
+      for( const uint8_t *k = sc.script; *k != END_OF_SCRIPT; k++ ){
+        FrameCost kc = pressKey( *k );
+        t_keys.add( kc );
+        if( verbose && rep == 0 ) printf( "  %-8s key %-4u words=%u windows=%u us=%.2f\n", sc.name, *k, kc.words, kc.windows, kc.ns / 1000.0 );
+      }
+    }
+    uint32_t hash = mock_framebuffer_hash();
+    report( csv, sc.name, "switch", t_switch, hash );
+    report( csv, sc.name, "keys",   t_keys,   hash );
+    all.frames += t_switch.frames + t_keys.frames;
+    all.words += t_switch.words + t_keys.words;   all.bytes += t_switch.bytes + t_keys.bytes;
+    all.windows += t_switch.windows + t_keys.windows; all.ns += t_switch.ns + t_keys.ns;
+    if( t_switch.max_words > all.max_words ) all.max_words = t_switch.max_words;
+    if( t_keys.max_words > all.max_words ) all.max_words = t_keys.max_words;
+    if( t_switch.max_ns > all.max_ns ) all.max_ns = t_switch.max_ns;
+    if( t_keys.max_ns > all.max_ns ) all.max_ns = t_keys.max_ns;
+
+    if( dump_dir ){
+      char path[256];
+      snprintf( path, sizeof(path), "%s/%s.ppm", dump_dir, sc.name );
+      for( char *p = path + strlen( dump_dir ) + 1; *p; p++ ) if( *p == '/' ) *p = '_';
+      if( !mock_framebuffer_write_ppm( path ) ) fprintf( stderr, "could not write %s\n", path );
+    }
+  }
+  report( csv, "ALL", "total", all, mock_framebuffer_hash() );
+  return 0;
+}
@@ -0,0 +1,101 @@
+/*
+  ___ ___                _________        .__
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/
+
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+--- Description: ---
+Font compiler. Reads the column-major font5x7 table in ../source/font.h
+and writes ../source/font_rows.h, which holds the same glyphs row-major
+(one byte per glyph row, column 0 in the top bit) as const data so it
+stays in flash. It also writes a subset table holding only the characters
+in SUBSET_CHARS below, with a 256 byte map from character to glyph.
+
+Usage: fontgen > ../source/font_rows.h   (or just `make` in this folder)
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include "font.h"
+
+// Every character the firmware draws from a string literal or number formatter. The ASCII
+// column of the binary menu can show any byte, so it needs the full table.
+static const char SUBSET_CHARS[] = " +,-/0123456789:<>ABCDEFHLMNORTXo";
+
+static uint8_t glyphRow( uint8_t c, uint8_t row ){                             // Row of a glyph with column 0 in the top bit
+  uint8_t bits = 0;
+  for( uint8_t col = 0; col < CHAR_WIDTH; col++ ){
+    if( font5x7[c * CHAR_WIDTH + col] & (1 << row) ) bits |= 0x80 >> col;
+  }
+  return bits;
+}
+
+static void printGlyph( uint8_t c, bool last ){                                // One line of the table per glyph
+  printf( "  " );
+  for( uint8_t row = 0; row < CHAR_HEIGHT; row++ ) printf( "0x%02X%s", glyphRow( c, row ), (last && row == CHAR_HEIGHT - 1) ? " " : ", " );
+  if( c >= 0x20 && c < 0x7F && c != '\\' ) printf( " // 0x%02X '%c'\n", c, c );
+  else                                     printf( " // 0x%02X\n", c );
+}
+
+int main(){
+  uint8_t subset_slot[256] = {0};                                              // Glyph slot of every character in the subset (slot 0 is the space)
+  uint8_t subset_size = 0;
+  for( const char *p = SUBSET_CHARS; *p; p++ ) subset_slot[(uint8_t)*p] = subset_size++;
+
+  printf( "#ifndef _FONT_ROWS_H_\n#define _FONT_ROWS_H_\n\n" );
+  printf( "// Generated by host/fontgen.cpp from font.h. Do not edit, run make in host/ instead.\n" );
+  printf( "//\n" );
+  printf( "// The glyphs are stored row-major: glyph c's rows are font_rows[c*CHAR_HEIGHT] onwards, with\n" );
+  printf( "// column 0 in the top bit of each row, so a rasterizer reads one byte per glyph row and walks the\n" );
+  printf( "// columns with a left shift. DxCore keeps const data in the memory-mapped flash, so none of this\n" );
+  printf( "// takes up RAM. Define FONT_SUBSET to build with only the characters in FONT_SUBSET_CHARS\n" );
+  printf( "// (anything else draws as a space, which blanks most of the ASCII column of the binary menu).\n\n" );
+  printf( "#include <stdint.h>\n\n" );
+  printf( "#define CHAR_WIDTH  %d\n", CHAR_WIDTH );
+  printf( "#define CHAR_HEIGHT %d\n\n", CHAR_HEIGHT );
+  printf( "#define FONT_SUBSET_CHARS \"%s\"\n\n", SUBSET_CHARS );
+
+  printf( "const uint8_t font_rows[256 * CHAR_HEIGHT] = {\n" );
+  for( int c = 0; c < 256; c++ ) printGlyph( c, c == 255 );
+  printf( "};\n\n" );
+
+  printf( "const uint8_t font_subset_slot[256] = {                                        // Glyph slot in font_subset_rows of each character\n" );
+  for( int c = 0; c < 256; c += 16 ){
+    printf( "  " );
+    for( int i = 0; i < 16; i++ ) printf( "%2d%s", subset_slot[c + i], (c + i == 255) ? "" : (i == 15) ? "," : ", " );
+    printf( "\n" );
+  }
+  printf( "};\n\n" );
+
+  printf( "const uint8_t font_subset_rows[%d * CHAR_HEIGHT] = {\n", subset_size );
+  for( uint8_t i = 0; i < subset_size; i++ ) printGlyph( (uint8_t)SUBSET_CHARS[i], i == subset_size - 1 );
+  printf( "};\n\n" );
+
+  printf( "inline const uint8_t *glyphRows( uint8_t c ){                                   // Points at the first row of a character's glyph\n" );
+  printf( "#ifdef FONT_SUBSET\n" );
+  printf( "  return &font_subset_rows[ font_subset_slot[c] * CHAR_HEIGHT ];\n" );
+  printf( "#else\n" );
+  printf( "  return &font_rows[ c * CHAR_HEIGHT ];\n" );
+  printf( "#endif\n" );
+  printf( "}\n\n" );
+  printf( "#endif\n" );
+  return 0;
+}
@@ -0,0 +1,54 @@
+#ifndef ADAFRUIT_ST7789_H
+#define ADAFRUIT_ST7789_H
+
+/*
+  ___ ___                _________        .__
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/
+
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+--- Description: ---
+Host-side stand-in for the Adafruit ST7789 driver. Instead of talking to
+a panel it records every address window and pixel word into the 240x240
+mock framebuffer (mock.h), counting the SPI traffic as it goes.
+*/
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#define ST77XX_BLACK   0x0000
+#define ST77XX_WHITE   0xFFFF
+#define ST77XX_RED     0xF800
+#define ST77XX_GREEN   0x07E0
+#define ST77XX_BLUE    0x001F
+
+class Adafruit_ST7789{
+  public:
+    Adafruit_ST7789( SPIClass *spi, int8_t cs, int8_t dc, int8_t rst ){ (void)spi; (void)cs; (void)dc; (void)rst; }
+
+    void init( uint16_t width, uint16_t height, uint8_t spiMode = SPI_MODE0 ); // Resets the mock panel
+    void setRotation( uint8_t m ){ (void)m; }                                  // The mock framebuffer is already in screen coordinates
+    void fillScreen( uint16_t color );                                         // Fills the whole panel with one color
+    void setAddrWindow( uint16_t x, uint16_t y, uint16_t w, uint16_t h );      // Opens a window and resets the write cursor to its top left
+    void SPI_WRITE16( uint16_t w ){ mock_spi_byte( w >> 8 ); mock_spi_byte( w & 0xFF ); } // Writes one pixel at the cursor
+};
+
+#endif
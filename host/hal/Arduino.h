@@ -0,0 +1,272 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+/*
+  ___ ___                _________        .__
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/
+
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+--- Description: ---
+Host-side stand-in for the DxCore Arduino core. It provides just enough
+of the Arduino API (pins, timing) for the firmware in ../source to build
+as a native Linux program. The harness controls that sit behind these
+calls (virtual clock, keypad matrix, panel framebuffer) live in mock.h.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HEXCALC_HOST 1                                                         // Lets the firmware know it is running inside the host simulation
+
+/*******************************************
+* Pin Numbers (DxCore AVR128DA28 layout)   *
+*******************************************/
+#define PIN_PA0 0
+#define PIN_PA1 1
+#define PIN_PA2 2
+#define PIN_PA3 3
+#define PIN_PA4 4
+#define PIN_PA5 5
+#define PIN_PA6 6
+#define PIN_PA7 7
+#define PIN_PC0 8
+#define PIN_PC1 9
+#define PIN_PC2 10
+#define PIN_PC3 11
+#define PIN_PD0 12
+#define PIN_PD1 13
+#define PIN_PD2 14
+#define PIN_PD3 15
+#define PIN_PD4 16
+#define PIN_PD5 17
+#define PIN_PD6 18
+#define PIN_PD7 19
+#define PIN_PF0 20
+#define PIN_PF1 21
+#define NUM_DIGITAL_PINS 22
+
+#define LOW          0
+#define HIGH         1
+#define INPUT        0
+#define OUTPUT       1
+#define INPUT_PULLUP 2
+
+/*******************************************
+* Peripheral Registers (avr/io.h)          *
+*******************************************/
+// Only the registers the firmware touches directly. Bytes written to SPI0.DATA are clocked
+// out to the mock panel just like SPI.transfer(). The mock SPI is infinitely fast, so DREIF always
+// reads as ready and nothing is ever clocked in (MISO is not connected). TXCIF is set as each byte
+// goes out and stays set until it is written with a one, like the real flag, so waiting for it
+// after clearing it without sending anything never ends: the mock aborts if it is polled clear
+// MOCK_SPI_STALL_POLLS times in a row with no byte sent in between.
+// The bytes are queued and decoded in bulk so the mock itself adds as little as possible to the
+// host time of the draw functions.
+#define SPI_BUFEN_bm 0x80                                                      // CTRLB: buffer mode enable
+#define SPI_BUFWR_bm 0x40                                                      // CTRLB: first write in buffer mode goes straight to the shift register
+#define SPI_RXCIF_bm 0x80                                                      // INTFLAGS (buffer mode): receive complete
+#define SPI_TXCIF_bm 0x40                                                      // INTFLAGS (buffer mode): transfer complete
+#define SPI_DREIF_bm 0x20                                                      // INTFLAGS (buffer mode): data register empty
+#define MOCK_SPI_QUEUE_SIZE 4096                                               // Bytes queued before the mock panel decodes them
+
+#define MOCK_SPI_STALL_POLLS 1000000                                           // Polls of a clear TXCIF that count as a hang
+#define MOCK_SPI_CHARGE_BYTES 16                                               // Bytes charged to the virtual clock at a time (see mock_spi_set_rate)
+
+extern uint8_t  mock_spi_queue[MOCK_SPI_QUEUE_SIZE];                           // Bytes clocked out but not yet decoded by the mock panel
+extern uint16_t mock_spi_queued;                                               // Number of bytes in mock_spi_queue
+extern bool     mock_spi_timed;                                                // True when SPI bytes take time on the virtual clock
+extern uint8_t  mock_spi_uncharged;                                            // Bytes sent but not yet charged to the virtual clock
+void mock_panel_flush();                                                       // Decodes everything in mock_spi_queue into the framebuffer
+void mock_spi_charge();                                                        // Advances the virtual clock by the time mock_spi_uncharged bytes take
+extern bool     mock_spi_txcif;                                                // SPI0's transfer complete flag
+uint8_t mock_spi_flags();                                                      // SPI0.INTFLAGS as read (checks for a wait on TXCIF that can't end)
+
+inline void mock_spi_byte( uint8_t data ){                                     // Clocks one byte out to the mock panel
+  mock_spi_queue[mock_spi_queued++] = data;
+  mock_spi_txcif = true;
+  if( mock_spi_queued == MOCK_SPI_QUEUE_SIZE ) mock_panel_flush();
+  if( mock_spi_timed && ++mock_spi_uncharged == MOCK_SPI_CHARGE_BYTES ) mock_spi_charge();
+}
+
+struct SPIDataRegister{
+  SPIDataRegister &operator=( uint8_t data ){ mock_spi_byte( data ); return *this; }
+  operator uint8_t() const { return 0; }
+};
+
+struct SPIFlagsRegister{
+  SPIFlagsRegister &operator=( uint8_t clear ){ if( clear & SPI_TXCIF_bm ) mock_spi_txcif = false; return *this; } // Writing ones clears flags
+  operator uint8_t() const { return mock_spi_flags(); }
+};
+
+struct SPI_t{
+  uint8_t          CTRLA;
+  uint8_t          CTRLB;
+  uint8_t          INTCTRL;
+  SPIFlagsRegister INTFLAGS;
+  SPIDataRegister  DATA;
+};
+
+extern SPI_t SPI0;
+
+// Port pin control and TCB0, for the keypad's pin-change and scan timer interrupts. Interrupt
+// flags are write-one-to-clear like the real ones. The mock raises them when a column pin changes
+// level (see mock_key_down) and as the virtual clock advances, and calls the matching ISR.
+#define PIN0_bm 0x01
+#define PIN1_bm 0x02
+#define PIN2_bm 0x04
+#define PIN3_bm 0x08
+#define PIN4_bm 0x10
+#define PIN5_bm 0x20
+#define PIN6_bm 0x40
+#define PIN7_bm 0x80
+
+#define PORT_ISC_gm            0x07                                            // PINnCTRL: input sense configuration
+#define PORT_ISC_INTDISABLE_gc 0x00                                            // No interrupt
+#define PORT_ISC_BOTHEDGES_gc  0x01                                            // Interrupt on both edges
+#define PORT_ISC_RISING_gc     0x02                                            // Interrupt on a rising edge
+#define PORT_ISC_FALLING_gc    0x03                                            // Interrupt on a falling edge
+#define PORT_ISC_LEVEL_gc      0x05                                            // Interrupt while the pin is low
+#define PORT_PULLUPEN_bm       0x08                                            // PINnCTRL: pull-up enable
+
+#define TCB_ENABLE_bm          0x01                                            // CTRLA: timer enable
+#define TCB_CLKSEL_DIV1_gc     0x00                                            // CTRLA: CLK_PER
+#define TCB_CLKSEL_DIV2_gc     0x02                                            // CTRLA: CLK_PER / 2
+#define TCB_CNTMODE_INT_gc     0x00                                            // CTRLB: periodic interrupt mode
+#define TCB_CAPT_bm            0x01                                            // INTCTRL / INTFLAGS: capture (period) interrupt
+
+#define F_CPU 24000000UL                                                       // Clock the firmware is built for
+
+struct FlagsRegister{                                                          // Interrupt flags: writing ones clears them
+  uint8_t bits;
+  FlagsRegister &operator=( uint8_t clear ){ bits &= ~clear; return *this; }
+  operator uint8_t() const { return bits; }
+};
+
+struct PORT_t{
+  FlagsRegister INTFLAGS;
+  uint8_t       PIN0CTRL, PIN1CTRL, PIN2CTRL, PIN3CTRL, PIN4CTRL, PIN5CTRL, PIN6CTRL, PIN7CTRL;
+};
+
+struct TCB_t{
+  uint8_t       CTRLA;
+  uint8_t       CTRLB;
+  uint8_t       INTCTRL;
+  FlagsRegister INTFLAGS;
+  uint16_t      CNT;
+  uint16_t      CCMP;
+};
+
+extern PORT_t PORTA, PORTC, PORTD;
+extern TCB_t  TCB0;
+
+// Virtual ports: single-cycle access to a whole port's direction, output and input bits. The
+// mock routes them through the same pin state as pinMode / digitalWrite / digitalRead.
+uint8_t mock_vport_read( uint8_t port, uint8_t reg );
+void    mock_vport_write( uint8_t port, uint8_t reg, uint8_t val );
+
+struct VPortRegister{
+  uint8_t port, reg;
+  VPortRegister &operator=( uint8_t val ){ mock_vport_write( port, reg, val ); return *this; }
+  VPortRegister &operator|=( int val ){ return *this = (uint8_t)(*this | val); }
+  VPortRegister &operator&=( int val ){ return *this = (uint8_t)(*this & val); }
+  operator uint8_t() const { return mock_vport_read( port, reg ); }
+};
+
+struct VPORT_t{
+  VPortRegister DIR, OUT, IN, INTFLAGS;
+};
+
+extern VPORT_t VPORTA, VPORTC, VPORTD;
+
+// NVMCTRL's status register, for the EEPROM. A byte takes MOCK_EEPROM_WRITE_US of the virtual
+// clock to write (erase and write together; the datasheet only gives a maximum, so this is a
+// round figure in its range) and EEBUSY stays set until then.
+#define EEPROM_SIZE       512                                                  // Bytes of EEPROM on the AVR128DA28
+#define NVMCTRL_EEBUSY_bm 0x02                                                 // STATUS: an EEPROM write is in progress
+#define MOCK_EEPROM_WRITE_US 11000
+
+uint8_t mock_nvm_status();
+
+struct NVMStatusRegister{
+  operator uint8_t() const { return mock_nvm_status(); }
+};
+
+struct NVMCTRL_t{
+  NVMStatusRegister STATUS;
+};
+
+extern NVMCTRL_t NVMCTRL;
+
+#define _NOP() ((void)0)                                                       // One cycle of nothing (the mock pins settle instantly)
+
+// Interrupt vectors become plain functions that the mock calls itself
+#define ISR(vector) extern "C" void vector()
+#define PORTA_PORT_vect mock_isr_porta
+#define PORTC_PORT_vect mock_isr_portc
+#define TCB0_INT_vect   mock_isr_tcb0
+
+/*******************************************
+* Serial Ports                             *
+*******************************************/
+// The USARTs as DxCore's HardwareSerial, minus everything the firmware doesn't call. Bytes written
+// collect in a buffer per port and bytes to read are queued by the harness (see mock_serial_* in
+// mock.h), or a port can be connected to a pty instead. A port is infinitely fast unless the
+// harness paces it (mock_serial_set_rate), so the baud rate is ignored. A paced port has buffers the
+// size of DxCore's and sends and receives a byte every 10 bit times of the virtual clock.
+#define MOCK_SERIAL_PORTS 3
+#define SERIAL_RX_BUFFER_SIZE 64                                               // (as DxCore sizes them on parts with 4K or more of RAM)
+#define SERIAL_TX_BUFFER_SIZE 64
+
+class HardwareSerial{
+  public:
+    HardwareSerial( uint8_t port ) : port( port ){}
+    void   begin( uint32_t baud ){ (void)baud; }
+    int    available();                                                        // Number of bytes waiting to be read
+    int    read();                                                             // Next byte, or -1 if there isn't one
+    int    availableForWrite();                                                // Room in the transmit buffer
+    size_t write( uint8_t c );
+    size_t print( const char *str );
+    size_t print( uint32_t val );                                              // In decimal
+    size_t println( const char *str = "" );                                    // Followed by "\r\n"
+    void   flush();                                                            // Waits for everything written to go out
+  private:
+    uint8_t port;                                                              // USART number
+};
+
+extern HardwareSerial Serial, Serial1, Serial2;                                // USART0, USART1, USART2
+
+/*******************************************
+* Arduino API                              *
+*******************************************/
+uint32_t millis();                                                             // Milliseconds on the virtual clock
+uint32_t micros();                                                             // Microseconds on the virtual clock
+void     delay( uint32_t ms );                                                 // Advances the virtual clock
+void     delayMicroseconds( uint32_t us );                                     // Advances the virtual clock
+
+void     pinMode( uint8_t pin, uint8_t mode );                                 // Records the pin direction
+void     digitalWrite( uint8_t pin, uint8_t val );                             // Drives a pin (rows of the keypad matrix, screen control lines)
+int      digitalRead( uint8_t pin );                                           // Reads a pin (columns of the keypad matrix)
+
+#endif
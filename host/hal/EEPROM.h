@@ -0,0 +1,49 @@
+#ifndef EEPROM_H
+#define EEPROM_H
+
+/*
+  ___ ___                _________        .__
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/
+
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+--- Description: ---
+--- Description: ---
+Host-side stand-in for DxCore's EEPROM library. The bytes live in
+mock_eeprom (mock.h), which the harness can inspect, wipe or corrupt.
+Like the real part, a write takes milliseconds to finish in the
+background (NVMCTRL.STATUS reads busy until then), and a write that
+finds the EEPROM busy waits for it first.
+*/
+
+#include <Arduino.h>
+
+class EEPROMClass{
+  public:
+    uint8_t  read( uint16_t idx );                                             // Byte at idx (0xFF when erased)
+    void     write( uint16_t idx, uint8_t val );                               // Starts writing a byte (after the one in progress)
+    void     update( uint16_t idx, uint8_t val ){ if( read( idx ) != val ) write( idx, val ); } // Writes only if the byte differs
+    uint16_t length(){ return EEPROM_SIZE; }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
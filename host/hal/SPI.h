@@ -0,0 +1,61 @@
+#ifndef SPI_H
+#define SPI_H
+
+/*
+  ___ ___                _________        .__
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/
+
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+--- Description: ---
+Host-side stand-in for the Arduino SPI library. Every byte clocked out
+is handed to the mock ST7789 panel (mock.h) which decodes it into the
+simulated framebuffer.
+*/
+
+#include <Arduino.h>
+
+#define MSBFIRST  1
+#define LSBFIRST  0
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+class SPISettings{
+  public:
+    SPISettings(){}
+    SPISettings( uint32_t clock, uint8_t bitOrder, uint8_t dataMode ){ (void)clock; (void)bitOrder; (void)dataMode; }
+};
+
+class SPIClass{
+  public:
+    void begin(){}
+    void end(){}
+    void beginTransaction( SPISettings settings ){ (void)settings; }
+    void endTransaction(){}
+    uint8_t  transfer( uint8_t data );                                         // Clocks one byte out to the panel
+    uint16_t transfer16( uint16_t data ){ transfer( data >> 8 ); transfer( data & 0xFF ); return 0; }
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,515 @@
+/*
+  ___ ___                _________        .__
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/
+
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+--- Description: ---
+Implementation of the host simulation: virtual clock, keypad matrix,
+and the mock ST7789 panel that the SPI / Adafruit stand-ins feed.
+*/
+
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <Arduino.h>
+#include <SPI.h>
+#include <Adafruit_ST7789.h>
+#include <EEPROM.h>
+#include "mock.h"
+
+SPIClass SPI;
+SPI_t    SPI0 = { 0, 0, 0, {}, {} };
+PORT_t   PORTA, PORTC, PORTD;
+VPORT_t  VPORTA = { {0,0}, {0,1}, {0,2}, {0,3} };
+VPORT_t  VPORTC = { {2,0}, {2,1}, {2,2}, {2,3} };
+VPORT_t  VPORTD = { {3,0}, {3,1}, {3,2}, {3,3} };
+TCB_t    TCB0;
+NVMCTRL_t NVMCTRL;
+
+extern "C" void mock_isr_porta() __attribute__((weak));                        // Defined by the firmware when it uses them
+extern "C" void mock_isr_portc() __attribute__((weak));
+extern "C" void mock_isr_tcb0()  __attribute__((weak));
+
+static void dispatchInterrupts();
+static void tickTimers( uint64_t us );
+
+/*******************************************
+* Virtual Clock                            *
+*******************************************/
+static uint64_t clock_us = 0;                                                  // Current virtual time in microseconds
+static bool     clock_realtime = false;                                        // Follow the host clock instead of the virtual clock
+static uint64_t clock_epoch_ns = 0;                                            // Host time at which realtime mode was enabled
+
+uint64_t mock_host_ns(){
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint64_t now_us(){
+  if( clock_realtime ) return clock_us + (mock_host_ns() - clock_epoch_ns) / 1000;
+  return clock_us;
+}
+
+void mock_clock_advance_us( uint32_t us ){ tickTimers( us ); }
+void mock_clock_set_realtime( bool realtime ){
+  if( realtime == clock_realtime ) return;
+  clock_us = now_us();                                                         // Freeze whatever time has elapsed so far
+  clock_epoch_ns = mock_host_ns();
+  clock_realtime = realtime;
+}
+
+uint32_t millis(){ return (uint32_t)(now_us() / 1000); }
+uint32_t micros(){ return (uint32_t)now_us(); }
+void delay( uint32_t ms ){ if( !clock_realtime ) tickTimers( (uint64_t)ms * 1000 ); }
+void delayMicroseconds( uint32_t us ){ if( !clock_realtime ) tickTimers( us ); }
+
+static void (*clock_hook)( uint64_t now_us ) = NULL;
+void mock_clock_set_hook( void (*hook)( uint64_t now_us ) ){ clock_hook = hook; }
+
+static void tickTimers( uint64_t us ){                                         // Advances the virtual clock, firing TCB0 periods along the way (not in realtime mode)
+  while( us ){
+    uint64_t step = us;
+    if( clock_hook && step > MOCK_CLOCK_HOOK_US ) step = MOCK_CLOCK_HOOK_US;
+    bool running = (TCB0.CTRLA & TCB_ENABLE_bm) && !clock_realtime;
+    uint32_t ticks_per_us = (F_CPU / 1000000) >> ((TCB0.CTRLA & TCB_CLKSEL_DIV2_gc) ? 1 : 0);
+    if( running ){                                                             // Stop at the next period so the ISR sees the clock where it should be
+      uint32_t left = ((uint32_t)TCB0.CCMP + 1 - TCB0.CNT + ticks_per_us - 1) / ticks_per_us;
+      if( left == 0 ) left = 1;
+      if( left < step ) step = left;
+    }
+    clock_us += step;
+    us -= step;
+    if( clock_hook ) clock_hook( clock_us );
+    if( !running ) continue;
+    uint32_t cnt = TCB0.CNT + step * ticks_per_us;
+    if( cnt > TCB0.CCMP ){
+      TCB0.CNT = 0;
+      TCB0.INTFLAGS.bits |= TCB_CAPT_bm;
+      dispatchInterrupts();
+    } else {
+      TCB0.CNT = cnt;
+    }
+  }
+}
+
+/*******************************************
+* Pins & Keypad Matrix                     *
+*******************************************/
+static uint8_t pin_mode[NUM_DIGITAL_PINS];                                     // Direction of every pin
+static uint8_t pin_out[NUM_DIGITAL_PINS];                                      // Level driven on every output pin
+static bool    key_closed[35];                                                 // Switch state at row * 5 + col
+
+static const uint8_t row_pins[7] = { PIN_PD0, PIN_PD1, PIN_PD2, PIN_PD3, PIN_PD4, PIN_PD5, PIN_PD6 };
+static const uint8_t col_pins[5] = { PIN_PA7, PIN_PC0, PIN_PC1, PIN_PC2, PIN_PC3 };
+
+static bool col_level[5] = { true, true, true, true, true };                  // Last level seen on each column (for edge detection)
+static bool in_isr = false;                                                    // Interrupts don't nest
+
+static int columnLevel( uint8_t col ){
+  for( uint8_t row = 0; row < 7; row++ ){                                      // A column reads low when a closed switch connects it to a row driven low
+    if( pin_mode[row_pins[row]] == OUTPUT && pin_out[row_pins[row]] == LOW && key_closed[row * 5 + col] ) return LOW;
+  }
+  return HIGH;                                                                 // Otherwise the pull-up wins
+}
+
+static uint8_t &columnCtrl( uint8_t col ){ return col == 0 ? PORTA.PIN7CTRL : (&PORTC.PIN0CTRL)[col - 1]; }
+static PORT_t  &columnPort( uint8_t col ){ return col == 0 ? PORTA : PORTC; }
+static uint8_t  columnMask( uint8_t col ){ return col == 0 ? PIN7_bm : (uint8_t)(PIN0_bm << (col - 1)); }
+
+static uint8_t enabledPins( PORT_t &port ){                                    // Pins of a port whose interrupt sense is switched on
+  uint8_t mask = 0;
+  const uint8_t *ctrl = &port.PIN0CTRL;
+  for( uint8_t pin = 0; pin < 8; pin++ ) if( (ctrl[pin] & PORT_ISC_gm) != PORT_ISC_INTDISABLE_gc ) mask |= 1 << pin;
+  return mask;
+}
+
+static void updateColumns(){                                                   // Raises port interrupt flags for column edges and runs the ISRs
+  for( uint8_t col = 0; col < 5; col++ ){
+    bool level = columnLevel( col );
+    bool prev  = col_level[col];
+    col_level[col] = level;
+    bool fire;
+    switch( columnCtrl( col ) & PORT_ISC_gm ){
+      case PORT_ISC_BOTHEDGES_gc: fire = level != prev;      break;
+      case PORT_ISC_RISING_gc:    fire = level && !prev;     break;
+      case PORT_ISC_FALLING_gc:   fire = !level && prev;     break;
+      case PORT_ISC_LEVEL_gc:     fire = !level;             break;
+      default:                    fire = false;              break;
+    }
+    if( fire ) columnPort( col ).INTFLAGS.bits |= columnMask( col );
+  }
+  dispatchInterrupts();
+}
+
+static void dispatchInterrupts(){                                              // Runs every ISR whose flag is up until they are all handled
+  if( in_isr ) return;
+  in_isr = true;
+  for( int guard = 0; guard < 64; guard++ ){                                   // (an ISR that never clears its flag would otherwise spin forever)
+    if( (PORTA.INTFLAGS & enabledPins( PORTA )) && mock_isr_porta ){ mock_isr_porta(); continue; }
+    if( (PORTC.INTFLAGS & enabledPins( PORTC )) && mock_isr_portc ){ mock_isr_portc(); continue; }
+    if( (TCB0.INTFLAGS & TCB0.INTCTRL & TCB_CAPT_bm) && mock_isr_tcb0 ){ mock_isr_tcb0(); continue; }
+    break;
+  }
+  in_isr = false;
+}
+
+void pinMode( uint8_t pin, uint8_t mode ){ if( pin < NUM_DIGITAL_PINS ){ pin_mode[pin] = mode; updateColumns(); } }
+void digitalWrite( uint8_t pin, uint8_t val ){ if( pin < NUM_DIGITAL_PINS ){ pin_out[pin] = val ? HIGH : LOW; updateColumns(); } }
+
+int digitalRead( uint8_t pin ){
+  for( uint8_t col = 0; col < 5; col++ ) if( col_pins[col] == pin ) return columnLevel( col );
+  return pin < NUM_DIGITAL_PINS ? pin_out[pin] : LOW;
+}
+
+static const uint8_t port_first_pin[4] = { PIN_PA0, 0xFF, PIN_PC0, PIN_PD0 };    // Arduino pin of bit 0 of ports A-D (the DA28 has no port B)
+static const uint8_t port_num_pins[4]  = { 8, 0, 4, 8 };
+
+uint8_t mock_vport_read( uint8_t port, uint8_t reg ){                          // reg: 0 = DIR, 1 = OUT, 2 = IN, 3 = INTFLAGS
+  if( reg == 3 ) return port == 0 ? PORTA.INTFLAGS : port == 2 ? PORTC.INTFLAGS : PORTD.INTFLAGS;
+  uint8_t val = 0;
+  for( uint8_t bit = 0; bit < port_num_pins[port]; bit++ ){
+    uint8_t pin = port_first_pin[port] + bit;
+    bool set = reg == 0 ? pin_mode[pin] == OUTPUT : reg == 1 ? pin_out[pin] == HIGH : digitalRead( pin ) == HIGH;
+    if( set ) val |= 1 << bit;
+  }
+  return val;
+}
+
+void mock_vport_write( uint8_t port, uint8_t reg, uint8_t val ){
+  if( reg == 3 ){ (port == 0 ? PORTA : port == 2 ? PORTC : PORTD).INTFLAGS = val; return; }
+  if( reg == 2 ) return;                                                       // (writing IN toggles OUT on the real part, nothing here uses that)
+  for( uint8_t bit = 0; bit < port_num_pins[port]; bit++ ){
+    uint8_t pin = port_first_pin[port] + bit;
+    bool set = val & (1 << bit);
+    if( reg == 0 ){ if( set ) pin_mode[pin] = OUTPUT; else if( pin_mode[pin] == OUTPUT ) pin_mode[pin] = INPUT; }
+    else pin_out[pin] = set ? HIGH : LOW;
+  }
+  updateColumns();
+}
+
+void mock_key_down( uint8_t button_index ){ if( button_index < 35 ){ key_closed[button_index] = true;  updateColumns(); } }
+void mock_key_up( uint8_t button_index ){   if( button_index < 35 ){ key_closed[button_index] = false; updateColumns(); } }
+void mock_key_release_all(){ memset( key_closed, 0, sizeof(key_closed) ); updateColumns(); }
+
+/*******************************************
+* Mock Panel                               *
+*******************************************/
+uint16_t       mock_framebuffer[MOCK_PANEL_WIDTH * MOCK_PANEL_HEIGHT];
+MockPanelStats mock_panel;
+
+static uint16_t win_x0, win_y0, win_x1, win_y1;                                // Current address window (inclusive)
+static uint16_t cur_x, cur_y;                                                  // Write cursor inside the window
+static int16_t  pending_byte = -1;                                             // First half of a pixel clocked in through SPI.transfer
+uint8_t        mock_spi_queue[MOCK_SPI_QUEUE_SIZE];
+uint16_t       mock_spi_queued = 0;
+bool           mock_spi_timed = false;
+bool           mock_spi_txcif = false;
+static uint32_t spi_stalled_polls = 0;                                         // Polls of a clear TXCIF since the last byte went out
+uint8_t        mock_spi_uncharged = 0;
+static uint32_t spi_rate_hz = 0;                                               // SPI clock charged to the virtual clock (0 = free)
+static uint64_t spi_charge_ns = 0;                                             // Fraction of a microsecond not yet charged
+
+uint8_t mock_spi_flags(){
+  if( mock_spi_txcif ) spi_stalled_polls = 0;
+  else if( ++spi_stalled_polls == MOCK_SPI_STALL_POLLS ){
+    fprintf( stderr, "mock SPI: TXCIF polled %u times with nothing sent since it was cleared (the firmware would hang here)\n", MOCK_SPI_STALL_POLLS );
+    abort();
+  }
+  return (mock_spi_txcif ? SPI_TXCIF_bm : 0) | SPI_DREIF_bm;
+}
+
+void mock_spi_set_rate( uint32_t hz ){ spi_rate_hz = hz; mock_spi_timed = hz != 0; mock_spi_uncharged = 0; }
+
+void mock_spi_charge(){
+  spi_charge_ns += (uint64_t)mock_spi_uncharged * 8 * 1000000000ull / spi_rate_hz;
+  mock_spi_uncharged = 0;
+  if( spi_charge_ns >= 1000 ){
+    uint32_t us = spi_charge_ns / 1000;
+    spi_charge_ns -= (uint64_t)us * 1000;
+    mock_clock_advance_us( us );
+  }
+}
+
+static void mock_panel_write16( uint16_t w );
+
+void mock_panel_reset_stats(){ mock_panel_flush(); memset( &mock_panel, 0, sizeof(mock_panel) ); }
+
+static bool    panel_decode = true;                                           // Decode queued bytes into the framebuffer
+
+void mock_panel_set_decode( bool decode ){ mock_panel_flush(); panel_decode = decode; }
+
+void mock_panel_flush(){
+  if( !panel_decode ){                                                         // Just count the traffic
+    mock_panel.spi_words += mock_spi_queued / 2;
+    mock_panel.spi_bytes += mock_spi_queued;
+    mock_spi_queued = 0;
+    return;
+  }
+  for( uint16_t i = 0; i < mock_spi_queued; i++ ){
+    if( pending_byte < 0 ){ pending_byte = mock_spi_queue[i]; continue; }      // Pixels arrive high byte first
+    mock_panel_write16( ((uint16_t)pending_byte << 8) | mock_spi_queue[i] );
+    pending_byte = -1;
+  }
+  mock_spi_queued = 0;
+}
+
+void mock_panel_window( uint16_t x, uint16_t y, uint16_t w, uint16_t h ){
+  mock_panel_flush();                                                          // Everything queued so far belongs to the previous window
+  if( mock_spi_timed ){ mock_spi_uncharged += MOCK_ADDR_WINDOW_BYTES; mock_spi_charge(); }
+  mock_spi_txcif = true;                                                       // (the window's command bytes went out)
+  win_x0 = x; win_y0 = y;
+  win_x1 = w ? x + w - 1 : x;
+  win_y1 = h ? y + h - 1 : y;
+  cur_x = win_x0; cur_y = win_y0;
+  pending_byte = -1;
+  mock_panel.addr_windows++;
+  mock_panel.spi_bytes += MOCK_ADDR_WINDOW_BYTES;
+}
+
+static void mock_panel_write16( uint16_t w ){
+  if( cur_x < MOCK_PANEL_WIDTH && cur_y < MOCK_PANEL_HEIGHT ) mock_framebuffer[cur_y * MOCK_PANEL_WIDTH + cur_x] = w;
+  mock_panel.spi_words++;
+  mock_panel.spi_bytes += 2;
+  if( cur_x++ == win_x1 ){                                                     // Like the real controller, wrap to the next row of the
+    cur_x = win_x0;                                                            // window and back to the top once the window is full
+    if( cur_y++ == win_y1 ) cur_y = win_y0;
+  }
+}
+
+/*******************************************
+* EEPROM                                   *
+*******************************************/
+EEPROMClass EEPROM;
+uint8_t     mock_eeprom[EEPROM_SIZE];
+uint32_t    mock_eeprom_writes[EEPROM_SIZE];
+static bool     eeprom_erased = false;                                         // mock_eeprom has been initialised
+static uint64_t eeprom_busy_until = 0;                                         // Virtual time the write in progress finishes
+
+void mock_eeprom_erase(){
+  memset( mock_eeprom, 0xFF, sizeof(mock_eeprom) );
+  memset( mock_eeprom_writes, 0, sizeof(mock_eeprom_writes) );
+  eeprom_busy_until = 0;
+  eeprom_erased = true;
+}
+
+uint8_t mock_nvm_status(){ return now_us() < eeprom_busy_until ? NVMCTRL_EEBUSY_bm : 0; }
+
+uint8_t EEPROMClass::read( uint16_t idx ){
+  if( !eeprom_erased ) mock_eeprom_erase();
+  return idx < EEPROM_SIZE ? mock_eeprom[idx] : 0xFF;
+}
+
+void EEPROMClass::write( uint16_t idx, uint8_t val ){
+  if( !eeprom_erased ) mock_eeprom_erase();
+  if( idx >= EEPROM_SIZE ) return;
+  uint64_t now = now_us();
+  if( now < eeprom_busy_until ) tickTimers( eeprom_busy_until - now );         // Wait for the last write, as DxCore's does
+  mock_eeprom[idx] = val;                                                      // (it lands at once; the harness only sees it between calls anyway)
+  mock_eeprom_writes[idx]++;
+  eeprom_busy_until = now_us() + MOCK_EEPROM_WRITE_US;
+}
+
+uint32_t mock_framebuffer_hash(){
+  mock_panel_flush();
+  uint32_t hash = 2166136261u;
+  for( uint32_t i = 0; i < MOCK_PANEL_WIDTH * MOCK_PANEL_HEIGHT; i++ ){
+    hash = (hash ^ (mock_framebuffer[i] & 0xFF)) * 16777619u;
+    hash = (hash ^ (mock_framebuffer[i] >> 8))   * 16777619u;
+  }
+  return hash;
+}
+
+bool mock_framebuffer_write_ppm( const char *path ){
+  mock_panel_flush();
+  FILE *f = fopen( path, "wb" );
+  if( !f ) return false;
+  fprintf( f, "P6\n%d %d\n255\n", MOCK_PANEL_WIDTH, MOCK_PANEL_HEIGHT );
+  for( uint32_t i = 0; i < MOCK_PANEL_WIDTH * MOCK_PANEL_HEIGHT; i++ ){
+    uint16_t c = mock_framebuffer[i];
+    uint8_t rgb[3] = { (uint8_t)((c >> 8) & 0xF8), (uint8_t)((c >> 3) & 0xFC), (uint8_t)((c << 3) & 0xF8) };
+    fwrite( rgb, 1, 3, f );
+  }
+  fclose( f );
+  return true;
+}
+
+uint8_t SPIClass::transfer( uint8_t data ){ mock_spi_byte( data ); return 0; }
+
+/*******************************************
+* Serial Ports                             *
+*******************************************/
+HardwareSerial Serial( 0 ), Serial1( 1 ), Serial2( 2 );
+
+struct MockSerialPort{
+  char     in[MOCK_SERIAL_BUFFER];                                             // Bytes queued by the harness (or read from the pty)
+  uint32_t in_head, in_tail;
+  char     out[MOCK_SERIAL_BUFFER];                                            // Bytes written by the firmware (and not yet sent to the pty)
+  uint32_t out_length;
+  int      pty = -1;                                                           // Master side of the port's pty, if it has one
+
+  uint64_t byte_ns;                                                            // Time a byte takes on the wire (0 if the port isn't paced)
+  char     rx[SERIAL_RX_BUFFER_SIZE];                                          // Bytes that have arrived (a paced port reads from here, in holds what is still to be sent)
+  uint32_t rx_head, rx_tail;
+  uint64_t rx_next_ns;                                                         // When the next byte of in finishes arriving
+  bool     paused;                                                             // The firmware has sent XOFF
+  uint32_t overruns;
+  uint64_t tx_done_ns;                                                         // When the transmit buffer will be empty
+};
+static MockSerialPort serial_ports[MOCK_SERIAL_PORTS];
+
+#define MOCK_XON  0x11
+#define MOCK_XOFF 0x13
+
+void mock_serial_set_rate( uint8_t port, uint32_t baud ){
+  MockSerialPort &p = serial_ports[port];
+  p.byte_ns = baud ? 10000000000ull / baud : 0;                                // Start bit, 8 data bits, stop bit
+  p.rx_next_ns = now_us() * 1000 + p.byte_ns;
+  p.tx_done_ns = 0;
+  p.paused = false;
+}
+uint32_t mock_serial_overruns( uint8_t port ){ return serial_ports[port].overruns; }
+
+static void serialArrive( MockSerialPort &p ){                                 // Moves the bytes that have finished arriving into the receive buffer
+  uint64_t now = now_us() * 1000;
+  while( p.in_head != p.in_tail && !p.paused && p.rx_next_ns <= now ){
+    char c = p.in[p.in_tail++ % MOCK_SERIAL_BUFFER];
+    if( p.rx_head - p.rx_tail < SERIAL_RX_BUFFER_SIZE ) p.rx[p.rx_head++ % SERIAL_RX_BUFFER_SIZE] = c;
+    else p.overruns++;
+    p.rx_next_ns += p.byte_ns;
+  }
+  if( (p.in_head == p.in_tail || p.paused) && p.rx_next_ns < now + p.byte_ns ) p.rx_next_ns = now + p.byte_ns; // The line is idle: the next byte starts now at the earliest
+}
+
+static uint32_t serialSending( MockSerialPort &p ){                            // Bytes still in a paced port's transmit buffer
+  uint64_t now = now_us() * 1000;
+  return p.tx_done_ns > now ? (p.tx_done_ns - now + p.byte_ns - 1) / p.byte_ns : 0;
+}
+
+const char *mock_serial_open_pty( uint8_t port ){
+  MockSerialPort &p = serial_ports[port];
+  int fd = posix_openpt( O_RDWR | O_NOCTTY | O_NONBLOCK );
+  if( fd < 0 ) return NULL;
+  struct termios tio;
+  if( grantpt( fd ) || unlockpt( fd ) || tcgetattr( fd, &tio ) ){ close( fd ); return NULL; }
+  cfmakeraw( &tio );                                                           // Bytes through as they are: no echo, no line editing, no CR/LF translation
+  tcsetattr( fd, TCSANOW, &tio );
+  p.pty = fd;
+  return ptsname( fd );
+}
+
+static void serialFlush( MockSerialPort &p ){                                  // Sends the written bytes down the pty
+  uint32_t sent = 0;
+  while( sent < p.out_length ){
+    ssize_t n = write( p.pty, p.out + sent, p.out_length - sent );
+    if( n > 0 ){ sent += n; continue; }
+    if( n < 0 && errno != EAGAIN ) break;                                      // Nobody has the other end open: the bytes are gone, like on a real UART
+    struct pollfd pfd = { p.pty, POLLOUT, 0 };
+    if( poll( &pfd, 1, 100 ) <= 0 ) break;                                     // (or nobody is reading it)
+  }
+  p.out_length = 0;
+}
+
+static void serialFill( MockSerialPort &p ){                                   // Pulls whatever the pty has into the input queue
+  char buffer[256];
+  uint32_t room = MOCK_SERIAL_BUFFER - (p.in_head - p.in_tail);
+  ssize_t n = read( p.pty, buffer, room < sizeof(buffer) ? room : sizeof(buffer) );
+  for( ssize_t i = 0; i < n; i++ ) p.in[p.in_head++ % MOCK_SERIAL_BUFFER] = buffer[i];
+}
+
+void mock_serial_input( uint8_t port, const char *text ){
+  MockSerialPort &p = serial_ports[port];
+  if( p.byte_ns ) serialArrive( p );                                           // (so an idle line starts timing from now)
+  for( ; *text && p.in_head - p.in_tail < MOCK_SERIAL_BUFFER; text++ ) p.in[p.in_head++ % MOCK_SERIAL_BUFFER] = *text;
+}
+size_t mock_serial_output( uint8_t port, char *buffer, size_t size ){
+  MockSerialPort &p = serial_ports[port];
+  size_t n = p.out_length < size - 1 ? p.out_length : size - 1;
+  memcpy( buffer, p.out, n );
+  buffer[n] = 0;
+  p.out_length = 0;
+  return n;
+}
+
+int HardwareSerial::available(){
+  MockSerialPort &p = serial_ports[port];
+  if( p.byte_ns ){ serialArrive( p ); return p.rx_head - p.rx_tail; }
+  if( p.pty >= 0 && p.in_head == p.in_tail ) serialFill( p );
+  return p.in_head - p.in_tail;
+}
+int HardwareSerial::read(){
+  MockSerialPort &p = serial_ports[port];
+  if( p.byte_ns ){
+    serialArrive( p );
+    if( p.rx_head == p.rx_tail ) return -1;
+    return (uint8_t)p.rx[p.rx_tail++ % SERIAL_RX_BUFFER_SIZE];
+  }
+  if( p.in_head == p.in_tail ) return -1;
+  return (uint8_t)p.in[p.in_tail++ % MOCK_SERIAL_BUFFER];
+}
+int HardwareSerial::availableForWrite(){
+  MockSerialPort &p = serial_ports[port];
+  if( p.byte_ns ) return SERIAL_TX_BUFFER_SIZE - serialSending( p );
+  return MOCK_SERIAL_BUFFER - p.out_length < SERIAL_TX_BUFFER_SIZE ? MOCK_SERIAL_BUFFER - p.out_length : SERIAL_TX_BUFFER_SIZE;
+}
+size_t HardwareSerial::write( uint8_t c ){
+  MockSerialPort &p = serial_ports[port];
+  if( p.byte_ns ){
+    if( serialSending( p ) >= SERIAL_TX_BUFFER_SIZE ){                         // Wait for room, like the real write() does
+      uint64_t room_ns = p.tx_done_ns - (SERIAL_TX_BUFFER_SIZE - 1) * p.byte_ns;
+      tickTimers( (room_ns + 999) / 1000 - now_us() );
+    }
+    uint64_t now = now_us() * 1000;
+    p.tx_done_ns = (p.tx_done_ns > now ? p.tx_done_ns : now) + p.byte_ns;
+    if( c == MOCK_XOFF ) p.paused = true;                                      // (the sender is taken to hear it straight away)
+    if( c == MOCK_XON && p.paused ){ p.paused = false; serialArrive( p ); }
+  }
+  if( p.out_length == MOCK_SERIAL_BUFFER ) return 0;
+  p.out[p.out_length++] = c;
+  if( p.pty >= 0 && (c == '\n' || p.out_length == MOCK_SERIAL_BUFFER) ) serialFlush( p ); // A line at a time
+  return 1;
+}
+size_t HardwareSerial::print( const char *str ){ size_t n = 0; while( *str ) n += write( *str++ ); return n; }
+size_t HardwareSerial::print( uint32_t val ){ char text[11]; snprintf( text, sizeof(text), "%u", val ); return print( text ); }
+size_t HardwareSerial::println( const char *str ){ return print( str ) + print( "\r\n" ); }
+void   HardwareSerial::flush(){ if( serial_ports[port].pty >= 0 ) serialFlush( serial_ports[port] ); }
+
+static uint16_t power_on_fill = 0;                                             // What init() leaves in the framebuffer
+
+void mock_panel_set_power_on_fill( uint16_t color ){ power_on_fill = color; }
+
+void Adafruit_ST7789::init( uint16_t width, uint16_t height, uint8_t spiMode ){
+  (void)width; (void)height; (void)spiMode;
+  mock_panel_reset_stats();
+  for( uint32_t i = 0; i < MOCK_PANEL_WIDTH * MOCK_PANEL_HEIGHT; i++ ) mock_framebuffer[i] = power_on_fill;
+}
+
+void Adafruit_ST7789::fillScreen( uint16_t color ){
+  mock_panel_window( 0, 0, MOCK_PANEL_WIDTH, MOCK_PANEL_HEIGHT );
+  for( uint32_t i = 0; i < MOCK_PANEL_WIDTH * MOCK_PANEL_HEIGHT; i++ ) SPI_WRITE16( color );
+}
+
+void Adafruit_ST7789::setAddrWindow( uint16_t x, uint16_t y, uint16_t w, uint16_t h ){ mock_panel_window( x, y, w, h ); }
+
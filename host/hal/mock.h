@@ -0,0 +1,98 @@
+#ifndef MOCK_H
+#define MOCK_H
+
+/*
+  ___ ___                _________        .__
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/
+
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+--- Description: ---
+Harness-side controls for the host simulation. The firmware never sees
+these; they let a test program drive the virtual clock, press keys on
+the simulated keypad matrix and inspect what reached the mock panel.
+*/
+
+#include <Arduino.h>
+
+/*******************************************
+* Mock Panel                               *
+*******************************************/
+#define MOCK_PANEL_WIDTH  240                                                  // Width of the simulated ST7789 framebuffer
+#define MOCK_PANEL_HEIGHT 240                                                  // Height of the simulated ST7789 framebuffer
+#define MOCK_ADDR_WINDOW_BYTES 11                                              // CASET + RASET + RAMWR commands and their 8 parameter bytes
+
+struct MockPanelStats{
+  uint32_t spi_words;                                                          // Number of 16-bit pixel words pushed to the panel
+  uint32_t spi_bytes;                                                          // Total bytes on the wire (pixels plus address window commands)
+  uint32_t addr_windows;                                                       // Number of setAddrWindow calls
+};
+
+extern uint16_t       mock_framebuffer[MOCK_PANEL_WIDTH * MOCK_PANEL_HEIGHT];  // The simulated panel memory (RGB565)
+extern MockPanelStats mock_panel;                                              // Running SPI traffic counters
+
+void     mock_panel_reset_stats();                                             // Zeroes the SPI traffic counters
+void     mock_panel_window( uint16_t x, uint16_t y, uint16_t w, uint16_t h );  // Opens an address window
+                                                                               // (call mock_panel_flush() before reading mock_panel or the framebuffer)
+void     mock_panel_set_decode( bool decode );                                 // With decoding off, traffic is counted but pixels are not stored (cheaper for timing)
+uint32_t mock_framebuffer_hash();                                              // FNV-1a hash of the framebuffer (for pixel-identical comparisons)
+bool     mock_framebuffer_write_ppm( const char *path );                       // Dumps the framebuffer as a binary PPM image
+void     mock_panel_set_power_on_fill( uint16_t color );                       // What init() leaves in the framebuffer (0 by default; the real panel powers up with noise)
+
+/*******************************************
+* Virtual Clock                            *
+*******************************************/
+void     mock_clock_advance_us( uint32_t us );                                 // Moves the virtual clock forward
+void     mock_clock_set_realtime( bool realtime );                             // Follow the host's monotonic clock instead of the virtual one
+uint64_t mock_host_ns();                                                       // Host monotonic time in ns (for measuring host cost)
+void     mock_clock_set_hook( void (*hook)( uint64_t now_us ) );               // Called every MOCK_CLOCK_HOOK_US or less as the virtual clock moves (NULL to remove)
+void     mock_spi_set_rate( uint32_t hz );                                     // Charges SPI bytes to the virtual clock at hz bits per second (0, the default, makes them free)
+#define  MOCK_CLOCK_HOOK_US 50
+
+/*******************************************
+* Serial Ports                             *
+*******************************************/
+#define MOCK_SERIAL_BUFFER 8192                                                // Bytes each direction of a port holds (more are dropped)
+
+void     mock_serial_input( uint8_t port, const char *text );                  // Queues text for the firmware to read from Serial<port>
+size_t   mock_serial_output( uint8_t port, char *buffer, size_t size );        // Takes everything the firmware wrote to Serial<port> (NUL terminated)
+const char *mock_serial_open_pty( uint8_t port );                              // Connects Serial<port> to a new pty and returns the path of its other end (NULL if that failed)
+void     mock_serial_set_rate( uint8_t port, uint32_t baud );                  // Paces Serial<port> at baud on the virtual clock (0, the default, makes it infinitely fast).
+                                                                               // Queued input then arrives a byte at a time into a SERIAL_RX_BUFFER_SIZE buffer, the
+                                                                               // sender stops while the firmware has sent XOFF, and writes wait for the transmit buffer.
+uint32_t mock_serial_overruns( uint8_t port );                                 // Bytes a paced port has dropped because its receive buffer was full
+
+/*******************************************
+* EEPROM                                   *
+*******************************************/
+extern uint8_t  mock_eeprom[EEPROM_SIZE];                                      // The EEPROM's contents (starts out erased)
+extern uint32_t mock_eeprom_writes[EEPROM_SIZE];                               // Writes each byte has taken (for wear)
+
+void     mock_eeprom_erase();                                                  // Sets every byte back to 0xFF and zeroes the write counts
+
+/*******************************************
+* Keypad Matrix                            *
+*******************************************/
+void     mock_key_down( uint8_t button_index );                                // Closes the switch at row * 5 + col
+void     mock_key_up( uint8_t button_index );                                  // Opens the switch at row * 5 + col
+void     mock_key_release_all();                                               // Opens every switch
+
+#endif
@@ -0,0 +1,80 @@
+/*
+  ___ ___                _________        .__
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/
+
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+--- Description: ---
+Runs the host build of the firmware with its serial port (Serial2, the
+one remote.h listens on) connected to a pty, so a test rig can drive the
+calculator over a "serial port" without the hardware. It prints the path
+of the pty and then runs loop() until it is stopped, with the virtual
+clock following the host's. Talk to it with any terminal program, or
+open the path from a script and send lines like "b10 v1234 ?".
+
+Usage: remote [--screen file.ppm]
+  --screen file.ppm  Rewrite file.ppm with the panel's contents after every frame
+*/
+
+#include <time.h>
+#include <Arduino.h>
+#include "mock.h"
+
+#ifndef HEXCALC_REMOTE
+#define HEXCALC_REMOTE 1                                                       // (the point of this program)
+#endif
+
+#include "HexCalc.ino"
+
+#define REMOTE_IDLE_US 1000                                                    // Sleep between passes while the port has nothing for the firmware
+
+int main( int argc, char **argv ){
+  const char *screen_path = NULL;
+  for( int i = 1; i < argc; i++ ){
+    if( !strcmp( argv[i], "--screen" ) && i + 1 < argc ) screen_path = argv[++i];
+    else { fprintf( stderr, "usage: %s [--screen file.ppm]\n", argv[0] ); return 2; }
+  }
+
+  setup();
+  const char *path = mock_serial_open_pty( 2 );                                // REMOTE_SERIAL is Serial2
+  if( !path ){ perror( "pty" ); return 1; }
+  printf( "%s\n", path );
+  fflush( stdout );
+
+  uint64_t host_us = mock_host_ns() / 1000;
+  uint32_t words = 0;
+  for( ;; ){
+    loop();
+    uint64_t now = mock_host_ns() / 1000;                                      // Virtual time keeps up with the host's, timers and all
+    mock_clock_advance_us( now - host_us );
+    host_us = now;
+
+    mock_panel_flush();
+    if( screen_path && !screen_dirty && mock_panel.spi_words != words ){       // A frame finished
+      words = mock_panel.spi_words;
+      if( !mock_framebuffer_write_ppm( screen_path ) ) fprintf( stderr, "could not write %s\n", screen_path );
+    }
+    if( !REMOTE_SERIAL.available() ){
+      struct timespec idle = { 0, REMOTE_IDLE_US * 1000 };
+      nanosleep( &idle, NULL );
+    }
+  }
+}
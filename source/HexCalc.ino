@@ -1,7 +1,17 @@
 #include "hardware.h"
 #include "calculator.h"
+#include "remote.h"
+#include "persist.h"
 #include <Adafruit_ST7789.h> // Hardware-specific library for ST7789
-#include "font.h"
+#include "format.h"
+#include "font_rows.h"                                                         // Generated from font.h by host/fontgen.cpp
+
+#ifndef HEXCALC_ASSETS
+#define HEXCALC_ASSETS 1                                                       // Blit the tags and labels from assets.h (0 rasterizes them from the font every time)
+#endif
+#if HEXCALC_ASSETS
+#include "assets.h"                                                            // Generated from the draw functions below by host/assetgen.cpp
+#endif
 
 
 /*
@@ -69,19 +79,6 @@ Adafruit_ST7789 screen(&SPI, -1, PIN_SCREEN_DC, PIN_SCREEN_RESET);             /
 
 uint16_t base_color = COLOR_COL_FG;                                            // Stores the currently selected foreground color
 
-/*******************************************
-* Temporary Variables                      *
-*******************************************/
-
-uint64_t old_val        = 0xFFFFFFFFFFFFFFFF;                                  // These variables track the state of the finite state
-uint64_t old_stored     = 0xFFFFFFFFFFFFFFFF;                                  // machine prior to pressing a button. This allows us
-uint8_t  old_op         = 0xFF;                                                // to render only portions of the screen after each key press.
-uint8_t  old_base       = 0xFF;                                                // A better way to do this would be to move this into the calculator.h
-uint8_t  old_color_mode = 0xFF;                                                // file and just add flags for everything that might have changed
-uint8_t  old_bit_depth  = 0xFF;                                                // Maybe I will do that later ### TO DO ###
-
-
-
 /*******************************************
 * Key Press Event Manager                  *
 *******************************************/
@@ -90,21 +87,121 @@ uint8_t  old_bit_depth  = 0xFF;                                                /
 #define MENU_DEC    1                                                          // Decimal Menu
 #define MENU_COLOR  2                                                          // Color Selector Menu
 volatile uint8_t menu_mode = 0;                                                // Tracks which mode the menu is in (BINARY / DEC / COLOR)
-volatile uint8_t old_menu_mode = 0xFF;                                         // Tracks the old menu mode to identify changes in the mode between refreshes
+
+bool renderScreen( bool interruptible = true );                                // Prototype for the render function below (the Arduino IDE generates these, the host build needs it spelled out)
+bool screen_dirty = false;                                                     // Set when a key may have changed what is on the screen, cleared once a frame gets all the way through
+bool draw_abortable = false;                                                   // True while renderScreen draws widgets (the draw functions may then stop early for newer input)
+bool draw_aborted = false;                                                     // Set by a draw function that stopped part way for newer input (only ever set while draw_abortable)
+bool draw_delta = false;                                                       // True while the widget being drawn still shows the last frame's state (it may then repaint just what changed)
 
 uint32_t screen_shutoff_time = 0;                                              // The time that the screen should shut off
 #define SCREEN_SHUTOFF_DELAY 30000                                             // Make the screen shutoff time 30 seconds
 
+/*******************************************
+* State Persistence                        *
+*******************************************/
+// What persist.h keeps: the calculator and the menu. Saved once the keys have been idle for
+// PERSIST_IDLE_MS, and put back by setup() before the first frame is drawn.
+#if HEXCALC_PERSIST
+
+const uint16_t persist_colors[4] = { COLOR_COL_FG, COLOR_OCT_FG, COLOR_DEC_FG, COLOR_HEX_FG }; // base_color values a record can hold
+const uint8_t  persist_depths[6] = { 8, 16, 24, 32, 64, WIDE_BITS };          // Bit depths by PERSIST_DEPTH_*
+
+bool     state_unsaved = false;                                                // A key has changed something since the last save
+uint32_t state_save_time = 0;                                                  // When to save it
+
+void captureRecord( PersistRecord &r ){                                        // Fills in r from the current state
+  memset( &r, 0, sizeof(r) );
+  uint8_t depth = 0, color = 0;
+  while( depth < PERSIST_DEPTH_WIDE && persist_depths[depth] != calc.bitDepth ) depth++;
+  while( color < 3 && persist_colors[color] != base_color ) color++;
+  r.mode  = calc.op_command | (calc.base == 8 ? 0 : calc.base == 10 ? 1 : 2) << 4 | calc.color_mode << 6;
+  r.depth = depth | calc.store_flag << 3 | calc.result_active << 4;
+  r.menu  = menu_mode | color << 2;
+  if( calc.wide() ){
+    memcpy( r.current, calc.wide_current.b, PERSIST_VALUE_BYTES );
+    memcpy( r.stored,  calc.wide_stored.b,  PERSIST_VALUE_BYTES );
+  } else {
+    memcpy( r.current, &calc.val_current, 8 );                                 // (both the AVR and the host are little-endian)
+    memcpy( r.stored,  &calc.val_stored,  8 );
+  }
+}
+
+bool restoreRecord( const PersistRecord &r ){                                  // Puts the state in r back (false, and nothing changed, if it makes no sense)
+  uint8_t op = r.mode & 0x0F, base = (r.mode >> 4) & 3, depth = r.depth & 7, menu = r.menu & 3;
+  if( op >= OP_COUNT || base > 2 || depth > PERSIST_DEPTH_WIDE || menu > MENU_COLOR ) return false;
+  switch( depth ){
+    case PERSIST_DEPTH_8:    calc.setBitDepth8();    break;
+    case PERSIST_DEPTH_16:   calc.setBitDepth16();   break;
+    case PERSIST_DEPTH_24:   calc.setBitDepth24();   break;
+    case PERSIST_DEPTH_32:   calc.setBitDepth32();   break;
+    case PERSIST_DEPTH_64:   calc.setBitDepth64();   break;
+    case PERSIST_DEPTH_WIDE: calc.setBitDepthWide(); break;
+  }
+  calc.base          = base == 0 ? 8 : base == 1 ? 10 : 16;
+  calc.color_mode    = (r.mode >> 6) & 1;
+  calc.op_command    = op;
+  calc.store_flag    = (r.depth >> 3) & 1;
+  calc.result_active = (r.depth >> 4) & 1;
+  if( calc.wide() ){
+    memcpy( calc.wide_current.b, r.current, PERSIST_VALUE_BYTES );
+    memcpy( calc.wide_stored.b,  r.stored,  PERSIST_VALUE_BYTES );
+    calc.val_current = calc.wide_current.word( 0 );
+    calc.val_stored  = calc.wide_stored.word( 0 );
+  } else {
+    memcpy( &calc.val_current, r.current, 8 );
+    memcpy( &calc.val_stored,  r.stored,  8 );
+  }
+  calc.bcd_current.valid = false;                                              // (the decimal shadows are rebuilt when they are needed)
+  calc.bcd_stored.valid  = false;
+  menu_mode  = menu;
+  base_color = persist_colors[(r.menu >> 2) & 3];
+  return true;
+}
+
+void restoreState(){                                                           // Picks up where the last power cycle left off (if it saved anything)
+  PersistRecord r;
+  if( persistLoad( r ) ) restoreRecord( r );
+}
+
+void saveState(){                                                              // Saves the state once the keys have been idle long enough (called from loop())
+  persistPoll();
+  if( !state_unsaved || (int32_t)(millis() - state_save_time) < 0 ) return;
+  PersistRecord r;
+  captureRecord( r );
+  if( persistSave( r ) ) state_unsaved = false;                                // (or try again once the last record is written)
+}
+
+#define STATE_CHANGED()  ( state_unsaved = true, state_save_time = millis() + PERSIST_IDLE_MS )
+#define STATE_RESTORE()  restoreState()
+#define STATE_SAVE()     saveState()
+
+#else
+
+#define STATE_CHANGED()  ((void)0)
+#define STATE_RESTORE()  ((void)0)
+#define STATE_SAVE()     ((void)0)
+
+#endif
+
+bool applyKey( uint8_t key );                                                  // Prototype for the key handler below
+
 void manageKeyPress(){                                                         // Keypress Event Handler Function
   if( millis() > screen_shutoff_time ){                                        // See if the screen is currently shut off
     screen_shutoff_time = millis() + SCREEN_SHUTOFF_DELAY;                     // Reset the shutoff timer
     return;                                                                    // Exit out of the keypress. (This just turns the screen back on)
   }
+  if( applyKey( hw.last_pressed_key ) ) STATS_KEY( hw.last_key_us );           // Start the key latency clock (if it isn't already running)
+}
 
+bool applyKey( uint8_t key ){                                                  // Runs a key code (from the keypad or remote.h), returns false if it did nothing
   bool refresh_screen = true;                                                  // Assume that we need to refresh the screen
   screen_shutoff_time = millis() + SCREEN_SHUTOFF_DELAY;                       // Reset the shutoff timer with every keypress
 
-  switch( hw.last_pressed_key ){                                               // Check the value of the last pressed key
+  uint8_t error = calc.error;                                                  // An error stays up until the next valid key
+  calc.error = CALC_ERROR_NONE;
+
+  switch( key ){                                                               // Check the value of the key
     case KEY_0:         calc.enterDigit(0);     break;                         // If the user pressed a number key, then 
     case KEY_1:         calc.enterDigit(1);     break;                         // pass the number to the calculator FSM
     case KEY_2:         calc.enterDigit(2);     break;                         // It will manage the state for us.
@@ -164,81 +261,171 @@ void manageKeyPress(){                                                         /
     case KEY_16_BIT:    calc.setBitDepth16();   break;                         // Set the current bit depth to 16 bits
     case KEY_32_BIT:    calc.setBitDepth32();   break;                         // Set the current bit depth to 32 bits
     case KEY_64_BIT:    calc.setBitDepth64();   break;                         // Set the current bit depth to 64 bits
+    case KEY_128_BIT:   if( calc.wide() ) calc.nextPage(); else calc.setBitDepthWide(); break; // Switch to extended precision (pressed again, it pages through the value)
 
     case KEY_RGB_565:   calc.setColorMode565(); menu_mode = MENU_COLOR;  base_color = COLOR_COL_FG; break; // Switch into 565 16-bit color mode
     case KEY_RGB_888:   calc.setColorMode888(); menu_mode = MENU_COLOR;  base_color = COLOR_COL_FG; break; // Switch into 888 24-bit color mode
     case KEY_BASE_8:    calc.setBase8();        menu_mode = MENU_BINARY; base_color = COLOR_OCT_FG; break; // Switch into octal mode
     case KEY_BASE_10:   calc.setBase10();       menu_mode = MENU_DEC;    base_color = COLOR_DEC_FG; break; // Switch into decimal mode
     case KEY_BASE_16:   calc.setBase16();       menu_mode = MENU_BINARY; base_color = COLOR_HEX_FG; break; // Switch into hexidecimal mode
-    default: refresh_screen = false;                                           // If the user doesn't press a valid button, we don't need to refresh
+    default: refresh_screen = false; calc.error = error;                       // If the user doesn't press a valid button, we don't need to refresh
   }
-  if( refresh_screen ) renderScreen();                                         // Refresh the screen if we need to
+  if( refresh_screen ) screen_dirty = true;                                    // Let loop() know the screen needs refreshing
+  if( refresh_screen ) STATE_CHANGED();                                        // and that there is something new to save
+  return refresh_screen;
 }
 
 
+
 /*******************************************
 * General Setup Function                   *
 *******************************************/
 
 void setup() {
+  STATS_SETUP();                                                               // Open the stats port and take the stack's starting point (only in HEXCALC_STATS builds)
   screen.init(SCREEN_WIDTH, SCREEN_HEIGHT, SPI_MODE2);                         // Initialize the screen
   pinMode( PIN_SCREEN_BLK, OUTPUT );                                           // Set the backlight pin to output mode
-  digitalWrite( PIN_SCREEN_BLK, HIGH );                                        // Turn the screen's backlight on
-  screen_shutoff_time = millis() + SCREEN_SHUTOFF_DELAY;                       // Set the shutoff timer
-
-  delay(10);                                                                   // Give everything a few ms to get situated
-  screen.setRotation(3);                                                       // Set the screen rotation to 270 degrees
-  screen.fillScreen( ST77XX_BLACK );                                           // Blank out the screen
+  digitalWrite( PIN_SCREEN_BLK, LOW );                                         // Keep the backlight off until the first frame is up (the panel powers up full of noise)
+  uint32_t settle_start = millis();
 
   hw.setup();                                                                  // Initialize the hardware library (keyboard and such)
   hw.onKeyPress( manageKeyPress );                                             // Add the keyboard handler function to react to keypress events
+  REMOTE_SETUP( calc, applyKey );                                              // Take commands over the serial port too (only in HEXCALC_REMOTE builds)
+  STATE_RESTORE();                                                             // Pick up where the calculator was left (see persist.h)
+
+  uint32_t settled = millis() - settle_start;
+  if( settled < 10 ) delay( 10 - settled );                                    // Give the screen a few ms to get situated (less whatever the above took)
+  screen.setRotation(3);                                                       // Set the screen rotation to 270 degrees
 
-  renderScreen();                                                              // Do the initial screen render event
+  screen_dirty = !renderScreen();                                              // The first frame blanks the screen around the widgets as it draws them
+  digitalWrite( PIN_SCREEN_BLK, HIGH );                                        // Turn the screen's backlight on
+  screen_shutoff_time = millis() + SCREEN_SHUTOFF_DELAY;                       // Set the shutoff timer
+  STATS_BOOT();                                                                // Time from reset to a usable screen (only in HEXCALC_STATS builds)
 }
 
 
 /*******************************************
 * Draw Functions                           *
 *******************************************/
+// Pixels go out to the screen as runs of a single color. The rasterizers collect their output into
+// runs with a SpanWriter and queue them into a small span FIFO (about two scanlines deep). The SPI is
+// fed from the other end of the FIFO whenever its transmit buffer has room, so the next scanline is
+// being rasterized while the previous one is still clocking out instead of the CPU idling on every byte.
+//
+// The FIFO is pumped from the rasterizer rather than from the SPI interrupt. At 12MHz the SPI wants a
+// new byte every 16 CPU cycles, which is less than an interrupt's own entry and exit, so streaming from
+// an ISR would halve the throughput. The SPI's buffer mode gives the same overlap without that cost.
+//
+// Every address window is opened with openWindow() and closed by SpanWriter::flush() (or endPixels()),
+// which waits for the FIFO to drain so the next command byte can't overtake the pixel data.
+
+#define SPAN_FIFO_SIZE 64                                                      // Number of runs the FIFO holds (must be a power of two)
+
+struct Span{                                                                   // One run of pixels waiting in the FIFO
+  uint16_t color;                                                              // Color of the run
+  uint16_t count;                                                              // Pixels left to send
+};
+
+Span    span_fifo[SPAN_FIFO_SIZE];                                             // Runs queued by the rasterizers
+uint8_t span_head = 0;                                                         // Next free slot (written by the rasterizers)
+uint8_t span_tail = 0;                                                         // Run currently being sent (read by pumpPixels)
+bool    span_low_byte = false;                                                 // True when the next byte out is the low byte of a pixel
+bool    window_pixels = false;                                                 // True once the open window has had pixels queued (and so will set TXCIF)
+
+void pumpPixels(){                                                             // Hand bytes to the SPI for as long as its transmit buffer has room
+  while( span_head != span_tail && (SPI0.INTFLAGS & SPI_DREIF_bm) ){
+    Span &run = span_fifo[span_tail];
+    if( span_low_byte ){                                                       // Second half of the pixel
+      SPI0.DATA = run.color & 0xFF;
+      if( --run.count == 0 ) span_tail = (span_tail + 1) & (SPAN_FIFO_SIZE - 1); // Move onto the next run once this one is used up
+    } else {                                                                   // The screen takes the high byte first
+      SPI0.DATA = run.color >> 8;
+    }
+    span_low_byte = !span_low_byte;
+  }
+}
+
+void queueRun( uint16_t color, uint16_t count ){                               // Queue count pixels of one color for the current address window
+  if( count == 0 ) return;
+  STATS_WORDS( count );
+  window_pixels = true;
+  uint8_t next = (span_head + 1) & (SPAN_FIFO_SIZE - 1);
+  while( next == span_tail ) pumpPixels();                                     // The FIFO is full, so keep the SPI busy until a slot frees up
+  span_fifo[span_head].color = color;
+  span_fifo[span_head].count = count;
+  span_head = next;
+  pumpPixels();                                                                // Top up the SPI before going back to rasterizing
+}
+
+void openWindow( uint8_t x, uint8_t y, uint8_t w, uint8_t h ){                 // Set the address window and switch the SPI over to buffer mode for the pixel data
+  screen.setAddrWindow( x, y, w, h );
+  SPI0.CTRLB |= SPI_BUFEN_bm | SPI_BUFWR_bm;                                   // Buffer mode: one byte can wait in DATA while the last one shifts out
+  SPI0.INTFLAGS = SPI_TXCIF_bm;                                                // Clear any stale transfer complete flag
+  window_pixels = false;
+}
+
+void endPixels(){                                                              // Wait for the queued pixels to reach the screen and hand the SPI back to the library
+  while( span_head != span_tail ) pumpPixels();                                // Drain the FIFO
+  if( window_pixels ) while( !(SPI0.INTFLAGS & SPI_TXCIF_bm) );               // Wait for the last byte to leave the shift register (an empty window sent none)
+  while( SPI0.INTFLAGS & SPI_RXCIF_bm ) (void)SPI0.DATA;                       // Throw away whatever was clocked in on the way
+  SPI0.CTRLB &= ~(SPI_BUFEN_bm | SPI_BUFWR_bm);                                // Back to normal mode for the library's command transfers
+}
+
+struct SpanWriter{                                                             // Merges consecutive pixels of the same color into runs for the FIFO
+  uint16_t color = 0;                                                          // Color of the run being collected
+  uint16_t count = 0;                                                          // Number of pixels in the run being collected
+
+  void add( uint16_t c, uint16_t n ){                                          // Append n pixels of color c
+    if( c != color ){ queueRun( color, count ); color = c; count = 0; }        // A new color ends the current run
+    count += n;
+  }
+  void flush(){ queueRun( color, count ); count = 0; endPixels(); }           // Push out the pending run and close the window (call once the drawing is done)
+};
+
+bool drawInterrupted(){                                                        // True once newer input should cut the widget being drawn short (see renderScreen)
+  if( draw_abortable && !draw_aborted ) draw_aborted = hw.keyPending() || REMOTE_PENDING();
+  return draw_aborted;
+}
+
+#define FILL_CHUNK 1024                                                        // Pixels a fill sends between checks for newer input (1.4ms at 12MHz)
+
 void fillBox( uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint16_t color ){   // Fill a box
-  screen.setAddrWindow( x, y, w, h );                                         // Set the address area of the area to fill
-  for( uint16_t i = (w*h); i>0; i--){                                         // Count down from the total area of the box
-    screen.SPI_WRITE16( color );                                              // Write the color into the box
+  if( w == 0 || h == 0 || drawInterrupted() ) return;                        // (nothing to fill, e.g. no gap above text that fills its box)
+  openWindow( x, y, w, h );                                                   // Set the address area of the area to fill
+  uint16_t left = w*h;
+  while( left ){                                                              // Push the box out as one color, a chunk at a time
+    uint16_t chunk = left < FILL_CHUNK ? left : FILL_CHUNK;
+    queueRun( color, chunk );
+    left -= chunk;
+    if( !left ) break;
+    while( span_head != span_tail ) pumpPixels();                             // Let the chunk go out before looking for input
+    if( drawInterrupted() ) break;
   }
+  endPixels();                                                                // and wait for it to go out
 }
 
 
 /*******************************************
 * Draw Tag    Functions                    *
 *******************************************/
-/* LEFT CAP:
-   0x1C: 0001 1100
-   0x3E: 0011 1110
-   0x7F: 0111 1111
-   0x7F: 0111 1111
-   0x7F: 0111 1111
-   0x7F: 0111 1111
- 
- * RIGHT CAP:
-   0x7F: 0111 1111
-   0x7F: 0111 1111
-   0x7F: 0111 1111
-   0x7F: 0111 1111
-   0x3E: 0011 1110
-   0x1C: 0001 1100
+/* The rounded ends of the pill, stored row-major like the font (column 0 in the top bit):
+ * LEFT CAP:        RIGHT CAP:
+   0x3C: ..####     0xF0: ####..
+   0x7C: .#####     0xF8: #####.
+   0xFC: ######     0xFC: ######
+   0xFC: ######     0xFC: ######
+   0xFC: ######     0xFC: ######
+   0x7C: .#####     0xF8: #####.
+   0x3C: ..####     0xF0: ####..
 */
-uint8_t left_char[6]  = { 0x1C, 0x3E, 0x7F, 0x7F, 0x7F, 0x7F };                // A character bitmap that describes the rounded left side of the pill 
-uint8_t right_char[6] = { 0x7F, 0x7F, 0x7F, 0x7F, 0x3E, 0x1C };                // A character bitmap that describes the rounded right side of the pill
+const uint8_t left_cap[CHAR_HEIGHT]  = { 0x3C, 0x7C, 0xFC, 0xFC, 0xFC, 0x7C, 0x3C }; // Rows of the rounded left side of the pill
+const uint8_t right_cap[CHAR_HEIGHT] = { 0xF0, 0xF8, 0xFC, 0xFC, 0xFC, 0xF8, 0xF0 }; // Rows of the rounded right side of the pill
 
 void drawTag( uint8_t x, uint8_t y, uint8_t scale_x, uint8_t scale_y, uint16_t fg_color, uint16_t bg_color, const char *str, uint8_t str_length, bool right_align = false ){
   uint8_t widget_width  = CHAR_WIDTH  * str_length * scale_x + 2 * CHAR_WIDTH; // Determine the width of the tag widget
   uint8_t widget_height = CHAR_HEIGHT * scale_y + 2;                           // Determine the height of the tag widget
-  int16_t str_index = 0;                                                       // Index of the current character in the value string
-  uint8_t colStep = 0;                                                         // Keeps track of the number of scaled pixel columns drawn so far
   uint8_t rowStep = 0;                                                         // Keeps track of the number of scaled pixel rows drawn so far
-  uint8_t hPixStep = scale_x;                                                  // Keeps track of the number of pixels drawn in a scaled pixel (horizontally)
   uint8_t vPixStep = scale_y;                                                  // Keeps track of the number of pixels drawn in a scaled pixel (vertically)
-  uint16_t font_index;                                                         // Points to the current character in the font array
   if( right_align ) x -= widget_width;                                         // Update the starting point depending on whether we need to right-align the text
 
   uint8_t line_left   =  x + 4;                                                // Calculate the left position of the rule that goes at the top/bottom of the pill
@@ -246,230 +433,253 @@ void drawTag( uint8_t x, uint8_t y, uint8_t scale_x, uint8_t scale_y, uint16_t f
   fillBox( line_left, y, line_length, 1, fg_color );                           // Draw a line on the top of the tag
   fillBox( line_left, y + widget_height - 1, line_length, 1, fg_color );       // Draw a line on the bottom of the tag
 
-  screen.setAddrWindow( x, y+1, widget_width, widget_height-2 );               // Set the address window for the tag's label text
+  openWindow( x, y+1, widget_width, widget_height-2 );                         // Set the address window for the tag's label text
 
+  SpanWriter span;                                                             // Collects the pixels into runs
   for( uint8_t row = 0; row<widget_height-2; row++ ){                          // Loop through each row in the tag's label text
-    str_index = -1;                                                            // Set the current string index to the beginning
-    colStep = CHAR_WIDTH;                                                      // Set the colStep tracker to the end of the character to it resets
-    for( uint8_t col = 0; col<widget_width; col++ ){                           // Loop through each column in the tag's label text
-      if( colStep == CHAR_WIDTH ){                                             // See if we have reached the end of the current character's columns
-        colStep = 0;                                                           // Reset the character column to zero
-        str_index++;                                                           // Increment the character index that points to the buffer
-        font_index = str[ str_index-1 ] * CHAR_WIDTH;                          // To get the actual string index, subtract one (the 0'th character will be a border character)
-      }
-
-      if( str_index == 0 ){                                                    // If it's the 0'th character draw the left_char bitmap
-        screen.SPI_WRITE16( (left_char[colStep] & (1<<rowStep)) > 0 ? fg_color : ST77XX_BLACK );
-      } else if( str_index == str_length+1){                                   // If it's the last character, draw the right_char bitmap
-        screen.SPI_WRITE16( (right_char[colStep] & (1<<rowStep)) > 0 ? fg_color : ST77XX_BLACK );
-      } else {                                                                 // For everything else, just draw the character from the font array
-        screen.SPI_WRITE16( (font5x7[font_index + colStep] & (1<<rowStep)) > 0 ? bg_color : fg_color );
-      }
-
-      if( (str_index == 0) || (str_index == str_length+1) ){                   // We don't want the width of the rounded ends to change with scale_x so if we are
-        colStep++;                                                             // in one of those characters, just increment colStep without worrying about hPixStep
-      } else {                                                                 // But if we are on one of the actual characters then
-        hPixStep--;                                                            // use hPixStep to track how many pixels we still have to render before moving
-        if( hPixStep == 0 ){                                                   // to the next column. We start at scale_x and decrement to keep things faster
-          colStep++;                                                           // Hit the end of the pixels in the column, so move to the next column in the character
-          hPixStep = scale_x;                                                  // Reset the pixel counter to scale_x
-        }
+    uint8_t bits = left_cap[rowStep];                                          // Draw the left cap (the rounded ends don't change width with scale_x)
+    for( uint8_t col = 0; col<CHAR_WIDTH; col++, bits <<= 1 ){
+      span.add( (bits & 0x80) ? fg_color : ST77XX_BLACK, 1 );
+    }
+    for( uint8_t str_index = 0; str_index<str_length; str_index++ ){           // Draw each character from the font (inverted, since the text is cut out of the pill)
+      bits = glyphRows( str[ str_index ] )[ rowStep ];                         // One byte holds this row of the character
+      for( uint8_t col = 0; col<CHAR_WIDTH; col++, bits <<= 1 ){               // Each column of the character is scale_x pixels wide
+        span.add( (bits & 0x80) ? bg_color : fg_color, scale_x );
       }
     }
-    vPixStep--;                                                                // Just like with hPixStep, we track the vertical pixel stepping
+    bits = right_cap[rowStep];                                                 // Draw the right cap
+    for( uint8_t col = 0; col<CHAR_WIDTH; col++, bits <<= 1 ){
+      span.add( (bits & 0x80) ? fg_color : ST77XX_BLACK, 1 );
+    }
+
+    vPixStep--;                                                                // Track the vertical pixel stepping
     if( vPixStep == 0 ){                                                       // Once vPixStep hits zero, we know we've reached the end of the row
       rowStep++;                                                               // and we are ready to move onto the next row
       vPixStep = scale_y;                                                      // Reset the vPixStep counter to scale_y
     }
   }
+  span.flush();                                                                // Push out whatever is left and close the window
 }
 
 
+/*******************************************
+* Draw Asset Function                      *
+*******************************************/
+// The tags and labels that never change shape are pre-rendered by host/assetgen.cpp, which runs the
+// draw functions above on the host and run-length encodes what they drew into assets.h. Each byte
+// of an asset is a run: the top two bits pick a color (ASSET_BLACK, ASSET_FG or ASSET_BG, so one
+// asset serves every color the tag comes in) and the low six hold the length less one. Blitting
+// one is a single address window and a walk down the runs, with no font lookups at all.
+// x, y          - Location of the top left corner of the asset
+// asset         - The asset (from assets.h)
+// fg_color      - Color of the ASSET_FG runs (the fg_color it was drawn with)
+// bg_color      - Color of the ASSET_BG runs (the bg_color it was drawn with)
+
+#if HEXCALC_ASSETS
+void blitAsset( uint8_t x, uint8_t y, const Asset &asset, uint16_t fg_color, uint16_t bg_color ){
+  const uint16_t palette[3] = { ST77XX_BLACK, fg_color, bg_color };          // Colors by ASSET_*
+  openWindow( x, y, asset.width, asset.height );
+  SpanWriter span;                                                             // Joins up runs that end up the same color
+  for( uint16_t i = 0; i < asset.runs; i++ ){
+    uint8_t run = asset.rle[i];
+    span.add( palette[run >> 6], (run & 0x3F) + 1 );
+  }
+  span.flush();
+}
+#endif
+
+
+/*******************************************
+* Text Layouts                             *
+*******************************************/
+// Where drawString puts a string inside its box is worked out by the compiler. A TextLayout holds
+// the scale, spacing and position for one string length in one box, and each number widget has a
+// NumberLayouts record with a layout for every bit depth in hex and octal (their length only depends
+// on the depth) and one for every length in decimal (which depends on the value). Drawing a number
+// is then a table lookup, with no divisions. The static_asserts at the end check that every value a
+// widget can show fits its box without losing any characters.
+
+struct TextLayout{
+  uint8_t scale_x, scale_y;                                                    // Size of one font pixel
+  uint8_t kerning;                                                             // Columns between characters (before scaling)
+  uint8_t length;                                                              // Characters drawn (fewer than laid out only if they can't fit at scale 1)
+  uint8_t left, top;                                                           // Offset of the text in the box (it is right and bottom aligned)
+  uint8_t text_width, text_height;                                             // Pixels the characters cover
+};
+
+constexpr TextLayout textLayout( uint8_t width, uint8_t height, uint8_t max_scale, uint8_t kerning, uint8_t length ){
+  uint8_t scale_x = width / ((CHAR_WIDTH + kerning) * length);                 // Calculate the largest scale possible for the number of characters
+  uint8_t scale_y = height / CHAR_HEIGHT;                                      // Calculate the largest height possible
+
+  if( scale_x == 0 && kerning ){                                               // Too many characters for the box: close up the spacing first
+    kerning = 0;
+    scale_x = width / (CHAR_WIDTH * length);
+  }
+  if( scale_x == 0 ){                                                          // Still too many
+    scale_x = 1;                                                               // Force horizontal scale to 1
+    length  = width / CHAR_WIDTH;                                              // Truncate the number of characters
+  }
+  if( scale_x > max_scale ) scale_x = max_scale;
+  if( scale_y > (scale_x<<1) ) scale_y = scale_x << 1;                         // Ensure we don't breach a 2 to 1 scaling ratio
+
+  uint8_t text_width  = (length * (CHAR_WIDTH + kerning) - kerning) * scale_x;
+  uint8_t text_height = CHAR_HEIGHT * scale_y;
+  return { scale_x, scale_y, kerning, length, uint8_t(width - text_width), uint8_t(height - text_height), text_width, text_height };
+}
+
+constexpr bool layoutFits( const TextLayout &l, uint8_t width, uint8_t height, uint8_t length ){ // True if l shows all length characters inside a width x height box
+  return l.length == length && l.left + l.text_width <= width && l.top + l.text_height <= height; // (left and top wrap around if the text is bigger than the box)
+}
+
+#define LAYOUT_DEPTHS 5                                                        // Bit depths a number can be shown at
+const uint8_t layout_depth[LAYOUT_DEPTHS] = { 8, 16, 24, 32, 64 };             // Bit depths by depthSlot() (extended precision shows 64 bits at a time)
+inline uint8_t depthSlot( uint8_t depth ){ return depth == 64 ? 4 : (depth >> 3) - 1; }
+
+constexpr uint8_t groupedLength( uint8_t digits, uint8_t group ){ return digits + (group ? (digits - 1) / group : 0); } // Characters in digits digits with a separator every group of them
+#define MAX_DECIMAL_LENGTH groupedLength( BCD_BYTES * 2, 3 )                   // Characters in the longest decimal value (20 digits and 6 commas)
+
+struct RadixLayout{                                                            // A hex or octal value at one bit depth
+  uint8_t    digits;                                                           // Digits to format
+  TextLayout text;
+};
+
+struct NumberLayouts{                                                          // Every way a number widget can lay out its value
+  uint8_t     width, height;                                                   // Size of the widget's box
+  uint8_t     group;                                                           // Hex and octal digits between spaces (0 for none)
+  RadixLayout hex[LAYOUT_DEPTHS], octal[LAYOUT_DEPTHS];                        // By depthSlot()
+  TextLayout  decimal[MAX_DECIMAL_LENGTH];                                     // By length - 1 (commas included)
+};
+
+constexpr NumberLayouts numberLayouts( uint8_t width, uint8_t height, uint8_t radix_scale, uint8_t decimal_scale, uint8_t group,
+                                       const uint8_t (&hex_kerning)[LAYOUT_DEPTHS], const uint8_t (&octal_kerning)[LAYOUT_DEPTHS] ){
+  NumberLayouts n{};
+  n.width  = width;
+  n.height = height;
+  n.group  = group;
+  for( uint8_t d = 0; d < LAYOUT_DEPTHS; d++ ){
+    uint8_t hex_digits   = hexDigits( layout_depth[d] );
+    uint8_t octal_digits = octalDigits( layout_depth[d] );
+    n.hex[d]   = { hex_digits,   textLayout( width, height, radix_scale, hex_kerning[d],   groupedLength( hex_digits, group ) ) };
+    n.octal[d] = { octal_digits, textLayout( width, height, radix_scale, octal_kerning[d], groupedLength( octal_digits, group ) ) };
+  }
+  for( uint8_t length = 1; length <= MAX_DECIMAL_LENGTH; length++ ) n.decimal[length - 1] = textLayout( width, height, decimal_scale, 1, length );
+  return n;
+}
+
+constexpr bool numberLayoutsFit( const NumberLayouts &n, bool decimal ){       // True if every hex and octal value (and decimal, if the widget shows it) fits whole
+  for( uint8_t d = 0; d < LAYOUT_DEPTHS; d++ ){
+    if( !layoutFits( n.hex[d].text,   n.width, n.height, groupedLength( n.hex[d].digits,   n.group ) ) ) return false;
+    if( !layoutFits( n.octal[d].text, n.width, n.height, groupedLength( n.octal[d].digits, n.group ) ) ) return false;
+  }
+  for( uint8_t length = 1; decimal && length <= MAX_DECIMAL_LENGTH; length++ ){
+    if( !layoutFits( n.decimal[length - 1], n.width, n.height, length ) ) return false;
+  }
+  return true;
+}
+
+// The kerning of each bit depth (8, 16, 24, 32, 64) sets how large the digits come out. The 24-bit
+// values and the 22 octal digits of a 64-bit value only fit the small boxes without it.
+constexpr NumberLayouts large_number_layouts = numberLayouts( 240, 56, 10, 8, 0, { 2, 1, 1, 1, 1 }, { 2, 1, 1, 1, 1 } );
+constexpr NumberLayouts small_number_layouts = numberLayouts( 180, 28, 2,  2, 4, { 2, 1, 0, 1, 1 }, { 2, 1, 0, 1, 0 } );
+constexpr NumberLayouts dec_number_layouts   = numberLayouts( 170, 28, 2,  2, 4, { 2, 1, 0, 1, 1 }, { 2, 1, 0, 1, 0 } );
+constexpr TextLayout    nibble_layout        = textLayout( 12, CHAR_HEIGHT * 2, 2, 0, 1 ); // One hex digit beside the nibble's dots
+constexpr TextLayout    pair_layout          = textLayout( 30, 24, 3, 1, 2 );  // The ASCII pairs and the color channel values
+constexpr TextLayout    dec_label_layout     = textLayout( 60, 24, 2, 1, 4 );  // "HEX:" and "OCT:" (when they aren't blitted from assets.h)
+
+static_assert( numberLayoutsFit( large_number_layouts, true ),  "A value doesn't fit the large number" );
+static_assert( numberLayoutsFit( small_number_layouts, true ),  "A value doesn't fit the small number" );
+static_assert( numberLayoutsFit( dec_number_layouts,   false ), "A value doesn't fit the decimal menu" ); // (which only shows hex and octal)
+static_assert( layoutFits( nibble_layout, 12, CHAR_HEIGHT * 2, 1 ) && layoutFits( pair_layout, 30, 24, 2 ) && layoutFits( dec_label_layout, 60, 24, 4 ),
+               "A label doesn't fit its box" );
+
+
 /*******************************************
 * Draw String Function                     *
 *******************************************/
 // This function draws a series of characters onto the screen in a pre-defined box size.
 // x, y          - Location of the top left corner of the bounding box
-// width, height - Size of the bounding box
-// max_scale     - The maximum horizontal scale factor for text
-// kerning       - The spacing between letters in the text
+// layout        - How the characters fit the box (see Text Layouts)
 // fg_color      - The color of the text
 // bg_color      - The background color behind the text
-// ghost_zeros   - Will change the color of leading zeros to COLOR_GHOST
-// str           - The pointer to the character array
-// str_length    - The number of characters in the array
+// ghost_chars   - Number of leading characters (the leading zeros of a number) to draw in COLOR_GHOST
+// str           - The pointer to the character array (layout.length characters are drawn)
 
-void drawString( uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t max_scale, uint8_t kerning, uint16_t fg_color, uint16_t bg_color, bool ghost_zeros, const char* str, uint8_t str_length ){
+void drawString( uint8_t x, uint8_t y, const TextLayout &layout, uint16_t fg_color, uint16_t bg_color, uint8_t ghost_chars, const char* str ){
 
-  bool     is_leading_zero = ghost_zeros;                                      // Used during the loop to track if we are rendering a leading zero in the number
-  bool     is_comma        = false;                                            // Used during the loop to track if we are currently rendering a comma
   int16_t  str_index = 0;                                                      // Index of the current character in the value string
-  uint8_t  col_width  = CHAR_WIDTH + kerning;                                  // The full width of a column with spacing
-  uint8_t  scale_x = width / (col_width * str_length);                         // Calculate the largest scale possible for the number of digits
-  uint8_t  scale_y = height / CHAR_HEIGHT;                                     // Calculate the largest height possible
-
-  if( scale_x == 0 ){                                                          // See if there are too many numbers for the size of the widget
-    scale_x = 1;                                                               // Force horizontal scale to 1
-    str_length = width / col_width;                                            // Truncate the number of digits
-  }
-  if( scale_x > max_scale ) scale_x = max_scale;
-  if( scale_y > (scale_x<<1) ) scale_y = scale_x << 1;                         // Ensure we don't breach a 2 to 1 scaling ratio (it's hard to)
+  uint8_t  str_length = layout.length;
+  uint8_t  scale_x    = layout.scale_x;
+  uint8_t  scale_y    = layout.scale_y;
+  uint8_t  kerning    = layout.kerning;
+  uint8_t  val_width  = layout.text_width;                                     // The pixel width that the actual characters will consume
+  uint8_t  val_height = layout.text_height;                                    // The pixel height that the actual characters will consume
 
-  uint8_t  val_width  = (str_length * col_width - kerning) * scale_x;          // The pixel width that the actual characters will consume
-  uint8_t  val_height = CHAR_HEIGHT * scale_y;                                 // The pixel height that the actual characters will consume
-
-  uint8_t  colStep = col_width;                                                // Keeps track of the number of scaled pixel columns drawn so far
   uint8_t  rowStep = 0;                                                        // Keeps track of the number of scaled pixel rows drawn so far
-  uint8_t  hPixStep = scale_x;                                                 // Keeps track of the number of pixels drawn in a scaled pixel (horizontally)
   uint8_t  vPixStep = scale_y;                                                 // Keeps track of the number of pixels drawn in a scaled pixel (vertically)
-  uint16_t font_index;                                                         // Points to the current character in the font array
-
-  fillBox( x, y, width-val_width, height, bg_color );                          // Fill in the box to the left of the type so gets cleared out
-  fillBox( x + width-val_width, y, val_width, height-val_height, bg_color );   // Fill in the box above the type so gets cleared out as it gets smaller
-
-  screen.setAddrWindow( x+width-val_width, y+height-val_height, val_width, val_height ); // Set the address area of the window to fill
-
-  for( uint8_t row = 0; row<val_height; row++ ){                               // The outer loop goes through each column
-    
-    str_index = 0;                                                             // Set the current column to the starting column defined in the select section above
-    is_leading_zero = true;                                                    // Since we started the line again, we have to reset the leading zero indicator for this row
-    colStep = col_width;                                                       // Reset colStep to the max value so it triggers the if statement at the beginning of the loop
-    
-    for( uint8_t col = 0; col<val_width; col++ ){                              // The outer loop goes through each column
-      
-      if( colStep == col_width ){                                              // See if we have reached the end of the columns in a character
-        colStep = 0;                                                           // Reset the character column to zero
-        font_index = str[ str_index ] * CHAR_WIDTH;                            // Assumes 6 columns per char
-        str_index++;                                                           // Increment the character index that points to the buffer
-
-        if( is_leading_zero ){                                                 // If haven't hit a number yet (still leading zeros)
-          if( (font_index != '0' * CHAR_WIDTH) && (font_index != ' ' * CHAR_WIDTH)) // See if we hit something other than a zero or a space
-            is_leading_zero = false;                                           // If we did, then set the is_leading_zero flag to false
-        }
-        is_comma = ( font_index == ',' * CHAR_WIDTH );                         // Set the is_comma flag if the current character is a comma
-      }
 
-      if( (colStep<CHAR_WIDTH) && ((font5x7[font_index + colStep] & (1<<rowStep)) > 0) ){ // See if the current pixel should be turned on per the font character bitmap
-        screen.SPI_WRITE16( (is_leading_zero || is_comma) ? COLOR_GHOST : fg_color );     // If comma / leading zero the use the ghost color. Otherwise use foreground color
-      } else {                                                                 // If the pixel isn't active, then we can
-        screen.SPI_WRITE16( bg_color );                                        // use the background color
-      }
-      
-      hPixStep--;                                                              // Decrement the horizontal pixel counter (for scaling)
-      if( hPixStep == 0 ){                                                     // Once pixel counter hits zero
-        colStep++;                                                             // Move to the next pixel
-        hPixStep = scale_x;                                                    // Reset the pixel counter to the horizontal scale (scale_x)
+  fillBox( x, y, layout.left, layout.top + val_height, bg_color );             // Fill in the box to the left of the type so gets cleared out
+  fillBox( x + layout.left, y, val_width, layout.top, bg_color );              // Fill in the box above the type so gets cleared out as it gets smaller
+
+  if( draw_aborted ) return;                                                   // Newer input cut the fills short
+  openWindow( x + layout.left, y + layout.top, val_width, val_height );        // Set the address area of the window to fill
+
+  SpanWriter span;                                                             // Collects the pixels into runs
+  for( uint8_t row = 0; row<val_height; row++ ){                               // The outer loop goes through each row
+    if( vPixStep == scale_y && rowStep && drawInterrupted() ) break;           // Newer input: stop at the next row of the font (see renderScreen)
+    for( str_index = 0; str_index<str_length; str_index++ ){                   // The inner loop goes through each character
+      char c = str[ str_index ];
+      uint16_t on_color = (str_index < ghost_chars || c == ',') ? COLOR_GHOST : fg_color; // Leading zeros and commas use the ghost color. Otherwise use foreground color
+
+      uint8_t bits = glyphRows( c )[ rowStep ];                                // One byte holds this row of the character
+      for( uint8_t colStep = 0; colStep<CHAR_WIDTH; colStep++, bits <<= 1 ){   // Each column of the character becomes a run of scale_x pixels
+        span.add( (bits & 0x80) ? on_color : bg_color, scale_x );
       }
+      if( str_index < str_length-1 ) span.add( bg_color, kerning * scale_x );  // Kerning between characters (none after the last one)
     }
+
     vPixStep--;                                                                // Decrement the vertical pixel counter (for scaling)
     if( vPixStep == 0 ){                                                       // Once pixel counter hits zero
       rowStep++;                                                               // Move to the next row
       vPixStep = scale_y;                                                      // Reset the pixel counter to the vertical scale (scale_y)
     }
   }
-
+  span.flush();                                                                // Push out whatever is left and close the window
 }
 
 /*******************************************
 * Draw Small Number Function               *
 *******************************************/
-// This function draws a small version of the number (used for the stored value and the hex/oct values of the decimal screen)
+// These functions draw a number at the widget's size (small is used for the stored value and the hex/oct values of the decimal screen)
 // base          - The numerical base to use to render the number (8, 10, 16)
 // x, y          - Location of the top left corner of the bounding box
-// width, height - Size of the bounding box
+// layouts       - The widget's layouts (its box, digits and spacing, see Text Layouts)
 // val           - The 64-bit numberical value to draw
+// min_digits    - Fewest decimal digits to draw (pages of an extended precision value keep their leading zeros)
 
-void drawSmallNumber( uint8_t base, uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint16_t fg_color, uint64_t val ){
-  char buffer[27] = {'0'};                                                     // Create a buffer to hold the string with the value to print to the screen
+const TextLayout &formatNumber( uint8_t base, const NumberLayouts &layouts, uint64_t val, uint8_t min_digits, NumberText &text ){ // Writes val into text and returns its layout
+  uint8_t slot = depthSlot( calc.displayDepth() );                             // Bits shown at once
 
   if( 16 == base ){                                                            // If we are in base 16 mode
-    //Format the 64-bit value into a set of 4-nibble hexidecimal words
-    sprintf(buffer, "%04X %04X %04X %04X", uint16_t(val>>48),uint16_t(val>>32),uint16_t(val>>16),uint16_t(val) );
-  
-    switch( calc.bitDepth ){                                                   // Use bit depth to determine how many digits to draw, and how large to make them
-      case 8:  drawString( x, y, width, height, 2, 2, fg_color, ST77XX_BLACK, true, &buffer[17],  2 ); break;     // Draw  8 bit value
-      case 16: drawString( x, y, width, height, 2, 1, fg_color, ST77XX_BLACK, true, &buffer[15],  4 ); break;     // Draw 16 bit value
-      case 24: drawString( x, y, width, height, 2, 0, fg_color, ST77XX_BLACK, true, &buffer[12],  7 ); break;     // Draw 24 bit value
-      case 32: drawString( x, y, width, height, 2, 1, fg_color, ST77XX_BLACK, true, &buffer[10],  9 ); break;     // Draw 32 bit value
-      case 64: drawString( x, y, width, height, 2, 1, fg_color, ST77XX_BLACK, true, &buffer[ 0], 19 ); break;     // Draw 64 bit value
-    }
+    formatRadix( val, 4, layouts.hex[slot].digits, layouts.group, text );      // Format the value as hexidecimal digits (grouped into 4-nibble words in the small widgets)
+    return layouts.hex[slot].text;
   } else if( 8 == base ){
-    //Format the 64-bit value into a set of 4-nibble octal words
-    sprintf(buffer, "%04o %04o %04o %04o", uint16_t((val>>36)&0xFFF),uint16_t((val>>24)&0xFFF),uint16_t((val>>12)&0xFFF),uint16_t((val)&0xFFF) );
-
-    switch( calc.bitDepth ){                                                   // Use bit depth to determine how many digits to draw, and how large to make them
-      case 8:  drawString( x, y, width, height, 2, 2, fg_color, ST77XX_BLACK, true, &buffer[17],  2 ); break;     // Draw  8 bit value
-      case 16: drawString( x, y, width, height, 2, 1, fg_color, ST77XX_BLACK, true, &buffer[15],  4 ); break;     // Draw 16 bit value
-      case 24: drawString( x, y, width, height, 2, 0, fg_color, ST77XX_BLACK, true, &buffer[12],  7 ); break;     // Draw 24 bit value
-      case 32: drawString( x, y, width, height, 2, 1, fg_color, ST77XX_BLACK, true, &buffer[10],  9 ); break;     // Draw 32 bit value
-      case 64: drawString( x, y, width, height, 2, 1, fg_color, ST77XX_BLACK, true, &buffer[ 0], 19 ); break;     // Draw 64 bit value
-    }
-  } else {                                                                     // Format as decimal
-    uint8_t  num_digits = 0;                                                   // Reset a counter for the number of digits in the base-10 number
-    uint64_t tmp = val;                                                        // Create a temporary storage for val
-    for( int8_t i=26; i>=0; i-- ){                                             // Loop through up to 26 digits (maximum allowed in 64-bit number)
-      if( tmp > 0 ){                                                           // Ensure tmp hasn't reached zero as we've removed digits
-        if( i % 4 == 3 ){                                                      // For every 3 digits, we want to add a comma
-          buffer[i] = ',';                                                     // Write a comma into the buffer
-        } else {                                                               // If we don't need a comma here
-          buffer[i] = 0x30 + (tmp % 10);                                       // Write a numeric character by adding the mod 10 remainder to the ASCII value for "0"  
-          tmp /= 10;                                                           // Divide tmp by 10 and do it all again
-        }
-        num_digits++;                                                          // Keep track of the number of digits
-      } else {                                                                 // If tmp is zero now...
-        buffer[i] = 0x30;                                                      // Write leading zeros into the buffer
-      }
-    }
-    if( num_digits == 0 ) num_digits = 1;                                      // We still want at least 1 digit even if the number is zero
-    drawString( x, y, width, height, 2, 1, fg_color, ST77XX_BLACK, true, &buffer[27-num_digits], num_digits ); // Draw the number to the screen
+    formatRadix( val, 3, layouts.octal[slot].digits, layouts.group, text );    // Format the value as octal digits (all 22 of them for 64 bits)
+    return layouts.octal[slot].text;
   }
+  formatBCD( calc.decimal( val ), text, min_digits );                          // Write the digits (with commas), straight from the calculator's BCD shadow when it can
+  return layouts.decimal[text.length - 1];
 }
 
-void drawLargeNumber( uint8_t base, uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint16_t fg_color, uint64_t val ){
-  char buffer[27] = {'0'};                                                     // Create a buffer to hold the string with the value to print to the screen
-
-  if( 16 == base ){                                                            // If we are in base 16 mode
-    //Format the 64-bit value into a set of 4-nibble hexidecimal words (no spaces between them)
-    sprintf(buffer, "%04X%04X%04X%04X", uint16_t(calc.val_current>>48),uint16_t(calc.val_current>>32),uint16_t(calc.val_current>>16),uint16_t(val) );
-    
-    switch( calc.bitDepth ){                                                   // Use bit depth to determine how many digits to draw, and how large to make them
-      case 8:  drawString( x, y, width, height, 10, 2, fg_color, COLOR_NUM_BG, true, &buffer[14],  2 ); break;     // Draw  8 bit value
-      case 16: drawString( x, y, width, height, 10, 1, fg_color, COLOR_NUM_BG, true, &buffer[12],  4 ); break;     // Draw 16 bit value
-      case 24: drawString( x, y, width, height, 10, 1, fg_color, COLOR_NUM_BG, true, &buffer[10],  6 ); break;     // Draw 24 bit value
-      case 32: drawString( x, y, width, height, 10, 1, fg_color, COLOR_NUM_BG, true, &buffer[ 8],  8 ); break;     // Draw 32 bit value
-      case 64: drawString( x, y, width, height, 10, 1, fg_color, COLOR_NUM_BG, true, &buffer[ 0], 16 ); break;     // Draw 64 bit value
-    }
-  } else if( 8 == base ){
-    //Format the 64-bit value into a set of 4-nibble octal words (no spaces)
-    sprintf(buffer, "%04o%04o%04o%04o", uint16_t((calc.val_current>>36) & 0xFFF),uint16_t((calc.val_current>>24) & 0xFFF),uint16_t((calc.val_current>>12) & 0xFFF),uint16_t(val & 0xFFF) );
-    
-    switch( calc.bitDepth ){                                                   // Use bit depth to determine how many digits to draw, and how large to make them
-      case 8:  drawString( x, y, width, height, 10, 2, fg_color, COLOR_NUM_BG, true, &buffer[13],  3 ); break;     // Draw  8 bit value
-      case 16: drawString( x, y, width, height, 10, 1, fg_color, COLOR_NUM_BG, true, &buffer[10],  6 ); break;     // Draw 16 bit value
-      case 24: drawString( x, y, width, height, 10, 1, fg_color, COLOR_NUM_BG, true, &buffer[ 8],  8 ); break;     // Draw 24 bit value
-      case 32: drawString( x, y, width, height, 10, 1, fg_color, COLOR_NUM_BG, true, &buffer[ 5], 11 ); break;     // Draw 32 bit value
-      case 64: drawString( x, y, width, height, 10, 1, fg_color, COLOR_NUM_BG, true, &buffer[ 0], 16 ); break;     // Draw 64 bit value
-    }
-  } else {                                                                     // Format as decimal
-    uint8_t  num_digits = 0;                                                   // Reset a counter for the number of digits in the base-10 number
-    uint64_t tmp = val;                                                        // Create a temporary storage for val
-    for( int8_t i=26; i>=0; i-- ){                                             // Loop through up to 26 digits (maximum allowed in 64-bit number)
-      if( tmp > 0 ){                                                           // Ensure tmp hasn't reached zero as we've removed digits
-        if( i % 4 == 3 ){                                                      // For every 3 digits, we want to add a comma
-          buffer[i] = ',';                                                     // Write a comma into the buffer
-        } else {                                                               // If we don't need a comma here
-          buffer[i] = 0x30 + (tmp % 10);                                       // Write a numeric character by adding the mod 10 remainder to the ASCII value for "0"  
-          tmp /= 10;                                                           // Divide tmp by 10 and do it all again
-        }
-        num_digits++;                                                          // Keep track of the number of digits
-      } else {                                                                 // If tmp is zero now...
-        buffer[i] = 0x30;                                                      // Write leading zeros into the buffer
-      }
-    }
-    if( num_digits == 0 ) num_digits = 1;                                      // We still want at least 1 digit even if the number is zero
+void drawSmallNumber( uint8_t base, uint8_t x, uint8_t y, const NumberLayouts &layouts, uint16_t fg_color, uint64_t val, uint8_t min_digits = 1 ){
+  NumberText text;                                                             // Holds the characters to print to the screen
+  const TextLayout &layout = formatNumber( base, layouts, val, min_digits, text );
+  drawString( x, y, layout, fg_color, ST77XX_BLACK, text.ghosts, text.str() ); // Draw the number to the screen
+}
 
-    drawString( x, y, width, height, 8, 1, fg_color, ST77XX_BLACK, true, &buffer[27-num_digits], num_digits ); // Draw the number to the screen
-  }
+void drawLargeNumber( uint8_t base, uint8_t x, uint8_t y, const NumberLayouts &layouts, uint16_t fg_color, uint64_t val, uint8_t min_digits = 1 ){
+  NumberText text;                                                             // Holds the characters to print to the screen
+  const TextLayout &layout = formatNumber( base, layouts, val, min_digits, text );
+  drawString( x, y, layout, fg_color, base == 10 ? ST77XX_BLACK : COLOR_NUM_BG, text.ghosts, text.str() ); // Hex and octal sit on the number background
 }
 
 /*******************************************
@@ -486,222 +696,498 @@ void drawNibble( uint8_t x, uint8_t y, uint8_t num_dots, uint16_t fg_color, uint
   uint8_t dot_spacing = (num_dots == 4) ? 2 : 3;                               // Set the spacing between dots depending on whether num_dots is 3 or 4
   uint16_t widget_width = (dot_width + dot_spacing) * num_dots;                // Determine the total width of the visualization
   uint16_t widget_height = CHAR_HEIGHT * 2;                                    // Determine the total height of the visualization
-  char buffer[2] = {0};                                                        // A buffer to store the word value's character
+  NumberText text;                                                             // Holds the nibble's character
 
-  sprintf(buffer, "%01X", val);                                                // Format val as a 1-digit hexidecimal value
-  drawString( x, y, 12, widget_height, 2, 0, fg_color, ST77XX_BLACK, false, buffer, 1 ); // Draw the value onto the screen
+  formatRadix( val, 4, 1, 0, text );                                           // Format val as a 1-digit hexidecimal value
+  drawString( x, y, nibble_layout, fg_color, ST77XX_BLACK, text.ghosts, text.str() ); // Draw the value onto the screen
 
-  screen.setAddrWindow( x + 15, y, widget_width, widget_height );              // Set the address area of the window to fill
+  openWindow( x + 15, y, widget_width, widget_height );                        // Set the address area of the window to fill
 
-  uint8_t colNum = 0;                                                          // Track the current column
-  uint8_t bit_num = num_dots - 1;                                              // Track the current bit
-  for( uint16_t i = widget_width * widget_height; i>0; i--){                   // Loop through all of the pixels in the widget's area
-    if( val & (1 << bit_num) ){                                                // If the current bit of val is a 1
-      screen.SPI_WRITE16( colNum < dot_width ? COLOR_COL_FG : ST77XX_BLACK );  // Then draw the a white dot (or black in the space between the dots)
-    } else {                                                                   // If the current bit of val is a zero
-      screen.SPI_WRITE16( colNum < dot_width ? COLOR_GHOST : ST77XX_BLACK );   // Then draw the a ghost dot (or black in the space between the dots)
+  SpanWriter span;                                                             // Collects the pixels into runs
+  for( uint8_t row = 0; row<widget_height; row++ ){                            // Every row of the widget is the same row of dots
+    for( int8_t bit_num = num_dots - 1; bit_num >= 0; bit_num-- ){             // Loop through the bits from most to least significant
+      span.add( (val & (1 << bit_num)) ? COLOR_COL_FG : COLOR_GHOST, dot_width ); // Draw a white dot for a 1 or a ghost dot for a 0
+      span.add( ST77XX_BLACK, dot_spacing );                                   // followed by the black space between the dots
     }
-    colNum++;                                                                  // Increment the column
-    if( colNum == (dot_width + dot_spacing) ){                                 // If we hit the end of a dot & space 
-      colNum = 0;                                                              // Reset the column counter
-      if( bit_num-- == 0 ) bit_num = num_dots-1;                               // Decrement the bit_num, and if we hit zero, set it back to the number of dots
-    }
-  }  
+  }
+  span.flush();                                                                // Push out whatever is left and close the window
 }
 
 /*******************************************
-* Draw Hex Binary                          *
+* Draw Progress Bar                        *
 *******************************************/
-// This function visualizes a hexidecimal binary number as a set of nibbles and their representative characters onto the screen
-// x, y         - Location of the top left corner of the bounding box
-// full_refresh - Completely re-draws all of the nibbles if true. Otherwise, only draws nibbles that change 
-// val          - The 64-bit numberical value to draw
-
-void drawHexBinary( uint8_t x, uint8_t y, bool full_refresh, uint64_t val ){                    
-  uint8_t spacing_x = 50;                                                      // Horizontal grid spacing of the nibbles visualizations
-  uint8_t spacing_y = 28;                                                      // Vertical grid spacing of the nibble visualizations
-  char buffer[3] = {0};                                                        // Buffer for the Byte ASCII visualizations
-
-  uint8_t nibble = 0;                                                          // Set the counter for the current nibble to zero
-  for( uint8_t row = 0; row < 4; row++ ){                                      // Loop through the rows of nibbles
-    for( uint8_t col = 0; col < 4; col++ ){                                    // Loop through the columns of nibble 
-      if( (15-nibble) < (calc.bitDepth >> 2) ){                                // See if we need to show this nibble based on the bit depth
-        if( full_refresh || (( (val >> ((15 - (row * 4 + col)) * 4)) & 0xF ) != ( (old_val >> ((15 - (row * 4 + col)) * 4)) & 0xF )) ){ // See if the nibble should be refreshed
-          drawNibble( x + col * spacing_x + 40, y + row * spacing_y, 4, COLOR_HEX_FG, (val >> ((15 - (row * 4 + col)) * 4)) & 0xF );    // Draw the nibble
-        }
-      }
-      nibble++;                                                                // Increment the number of nibbles
-    }
-  }
+// This function draws a progress bar onto the screen
+// x, y          - Location of the top left corner of the bounding box
+// width, height - Size of the bounding box
+// val           - A value between 0 and 255 to represent in the progress bar
 
-  for( uint8_t i=0; i<4; i++ ){                                                // Loop through the rows
-    buffer[0] = (calc.bitDepth >> 3) > (i*2) + 1 ? (val >> (i * 16 + 8)) & 0xFF : 0x00; // Capture the second byte of val as a character in the buffer
-    buffer[1] = (calc.bitDepth >> 3) > (i*2)     ? (val >> (i * 16)) & 0xFF     : 0x00; // Capture the first byte of val as a character in the buffer
-    drawString( x, y + spacing_y * (3-i)-6, 30, 24, 3, 1, COLOR_COL_FG, ST77XX_BLACK, false, buffer, 2 ); // Draw the buffer onto the screen
+void drawProgressBar( uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint16_t fg_color, uint16_t bg_color, uint16_t val ){
+  uint8_t bar_width = (val * width) >> 8;                                      // Calculate the inner bar width
+  openWindow( x, y, width, height );                                           // Set the address area of the window to fill
+  SpanWriter span;                                                             // Collects the pixels into runs
+  for( uint8_t row = 0; row<height; row++ ){                                   // Each row is the inner bar followed by the background
+    span.add( fg_color, bar_width );                                           // Write the foreground color for the inner box
+    span.add( bg_color, width - bar_width );                                   // and the background color for the rest
   }
+  span.flush();                                                                // Push out whatever is left and close the window
 }
 
+/*******************************************
+* Render Engine                            *
+*******************************************/
+// The screen is made up of widgets. Each widget declares which parts of the calculator state it
+// depends on, where it sits on the screen and how to draw itself. renderScreen() compares the
+// current state against the state that is currently on the screen and only re-emits the widgets
+// whose inputs changed. Widgets that go away (nibbles when dropping to a lower bit depth, or a whole
+// bottom menu when switching modes) only clear their own rectangle instead of the whole bottom half.
+//
+// Key handlers never draw. They change the calculator and set screen_dirty, and loop() renders
+// once the key queue is empty, so a burst of keys (fast digit entry, a held R+ key) collapses into
+// a single frame of the final state. If a new key arrives while a frame is being drawn, the frame
+// stops and loop() goes back to handle the key. Text stops at the next row of the font and fills
+// after the next FILL_CHUNK pixels, anything else once the widget in progress is done, so a key
+// waits on a few ms of drawing at most. The widgets
+// the frame didn't get to (or only got part way through) are marked pending and are drawn by the
+// next frame even if the state they come from ends up back where it was.
+//
+// A widget redrawn only because its inputs changed (not moved, cleared or left pending) is drawn
+// with draw_delta set, and `rendered` still holds the state its box shows. A draw function can then
+// repaint just the part that changed, like the few columns a color bar grows or shrinks by.
+
+struct RenderState{                                                            // Everything drawn on the screen is a function of this state
+  uint64_t val_current;                                                        // Calculator's current value (the page of it on the screen in extended precision)
+  uint64_t val_stored;                                                         // Calculator's stored value (likewise)
+  uint64_t val_word;                                                           // 64-bit word of the current value behind that page (the same as val_current otherwise)
+  uint8_t  op_command;                                                         // Calculator's selected operator
+  uint8_t  error;                                                              // Calculator's error flag (shown in place of the operator)
+  uint8_t  base;                                                               // Calculator's base
+  uint8_t  bit_depth;                                                          // Calculator's bit depth (as displayed, so 64 in extended precision)
+  uint8_t  page;                                                               // Page of an extended precision value on the screen
+  uint8_t  pages;                                                              // Number of pages (1 outside extended precision)
+  uint8_t  color_mode;                                                         // Calculator's color mode
+  uint8_t  menu_mode;                                                          // Bottom menu mode
+  uint16_t base_color;                                                         // Foreground color of the large number
+};
+
+// State Dependency Flags:
+#define DEP_VALUE      0x01                                                    // Depends on val_current
+#define DEP_STORED     0x02                                                    // Depends on val_stored
+#define DEP_OP         0x04                                                    // Depends on op_command (or error)
+#define DEP_BASE       0x08                                                    // Depends on base
+#define DEP_BIT_DEPTH  0x10                                                    // Depends on bit_depth
+#define DEP_COLOR_MODE 0x20                                                    // Depends on color_mode
+#define DEP_MENU       0x40                                                    // Depends on menu_mode
+#define DEP_BASE_COLOR 0x80                                                    // Depends on base_color
+#define DEP_PAGE       0x100                                                   // Depends on page or pages
+
+struct WidgetRect{ uint8_t x, y, w, h; };                                     // Screen rectangle covered by a widget
+
+struct Widget{
+  uint16_t deps;                                                               // DEP_* flags for the state this widget is drawn from
+  uint8_t  count;                                                              // Number of instances (e.g. 16 nibbles), each one is passed its own index
+  bool (*place)( const RenderState &s, uint8_t i, WidgetRect &r );             // Fills in the bounding box and returns false if the instance is hidden in state s
+  bool (*differs)( const RenderState &a, const RenderState &b, uint8_t i );    // Optional finer check that the instance's content changed (NULL means any dependency change)
+  void (*draw)( const RenderState &s, uint8_t i );                             // Draws the instance inside its bounding box
+  uint8_t  stage;                                                              // STAT_* render stage its drawing time is counted under (see stats.h)
+  bool     opaque;                                                             // True if draw() paints every pixel of the bounding box (others leave what was under, e.g. a tag's round corners)
+};
+
+RenderState rendered;                                                          // The state that is currently on the screen
+bool        rendered_valid = false;                                            // False until the first frame is drawn (forces everything to draw)
+uint64_t    pending_widgets = 0;                                               // Widget instances an aborted frame didn't draw (bit n = nth instance in the widget table)
+
 
 /*******************************************
-* Draw Octal Binary                        *
+* Widgets: Tags & Numbers                  *
 *******************************************/
-// This function visualizes a hexidecimal binary number as a set of nibbles and their representative characters onto the screen
-// x, y         - Location of the top left corner of the bounding box
-// full_refresh - Completely re-draws all of the nibbles if true. Otherwise, only draws nibbles that change 
-// val          - The 64-bit numberical value to draw
-
-void drawOctalBinary( uint8_t x, uint8_t y, bool full_refresh, uint64_t val ){
-  uint8_t spacing_x = 50;                                                      // Horizontal grid spacing of the nibbles visualizations
-  uint8_t spacing_y = 28;                                                      // Vertical grid spacing of the nibble visualizations
-  char buffer[3] = {0};                                                        // Buffer for the Byte ASCII visualizations
-
-  for( uint8_t row = 0; row < 4; row++ ){                                      // Loop through the rows of nibbles
-    for( uint8_t col = 0; col < 4; col++ ){                                    // Loop through the columns of nibble 
-      if( full_refresh || (( (val >> ((15 - (row * 4 + col)) * 3)) & 0b111 ) != ( (old_val >> ((15 - (row * 4 + col)) * 3)) & 0b111 )) ){ // See if the nibble should be refreshed
-        drawNibble( x + col * spacing_x + 40, y + row * spacing_y, 3, COLOR_OCT_FG, (val >> ((15 - (row * 4 + col)) * 3)) & 0b111 );      // Draw the nibble
-      }
-    }
+const uint8_t tag_x[5]     = { 0, 35, 70, 170, 205 };                          // Left edge of the OCT / DEC / HEX / 888 / 565 tags
+const char   *tag_label[5] = { "OCT", "DEC", "HEX", "888", "565" };            // Labels of the tags
+
+uint16_t tagColor( const RenderState &s, uint8_t i ){                          // A tag is lit up when its mode is the active one
+  bool color_menu = s.menu_mode == MENU_COLOR;
+  switch( i ){
+    case 0:  return !color_menu && (s.base ==  8) ? COLOR_OCT_FG : COLOR_GHOST;
+    case 1:  return !color_menu && (s.base == 10) ? COLOR_DEC_FG : COLOR_GHOST;
+    case 2:  return !color_menu && (s.base == 16) ? COLOR_HEX_FG : COLOR_GHOST;
+    case 3:  return  color_menu && (s.color_mode == RGB_888) ? COLOR_COL_FG : COLOR_GHOST;
+    default: return  color_menu && (s.color_mode == RGB_565) ? COLOR_COL_FG : COLOR_GHOST;
   }
+}
+bool placeTag( const RenderState &s, uint8_t i, WidgetRect &r ){ r = { tag_x[i], 0, 30, 16 }; return true; }
+bool tagDiffers( const RenderState &a, const RenderState &b, uint8_t i ){ return tagColor( a, i ) != tagColor( b, i ); }
+void drawTagWidget( const RenderState &s, uint8_t i ){
+#if HEXCALC_ASSETS
+  blitAsset( tag_x[i], 0, tag_assets[i], tagColor( s, i ), ST77XX_BLACK );
+#else
+  drawTag( tag_x[i], 0, 1, 2, tagColor( s, i ), ST77XX_BLACK, tag_label[i], 3 );
+#endif
+}
 
-  for( uint8_t i=0; i<4; i++ ){
-    buffer[0] = (val >> (i * 16 + 8)) & 0xFF;                                  // Capture the second byte of val as a character in the buffer
-    buffer[1] = (val >> (i * 16)) & 0xFF;                                      // Capture the first byte of val as a character in the buffer
-    drawString( x, y + spacing_y * (3-i)-6, 30, 24, 3, 1, COLOR_COL_FG, ST77XX_BLACK, false, buffer, 2 ); // Draw the buffer onto the screen
-  }
+bool placeLargeNumber( const RenderState &s, uint8_t i, WidgetRect &r ){ r = { 0, 54, 240, 56 }; return true; }
+uint8_t pageDigits( const RenderState &s ){ return s.page + 1 < s.pages ? WIDE_DEC_PAGE : 1; } // Decimal pages below the top one show all their digits
+void drawLargeNumberWidget( const RenderState &s, uint8_t i ){ drawLargeNumber( s.base, 0, 54, large_number_layouts, s.base_color, s.val_current, pageDigits( s ) ); }
+
+bool placeSmallNumber( const RenderState &s, uint8_t i, WidgetRect &r ){ r = { 0, 20, 180, 28 }; return true; }
+void drawSmallNumberWidget( const RenderState &s, uint8_t i ){ drawSmallNumber( s.base, 0, 20, small_number_layouts, COLOR_COL_FG, s.val_stored, pageDigits( s ) ); }
+
+bool placePageTag( const RenderState &s, uint8_t i, WidgetRect &r ){ r = { 120, 0, 30, 16 }; return s.pages > 1; }
+void drawPageTag( const RenderState &s, uint8_t i ){                           // Which page of an extended precision value is showing ("1/2" is the least significant)
+  char label[3] = { (char)('1' + s.page), '/', (char)('0' + s.pages) };
+  drawTag( 120, 0, 1, 2, COLOR_COL_FG, ST77XX_BLACK, label, 3 );
+}
+
+const char *const op_label[OP_COUNT] = {                                       // Operator tag labels by op_command (OP_NONE's blank tag is drawn all black)
+  " ", "+", "-", "X", "/", "MOD", "RoL", "RoR", "<<", ">>", "AND", "OR", "NOR", "XOR"
+};
+
+bool placeOpTag( const RenderState &s, uint8_t i, WidgetRect &r ){ r = { 190, 30, 50, 16 }; return true; }
+void drawOpTag( const RenderState &s, uint8_t i ){
+  bool     error = s.error == CALC_ERROR_DIV_BY_ZERO;                          // An error takes the place of the operator until the next key
+  bool     blank = !error && s.op_command == OP_NONE;
+  uint16_t fg_color = error ? COLOR_RED : blank ? ST77XX_BLACK : COLOR_GHOST;
+  uint16_t bg_color = blank ? ST77XX_BLACK : COLOR_COL_FG;
+#if HEXCALC_ASSETS
+  const Asset &asset = error ? op_error_asset : op_assets[s.op_command];
+  fillBox( 190, 30, 50 - asset.width, 16, ST77XX_BLACK );                      // Blank out the rest of the widget since the operator changes size
+  blitAsset( 240 - asset.width, 30, asset, fg_color, bg_color );
+#else
+  fillBox( 190, 30, 30, 16, ST77XX_BLACK );                                    // Blank out the left side of the widget since the operator changes size
+  const char *label = error ? "ERR" : op_label[s.op_command];
+  drawTag( 240, 30, 2, 2, fg_color, bg_color, label, strlen( label ), true );
+#endif
 }
 
+
 /*******************************************
-* Draw Progress Bar                        *
+* Widgets: Binary Menu (HEX / OCT)         *
 *******************************************/
-// This function draws a progress bar onto the screen
-// x, y          - Location of the top left corner of the bounding box
-// width, height - Size of the bounding box
-// val           - A value between 0 and 255 to represent in the progress bar
+// The nibble grid is 4x4 nibbles (or 3-bit triads in octal) starting at 40,130 with the byte pairs
+// shown as ASCII characters in a column down the left side.
 
-void drawProgressBar( uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint16_t fg_color, uint16_t bg_color, uint16_t val ){
-  uint8_t bar_width = (val * width) >> 8;                                      // Calculate the inner bar width
-  uint8_t colNum = 0;                                                          // Track the current column being rendered
-  screen.setAddrWindow( x, y, width, height );                                 // Set the address area of the window to fill
-  for( uint16_t i = width * height; i>0; i--){                                 // Loop through the pixels in the window area
-    screen.SPI_WRITE16( colNum < bar_width ? fg_color : bg_color );            // Write the foreground color if within the inner box otherwise the background color
-    if( ++colNum == width ) colNum = 0;                                        // Increment column and reset to zero if it hits the width of the widget
-  }  
+uint8_t nibbleValue( const RenderState &s, uint8_t i ){                        // Value of nibble/triad i (0 is the most significant)
+  if( s.base == 16 ) return (s.val_current >> ((15 - i) * 4)) & 0xF;
+  return (s.val_current >> ((15 - i) * 3)) & 0b111;
+}
+bool placeNibble( const RenderState &s, uint8_t i, WidgetRect &r ){
+  if( s.menu_mode != MENU_BINARY ) return false;                               // Only shown in the binary menu
+  if( s.base == 16 && (15 - i) >= (s.bit_depth >> 2) ) return false;           // Hex mode only shows the nibbles inside the bit depth
+  if( s.base != 16 && s.base != 8 ) return false;
+  r = { (uint8_t)(40 + (i & 3) * 50), (uint8_t)(130 + (i >> 2) * 28), (uint8_t)(s.base == 16 ? 47 : 48), 14 };
+  return true;
+}
+bool nibbleDiffers( const RenderState &a, const RenderState &b, uint8_t i ){ return a.base != b.base || nibbleValue( a, i ) != nibbleValue( b, i ); }
+void drawNibbleWidget( const RenderState &s, uint8_t i ){
+  drawNibble( 40 + (i & 3) * 50, 130 + (i >> 2) * 28, s.base == 16 ? 4 : 3, s.base == 16 ? COLOR_HEX_FG : COLOR_OCT_FG, nibbleValue( s, i ) );
+}
+
+uint16_t asciiPair( const RenderState &s, uint8_t i ){                         // The two bytes of word i as characters (hex mode blanks bytes outside the bit depth)
+  uint8_t hi = (s.val_current >> (i * 16 + 8)) & 0xFF;
+  uint8_t lo = (s.val_current >> (i * 16)) & 0xFF;
+  if( s.base == 16 ){
+    if( (s.bit_depth >> 3) <= (i * 2) + 1 ) hi = 0x00;
+    if( (s.bit_depth >> 3) <= (i * 2) )     lo = 0x00;
+  }
+  return (hi << 8) | lo;
+}
+bool placeAscii( const RenderState &s, uint8_t i, WidgetRect &r ){
+  if( s.menu_mode != MENU_BINARY || (s.base != 16 && s.base != 8) ) return false;
+  r = { 0, (uint8_t)(130 + 28 * (3 - i) - 6), 30, 24 };
+  return true;
+}
+bool asciiDiffers( const RenderState &a, const RenderState &b, uint8_t i ){ return asciiPair( a, i ) != asciiPair( b, i ); }
+void drawAsciiWidget( const RenderState &s, uint8_t i ){
+  uint16_t pair = asciiPair( s, i );
+  char buffer[3] = { (char)(pair >> 8), (char)(pair & 0xFF), 0 };              // Buffer for the Byte ASCII visualizations
+  drawString( 0, 130 + 28 * (3 - i) - 6, pair_layout, COLOR_COL_FG, ST77XX_BLACK, leadingGhosts( buffer, 2 ), buffer );
 }
 
+
 /*******************************************
-* Draw Color Menu                          *
+* Widgets: Decimal Menu                    *
 *******************************************/
-// This function draws the color visualization menu 
-// x, y          - Location of the top left corner of the bounding box
-// is565         - Indicates if the color is 16-bit 565 color mode (vs 24-bit 888 color mode)
-// val           - A 16-bit or 24-bit color value
+// The decimal menu shows the hex (row 0) and octal (row 1) representations of the current value
+// (in extended precision, of the 64-bit word behind the decimal page on the screen).
+
+bool placeDecLabel( const RenderState &s, uint8_t i, WidgetRect &r ){ r = { 0, (uint8_t)(130 + 44 * i), 60, 24 }; return s.menu_mode == MENU_DEC; }
+void drawDecLabel( const RenderState &s, uint8_t i ){
+#if HEXCALC_ASSETS
+  blitAsset( 0, 130 + 44 * i, dec_label_assets[i], i ? COLOR_OCT_FG : COLOR_HEX_FG, ST77XX_BLACK );
+#else
+  drawString( 0, 130 + 44 * i, dec_label_layout, i ? COLOR_OCT_FG : COLOR_HEX_FG, ST77XX_BLACK, 0, i ? "OCT:" : "HEX:" );
+#endif
+}
+
+bool placeDecNumber( const RenderState &s, uint8_t i, WidgetRect &r ){ r = { 60, (uint8_t)(126 + 44 * i), 170, 28 }; return s.menu_mode == MENU_DEC; }
+void drawDecNumber( const RenderState &s, uint8_t i ){
+  drawSmallNumber( i ? 8 : 16, 60, 126 + 44 * i, dec_number_layouts, i ? COLOR_OCT_FG : COLOR_HEX_FG, s.val_word );
+}
 
-void drawColorMenu( uint8_t x, uint8_t y, bool is565, uint64_t val ){
-  uint8_t redVal   = is565 ? (val >> 11) & 0b11111  : (val >> 16) & 0xFF;      // Calculate the red value (depending on 565 or 888 encoding)
-  uint8_t greenVal = is565 ? (val >> 5)  & 0b111111 : (val >> 8)  & 0xFF;      // Calculate the green value (depending on 565 or 888 encoding)
-  uint8_t blueVal  = is565 ? (val >> 0)  & 0b11111  : (val >> 0)  & 0xFF;      // Calculate the blue value (depending on 565 or 888 encoding)
-  uint16_t color_565 = is565 ? val & 0xFFFF : ( ((redVal >> 3) << 11) | ((greenVal >> 2)<<5) | (blueVal >> 3) ); // Calculate a new 565 color from the separate RGB values
 
-  char buffer[3] = {0};                                                        // Create a character buffer to hold the R/G/B string values
+/*******************************************
+* Widgets: Color Menu                      *
+*******************************************/
+// The color menu shows a label and progress bar for each of the red (0), green (1) and blue (2)
+// channels, plus a swatch of the color itself.
 
-  sprintf(buffer, "%02X", redVal);                                                                  // Write out the red value into the buffer as a hex value
-  drawString( x, y+3, 30, 24, 3, 1,  COLOR_RED,   ST77XX_BLACK, true, buffer, 2 );                  // Draw the red value to the screen
-  drawProgressBar(x+40, y+15, 80, 4, COLOR_RED,   COLOR_NUM_BG, is565 ? redVal << 3 : redVal );     // Draw the red progress bar to the screen
+const uint16_t channel_color[3] = { COLOR_RED, COLOR_GREEN, COLOR_BLUE };      // Colors used for each channel
 
-  sprintf(buffer, "%02X", greenVal);                                                                // Write out the green value into the buffer as a hex value
-  drawString( x, y+38, 30, 24, 3, 1, COLOR_GREEN, ST77XX_BLACK, true, buffer, 2 );                  // Draw the green value to the screen
-  drawProgressBar(x+40, y+50, 80, 4, COLOR_GREEN, COLOR_NUM_BG, is565 ? greenVal << 2 : greenVal ); // Draw the green progress bar to the screen
+uint8_t colorChannel( const RenderState &s, uint8_t ch ){                      // Raw value of a channel (depending on 565 or 888 encoding)
+  bool is565 = s.color_mode == RGB_565;
+  switch( ch ){
+    case 0:  return is565 ? (s.val_current >> 11) & 0b11111  : (s.val_current >> 16) & 0xFF;
+    case 1:  return is565 ? (s.val_current >> 5)  & 0b111111 : (s.val_current >> 8)  & 0xFF;
+    default: return is565 ? (s.val_current >> 0)  & 0b11111  : (s.val_current >> 0)  & 0xFF;
+  }
+}
+uint8_t colorLevel( const RenderState &s, uint8_t ch ){                        // Channel value scaled to 0-255 for the progress bars
+  if( s.color_mode != RGB_565 ) return colorChannel( s, ch );
+  return colorChannel( s, ch ) << (ch == 1 ? 2 : 3);
+}
+uint16_t colorSwatch( const RenderState &s ){                                  // The current value as a 565 color
+  if( s.color_mode == RGB_565 ) return s.val_current & 0xFFFF;
+  return ((colorChannel( s, 0 ) >> 3) << 11) | ((colorChannel( s, 1 ) >> 2) << 5) | (colorChannel( s, 2 ) >> 3);
+}
 
-  sprintf(buffer, "%02X", blueVal);                                                                 // Write out the blue value into the buffer as a hex value
-  drawString( x, y+73, 30, 24, 3, 1, COLOR_BLUE,  ST77XX_BLACK, true, buffer, 2 );                  // Draw the blue value to the screen
-  drawProgressBar(x+40, y+85, 80, 4, COLOR_BLUE,  COLOR_NUM_BG, is565 ? blueVal << 3 : blueVal );   // Draw the blue progress bar to the screen
+bool placeColorLabel( const RenderState &s, uint8_t i, WidgetRect &r ){ r = { 0, (uint8_t)(123 + 35 * i), 30, 24 }; return s.menu_mode == MENU_COLOR; }
+bool colorLabelDiffers( const RenderState &a, const RenderState &b, uint8_t i ){ return colorChannel( a, i ) != colorChannel( b, i ); }
+void drawColorLabel( const RenderState &s, uint8_t i ){
+  NumberText text;                                                             // Holds the channel's string value
+  formatRadix( colorChannel( s, i ), 4, 2, 0, text );                          // Write out the channel value as a 2-digit hex value
+  drawString( 0, 123 + 35 * i, pair_layout, channel_color[i], ST77XX_BLACK, text.ghosts, text.str() );
+}
 
-  fillBox( x+130, y+10, 100, 100, color_565 );                                 // Fill the Color Swatch
+bool placeColorBar( const RenderState &s, uint8_t i, WidgetRect &r ){ r = { 40, (uint8_t)(135 + 35 * i), 80, 4 }; return s.menu_mode == MENU_COLOR; }
+bool colorBarDiffers( const RenderState &a, const RenderState &b, uint8_t i ){ return colorLevel( a, i ) != colorLevel( b, i ); }
+void drawColorBar( const RenderState &s, uint8_t i ){
+  if( !draw_delta ){ drawProgressBar( 40, 135 + 35 * i, 80, 4, channel_color[i], COLOR_NUM_BG, colorLevel( s, i ) ); return; }
+  uint8_t was = (colorLevel( rendered, i ) * 80) >> 8;                         // Inner bar widths on the screen and wanted (as drawProgressBar works them out)
+  uint8_t now = (colorLevel( s, i ) * 80) >> 8;
+  if( now > was ) fillBox( 40 + was, 135 + 35 * i, now - was, 4, channel_color[i] ); // Grow the bar into the background
+  if( now < was ) fillBox( 40 + now, 135 + 35 * i, was - now, 4, COLOR_NUM_BG );   // or give the columns it lost back to it
 }
 
+bool placeSwatch( const RenderState &s, uint8_t i, WidgetRect &r ){ r = { 130, 130, 100, 100 }; return s.menu_mode == MENU_COLOR; }
+bool swatchDiffers( const RenderState &a, const RenderState &b, uint8_t i ){ return colorSwatch( a ) != colorSwatch( b ); }
+void drawSwatch( const RenderState &s, uint8_t i ){ fillBox( 130, 130, 100, 100, colorSwatch( s ) ); }
+
+
+/*******************************************
+* Widget Table                             *
+*******************************************/
+const Widget widgets[] = {
+  { DEP_BASE | DEP_COLOR_MODE | DEP_MENU,                           5,  placeTag,         tagDiffers,        drawTagWidget,         STAT_TAGS,        HEXCALC_ASSETS != 0 }, // (the blit paints the pill's corners too)
+  { DEP_VALUE | DEP_BASE | DEP_BIT_DEPTH | DEP_COLOR_MODE | DEP_BASE_COLOR | DEP_PAGE, 1, placeLargeNumber, NULL, drawLargeNumberWidget, STAT_LARGE_NUMBER, true  },
+  { DEP_STORED | DEP_BASE | DEP_BIT_DEPTH | DEP_COLOR_MODE | DEP_PAGE, 1, placeSmallNumber, NULL,           drawSmallNumberWidget, STAT_SMALL_NUMBER, true  },
+  { DEP_PAGE,                                                       1,  placePageTag,     NULL,              drawPageTag,           STAT_TAGS,        false },
+  { DEP_OP,                                                         1,  placeOpTag,       NULL,              drawOpTag,             STAT_OP_TAG,      HEXCALC_ASSETS != 0 }, // (the blit paints the pill's corners too)
+  { DEP_VALUE | DEP_BASE,                                           16, placeNibble,      nibbleDiffers,     drawNibbleWidget,      STAT_MENU,        false },
+  { DEP_VALUE | DEP_BASE | DEP_BIT_DEPTH,                           4,  placeAscii,       asciiDiffers,      drawAsciiWidget,       STAT_MENU,        true  },
+  { 0,                                                              2,  placeDecLabel,    NULL,              drawDecLabel,          STAT_MENU,        true  },
+  { DEP_VALUE | DEP_BIT_DEPTH,                                      2,  placeDecNumber,   NULL,              drawDecNumber,         STAT_MENU,        true  },
+  { DEP_VALUE | DEP_COLOR_MODE,                                     3,  placeColorLabel,  colorLabelDiffers, drawColorLabel,        STAT_MENU,        true  },
+  { DEP_VALUE | DEP_COLOR_MODE,                                     3,  placeColorBar,    colorBarDiffers,   drawColorBar,          STAT_MENU,        true  },
+  { DEP_VALUE | DEP_COLOR_MODE,                                     1,  placeSwatch,      swatchDiffers,     drawSwatch,            STAT_MENU,        true  },
+};
+#define NUM_WIDGETS (sizeof(widgets) / sizeof(widgets[0]))                     // Number of entries in the widget table
+#define MEM_PROBE_CLEAR NUM_WIDGETS                                             // Stack probe of pass 1's fillBox (after the widgets' own)
+
+#if HEXCALC_STATS
+const char *const mem_probe_names[MEM_PROBES] = {                              // Stack probes (see stats.h): one per widget table entry, then the clears
+  "drawTagWidget", "drawLargeNumberWidget", "drawSmallNumberWidget", "drawPageTag", "drawOpTag", "drawNibbleWidget",
+  "drawAsciiWidget", "drawDecLabel", "drawDecNumber", "drawColorLabel", "drawColorBar", "drawSwatch", "fillBox"
+};
+static_assert( NUM_WIDGETS + 1 <= MEM_PROBES, "every widget table entry needs a stack probe" );
+#endif
+
+#define MAX_CLEARED_RECTS 24                                                   // Cleared rectangles remembered per frame (more forces a redraw of everything visible)
 
 
 /*******************************************
 * Render Function                          *
 *******************************************/
 
-void renderScreen(){
-
-    bool refreshBase    = calc.base != old_base;                               // See if the base changed
-    bool refreshBitMode = calc.bitDepth != old_bit_depth;                      // See if the bit depth changed
-    bool refreshColor   = calc.color_mode != old_color_mode;                   // See if the color mode changed
-    bool refreshOp      = calc.op_command != old_op;                           // See if the operator command changed
-    bool refreshValue   = calc.val_current != old_val;                         // See if the current value changed
-    bool refreshStored  = calc.val_stored != old_stored;                       // See if the stored value changed
-    bool refreshBottom  = menu_mode != old_menu_mode;                          // See if the menu mode changed
-    bool refreshBin     = refreshBase || refreshBitMode || refreshBottom;      // See if we need to update the binary info
-
-    digitalWrite(PIN_SCREEN_DC, HIGH);                                         // Set the DC line High so we can send data to the screen
-    SPI.beginTransaction(SPISettings(20000000, MSBFIRST, SPI_MODE2));          // Run the SPI transaction at 20 MHZ
-
-    if( refreshBase || refreshColor || refreshBottom ){                        // Update the tags at the top of the screen depending on the mode
-      drawTag( 0,   0, 1, 2, (menu_mode != MENU_COLOR) && (calc.base ==  8) ? COLOR_OCT_FG : COLOR_GHOST, ST77XX_BLACK, "OCT", 3 );
-      drawTag( 35,  0, 1, 2, (menu_mode != MENU_COLOR) && (calc.base == 10) ? COLOR_DEC_FG : COLOR_GHOST, ST77XX_BLACK, "DEC", 3 );
-      drawTag( 70,  0, 1, 2, (menu_mode != MENU_COLOR) && (calc.base == 16) ? COLOR_HEX_FG : COLOR_GHOST, ST77XX_BLACK, "HEX", 3 );
-      drawTag( 170, 0, 1, 2, (menu_mode == MENU_COLOR) && (calc.color_mode == RGB_888) ? COLOR_COL_FG : COLOR_GHOST, ST77XX_BLACK, "888", 3 );
-      drawTag( 205, 0, 1, 2, (menu_mode == MENU_COLOR) && (calc.color_mode == RGB_565) ? COLOR_COL_FG : COLOR_GHOST, ST77XX_BLACK, "565", 3 );
-    }
+RenderState captureState(){                                                    // Snapshot everything the widgets are drawn from
+  RenderState s;
+  bool wide     = calc.wide();                                                  // Extended precision values are shown a page at a time
+  s.val_current = wide ? calc.pageValue( calc.wide_current ) : calc.val_current;
+  s.val_stored  = wide ? calc.pageValue( calc.wide_stored )  : calc.val_stored;
+  s.val_word    = wide ? calc.pageWord( calc.wide_current )  : calc.val_current;
+  s.op_command  = calc.op_command;
+  s.error       = calc.error;
+  s.base        = calc.base;
+  s.bit_depth   = calc.displayDepth();
+  s.page        = calc.page;
+  s.pages       = calc.pages();
+  s.color_mode  = calc.color_mode;
+  s.menu_mode   = menu_mode;
+  s.base_color  = base_color;
+  return s;
+}
 
-    if( refreshValue || refreshBase || refreshColor || refreshBitMode ) drawLargeNumber( calc.base, 0, 54, 240, 56, base_color, calc.val_current );   // Update the current val 
-    if( refreshStored || refreshBase || refreshColor || refreshBitMode ) drawSmallNumber( calc.base, 0, 20, 180, 28, COLOR_COL_FG, calc.val_stored ); // Update the stored val
-
-    if( refreshOp ){                                                           // See if we need to refresh the operator widget
-      fillBox( 190, 30, 30, 16, ST77XX_BLACK );                                // Blank out the left side of the widget since the operator changes size
-
-      switch(  calc.op_command ){                                              // Based on the current operator command
-        case OP_NONE:        drawTag( 240, 30, 2, 2, ST77XX_BLACK, ST77XX_BLACK, " ",   1, true ); break; // Draw the operator tag
-        case OP_PLUS:        drawTag( 240, 30, 2, 2, COLOR_GHOST,  COLOR_COL_FG, "+",   1, true ); break;
-        case OP_MINUS:       drawTag( 240, 30, 2, 2, COLOR_GHOST,  COLOR_COL_FG, "-",   1, true ); break;
-        case OP_MULTIPLY:    drawTag( 240, 30, 2, 2, COLOR_GHOST,  COLOR_COL_FG, "X",   1, true ); break;
-        case OP_DIVIDE:      drawTag( 240, 30, 2, 2, COLOR_GHOST,  COLOR_COL_FG, "/",   1, true ); break;
-        case OP_MOD:         drawTag( 240, 30, 2, 2, COLOR_GHOST,  COLOR_COL_FG, "MOD", 3, true ); break;
-        case OP_ROL:         drawTag( 240, 30, 2, 2, COLOR_GHOST,  COLOR_COL_FG, "RoL", 3, true ); break;
-        case OP_ROR:         drawTag( 240, 30, 2, 2, COLOR_GHOST,  COLOR_COL_FG, "RoR", 3, true ); break;
-        case OP_LEFT_SHIFT:  drawTag( 240, 30, 2, 2, COLOR_GHOST,  COLOR_COL_FG, "<<",  2, true ); break;
-        case OP_RIGHT_SHIFT: drawTag( 240, 30, 2, 2, COLOR_GHOST,  COLOR_COL_FG, ">>",  2, true ); break;
-        case OP_AND:         drawTag( 240, 30, 2, 2, COLOR_GHOST,  COLOR_COL_FG, "AND", 3, true ); break;
-        case OP_OR:          drawTag( 240, 30, 2, 2, COLOR_GHOST,  COLOR_COL_FG, "OR",  2, true ); break;
-        case OP_NOR:         drawTag( 240, 30, 2, 2, COLOR_GHOST,  COLOR_COL_FG, "NOR", 3, true ); break;
-        case OP_XOR:         drawTag( 240, 30, 2, 2, COLOR_GHOST,  COLOR_COL_FG, "XOR", 3, true ); break;
-      }
-    }
+uint16_t stateChanges( const RenderState &a, const RenderState &b ){           // Returns the DEP_* flags of every part of the state that differs
+  uint16_t changes = 0;
+  if( a.val_current != b.val_current ) changes |= DEP_VALUE;
+  if( a.val_word    != b.val_word    ) changes |= DEP_VALUE;
+  if( a.val_stored  != b.val_stored  ) changes |= DEP_STORED;
+  if( a.op_command  != b.op_command  ) changes |= DEP_OP;
+  if( a.error       != b.error       ) changes |= DEP_OP;                      // The error is shown by the operator tag
+  if( a.base        != b.base        ) changes |= DEP_BASE;
+  if( a.bit_depth   != b.bit_depth   ) changes |= DEP_BIT_DEPTH;
+  if( a.color_mode  != b.color_mode  ) changes |= DEP_COLOR_MODE;
+  if( a.menu_mode   != b.menu_mode   ) changes |= DEP_MENU;
+  if( a.base_color  != b.base_color  ) changes |= DEP_BASE_COLOR;
+  if( a.page != b.page || a.pages != b.pages ) changes |= DEP_PAGE;
+  return changes;
+}
+
+bool sameRect( const WidgetRect &a, const WidgetRect &b ){ return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h; }
+bool rectContains( const WidgetRect &outer, const WidgetRect &inner ){
+  return inner.x >= outer.x && inner.y >= outer.y && inner.x + inner.w <= outer.x + outer.w && inner.y + inner.h <= outer.y + outer.h;
+}
+bool rectsOverlap( const WidgetRect &a, const WidgetRect &b ){
+  return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
 
-    if( refreshBottom || refreshBitMode || refreshBase ){ fillBox(0, 120, SCREEN_WIDTH, 120, ST77XX_BLACK); } // If we need a full redo of the bottom of the screen, blank it out
+bool appears( const Widget &w, uint8_t i, const RenderState &s, WidgetRect &r ){ // True if the instance is visible in s but is not already on the screen in the same place
+  if( !w.place( s, i, r ) ) return false;
+  WidgetRect old_r;
+  return !rendered_valid || !w.place( rendered, i, old_r ) || !sameRect( old_r, r );
+}
+
+bool coveredByAppearing( const RenderState &s, const WidgetRect &area ){       // True if a widget that is about to be drawn fully covers area anyway
+  WidgetRect r;
+  for( uint8_t n = 0; n < NUM_WIDGETS; n++ ){
+    for( uint8_t i = 0; i < widgets[n].count; i++ ){
+      if( appears( widgets[n], i, s, r ) && rectContains( r, area ) ) return true;
+    }
+  }
+  return false;
+}
 
-    switch( menu_mode ){                                                                     // Based on the menu mode
-      case MENU_BINARY:                                                                      // If it's a binary menu (HEX / OCTAL)
-        if( refreshBin || refreshValue ){                                                    // If the binary number of value changed
-          if( calc.base == 16 )     drawHexBinary( 0, 130, refreshBin, calc.val_current );   // If hex mode, draw the binary number in hex mode
-          else if( calc.base == 8 ) drawOctalBinary( 0, 130, refreshBin, calc.val_current ); // If oct mode, draw the binary number in oct mode
-        }
-        break;
+// The first frame has nothing on the screen to draw over, and the panel powers up full of noise.
+// Rather than blank the whole screen and then draw the widgets over most of it, clearGaps() blanks
+// just the parts no opaque widget paints over (the others, like the tags, get their boxes blanked
+// first). It works down the screen in bands between the widgets' top and bottom edges, and fills
+// the gaps between the widgets in each band.
+#define MAX_VISIBLE 64                                                         // Widget instances that can be on the screen at once (one per bit of pending_widgets)
+
+void clearGaps( const RenderState &s ){                                        // Blanks every part of the screen that no opaque widget visible in s draws over
+  WidgetRect visible[MAX_VISIBLE], r;
+  uint8_t    num_visible = 0;
+  uint8_t    edges[2 * MAX_VISIBLE + 1];                                       // Band edges: the screen's top and every widget's top and bottom
+  uint8_t    num_edges = 0;
+  edges[num_edges++] = 0;
+  for( uint8_t n = 0; n < NUM_WIDGETS; n++ ){
+    for( uint8_t i = 0; widgets[n].opaque && i < widgets[n].count && num_visible < MAX_VISIBLE; i++ ){
+      if( !widgets[n].place( s, i, r ) ) continue;
+      visible[num_visible++] = r;
+      edges[num_edges++] = r.y;
+      edges[num_edges++] = r.y + r.h;
+    }
+  }
+  for( uint8_t a = 1; a < num_edges; a++ ){                                    // Sort the edges (there are few enough that an insertion sort does)
+    uint8_t e = edges[a], b = a;
+    for( ; b && edges[b - 1] > e; b-- ) edges[b] = edges[b - 1];
+    edges[b] = e;
+  }
 
-      case MENU_DEC:                                                                         // If it's the decimal menu
-        drawString( 0, 130, 60, 24, 2, 1, COLOR_HEX_FG, ST77XX_BLACK, false, "HEX:", 4 );    // Create a label for "HEX:"
-        drawSmallNumber( 16, 60, 126, 170, 28, COLOR_HEX_FG, calc.val_current );             // Draw the hex representation for the decimal number
+  for( uint8_t a = 0; a < num_edges; a++ ){
+    uint8_t top = edges[a];
+    uint8_t bottom = a + 1 < num_edges ? edges[a + 1] : SCREEN_HEIGHT;
+    if( bottom <= top ) continue;                                              // (the same edge twice)
+    uint8_t x = 0;                                                             // Everything left of x is covered (or already blanked) in this band
+    while( x < SCREEN_WIDTH ){
+      uint8_t next = SCREEN_WIDTH, reach = x;                                  // Left edge of the next widget in the band, and how far the widgets at x reach
+      for( uint8_t v = 0; v < num_visible; v++ ){
+        const WidgetRect &w = visible[v];
+        if( w.y > top || w.y + w.h < bottom ) continue;                        // Not in this band (bands never cut through a widget)
+        if( w.x <= x ){ if( w.x + w.w > reach ) reach = w.x + w.w; }
+        else if( w.x < next ) next = w.x;
+      }
+      if( reach > x ){ x = reach; continue; }
+      fillBox( x, top, next - x, bottom - top, ST77XX_BLACK );
+      x = next;
+    }
+  }
+}
 
-        drawString( 0, 174, 60, 24, 2, 1, COLOR_OCT_FG, ST77XX_BLACK, false, "OCT:", 4 );    // Create a label for "OCT:"
-        drawSmallNumber( 8, 60, 170, 170, 28, COLOR_OCT_FG, calc.val_current );              // Draw the octal representation for the decimal number
-        break;
+bool renderScreen( bool interruptible ){                                       // Returns false if newer input cut the frame short (never happens when !interruptible)
+  RenderState cur = captureState();                                            // The state we want on the screen
+  uint16_t changes = rendered_valid ? stateChanges( rendered, cur ) : 0xFFFF; // Which parts of it changed since the last frame
+  WidgetRect cleared[MAX_CLEARED_RECTS];                                       // Rectangles blanked out in this frame
+  uint8_t    num_cleared = 0;                                                  // Number of entries in cleared[]
+  bool       cleared_overflow = false;                                         // Set if cleared[] ran out of room
+  WidgetRect old_r, new_r;
+  STATS_BEGIN( frame_start );
+
+  digitalWrite(PIN_SCREEN_DC, HIGH);                                           // Set the DC line High so we can send data to the screen
+  SPI.beginTransaction(SPISettings(20000000, MSBFIRST, SPI_MODE2));            // Run the SPI transaction at 20 MHZ
+
+  if( rendered_valid ){                                                        // Pass 1: blank out widgets that are going away or moving
+    for( uint8_t n = 0; n < NUM_WIDGETS; n++ ){
+      const Widget &w = widgets[n];
+      for( uint8_t i = 0; i < w.count; i++ ){
+        if( !w.place( rendered, i, old_r ) ) continue;                         // It isn't on the screen right now
+        if( w.place( cur, i, new_r ) && rectContains( new_r, old_r ) ) continue; // It will redraw over its own footprint
+        if( coveredByAppearing( cur, old_r ) ) continue;                       // Some other new widget will draw over it
+        STATS_BEGIN( clear_start );
+        MEM_PROBE_BEGIN( clear_sp );
+        fillBox( old_r.x, old_r.y, old_r.w, old_r.h, ST77XX_BLACK );           // Otherwise blank out just its rectangle
+        MEM_PROBE_END( MEM_PROBE_CLEAR, clear_sp );
+        STATS_STAGE( STAT_CLEAR, clear_start );
+        if( num_cleared < MAX_CLEARED_RECTS ) cleared[num_cleared++] = old_r;
+        else cleared_overflow = true;
+      }
+    }
+  } else {
+    STATS_BEGIN( clear_start );
+    clearGaps( cur );                                                          // Pass 1 of the first frame: blank out what the widgets won't cover
+    STATS_STAGE( STAT_CLEAR, clear_start );
+  }
 
-      case MENU_COLOR:                                                                       // If it's the color menu
-        drawColorMenu( 0, 120, calc.color_mode == RGB_565, calc.val_current );               // Draw the color menu
-        break;
+  uint64_t pending = 0;                                                        // Instances this frame leaves undrawn
+  bool     aborted = false;
+  uint8_t  instance = 0;                                                       // Position of the instance in pending_widgets
+  for( uint8_t n = 0; n < NUM_WIDGETS; n++ ){                                  // Pass 2: draw every visible widget whose inputs changed
+    const Widget &w = widgets[n];
+    for( uint8_t i = 0; i < w.count; i++, instance++ ){
+      if( !w.place( cur, i, new_r ) ) continue;                                // Hidden in the new state
+      bool dirty = appears( w, i, cur, new_r ) || cleared_overflow;            // Newly visible or moved
+      if( !dirty ) dirty = (pending_widgets >> instance) & 1;                  // Left undrawn by an aborted frame
+      for( uint8_t c = 0; !dirty && c < num_cleared; c++ ){                    // Part of it was blanked out by pass 1
+        dirty = rectsOverlap( cleared[c], new_r );
+      }
+      bool delta = false;                                                      // Only its inputs changed, so its box still shows rendered
+      if( !dirty && (w.deps & changes) ) delta = dirty = !w.differs || w.differs( rendered, cur, i ); // One of its inputs changed
+      if( !dirty ) continue;
+      if( !aborted ) aborted = interruptible && (hw.keyPending() || REMOTE_PENDING()); // Newer input: leave the rest for the next frame
+      if( !aborted ){
+        draw_abortable = interruptible;
+        draw_delta = delta;
+        STATS_BEGIN( draw_start );
+        MEM_PROBE_BEGIN( draw_sp );
+        w.draw( cur, i );
+        MEM_PROBE_END( n, draw_sp );
+        STATS_STAGE( w.stage, draw_start );
+        draw_abortable = false;
+        draw_delta = false;
+        aborted = draw_aborted;                                                // (it gave up part way through)
+        draw_aborted = false;
+      }
+      if( aborted ) pending |= (uint64_t)1 << instance;
     }
+  }
 
-    old_val        = calc.val_current;                                                       // Store the various values so we can see if they changed
-    old_stored     = calc.val_stored;                                                        // when it's time to render the screen again
-    old_base       = calc.base;
-    old_color_mode = calc.color_mode;
-    old_bit_depth  = calc.bitDepth;
-    old_menu_mode  = menu_mode;
+  // Everything on the screen now matches cur, except inside the rectangles of the pending
+  // instances (stale or blank). The next frame redraws those if they are still visible, and clears
+  // them like any other widget that went away if they aren't.
+  rendered = cur;                                                              // Remember what is on the screen now
+  rendered_valid = true;
+  pending_widgets = pending;
 
-    SPI.endTransaction();                                                                    // End the SPI transaction
+  SPI.endTransaction();                                                        // End the SPI transaction
+  STATS_FRAME( frame_start, !aborted );                                        // (the key latency only ends with a frame that got all the way through)
+  return !aborted;
 }
 
 /*******************************************
@@ -709,7 +1195,11 @@ void renderScreen(){
 *******************************************/
 
 void loop() {
-  hw.processEvents();
+  STATS_POLL();                                                                // Answers stats commands on the serial port (only in HEXCALC_STATS builds)
+  REMOTE_POLL();                                                               // Runs remote commands (only in HEXCALC_REMOTE builds)
+  hw.processEvents();                                                          // Runs the key handlers for everything in the key queue
+  if( screen_dirty && !REMOTE_HOLD() ) screen_dirty = !renderScreen();         // Then draws the result (again, if newer input cut it short, and not in the middle of a remote batch)
+  STATE_SAVE();                                                                // Saves the state in the background once the keys go idle
   if( millis() > screen_shutoff_time ){                                        // If the timer has breached the shutoff time
     digitalWrite( PIN_SCREEN_BLK, LOW );                                       // Turn the screen's backlight off
   } else {                                                                     // Otherwise
@@ -0,0 +1,301 @@
+#ifndef _ASSETS_H_
+#define _ASSETS_H_
+
+// Generated by host/assetgen.cpp from the draw functions in HexCalc.ino. Do not edit, run make in host/ instead.
+//
+// Each byte is a run of pixels, left to right and top to bottom: the top two bits are its color
+// (ASSET_*) and the low six its length less one. DxCore keeps const data in the memory-mapped
+// flash, so none of this takes up RAM.
+
+#include <stdint.h>
+
+#define ASSET_BLACK 0                                                          // Always black (e.g. the corners around a pill)
+#define ASSET_FG    1                                                          // The fg_color it was drawn with
+#define ASSET_BG    2                                                          // The bg_color it was drawn with
+
+struct Asset{
+  uint8_t        width, height;                                               // Size in pixels
+  uint16_t       runs;                                                        // Number of runs (bytes) in rle
+  const uint8_t *rle;
+};
+
+const uint8_t asset_tag_0[143] = {                                             // "OCT" tag, 30x16
+  0x03, 0x55, 0x05, 0x44, 0x82, 0x42, 0x82, 0x41, 0x84, 0x44, 0x03, 0x44, 0x82, 0x42, 0x82, 0x41,
+  0x84, 0x44, 0x02, 0x44, 0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x40, 0x80, 0x40, 0x80, 0x40,
+  0x80, 0x45, 0x01, 0x44, 0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x40, 0x80, 0x40, 0x80, 0x40,
+  0x80, 0x45, 0x00, 0x45, 0x80, 0x42, 0x80, 0x40, 0x80, 0x46, 0x80, 0x4E, 0x80, 0x42, 0x80, 0x40,
+  0x80, 0x46, 0x80, 0x4E, 0x80, 0x42, 0x80, 0x40, 0x80, 0x46, 0x80, 0x4E, 0x80, 0x42, 0x80, 0x40,
+  0x80, 0x46, 0x80, 0x4E, 0x80, 0x42, 0x80, 0x40, 0x80, 0x46, 0x80, 0x4E, 0x80, 0x42, 0x80, 0x40,
+  0x80, 0x46, 0x80, 0x48, 0x00, 0x44, 0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x42, 0x80, 0x47,
+  0x01, 0x44, 0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x42, 0x80, 0x47, 0x02, 0x44, 0x82, 0x42,
+  0x82, 0x43, 0x80, 0x46, 0x03, 0x44, 0x82, 0x42, 0x82, 0x43, 0x80, 0x46, 0x05, 0x55, 0x03
+};
+
+const uint8_t asset_tag_1[135] = {                                             // "DEC" tag, 30x16
+  0x03, 0x55, 0x05, 0x43, 0x83, 0x41, 0x84, 0x41, 0x82, 0x45, 0x03, 0x43, 0x83, 0x41, 0x84, 0x41,
+  0x82, 0x45, 0x02, 0x44, 0x80, 0x42, 0x80, 0x40, 0x80, 0x44, 0x80, 0x42, 0x80, 0x45, 0x01, 0x44,
+  0x80, 0x42, 0x80, 0x40, 0x80, 0x44, 0x80, 0x42, 0x80, 0x45, 0x00, 0x45, 0x80, 0x42, 0x80, 0x40,
+  0x80, 0x44, 0x80, 0x50, 0x80, 0x42, 0x80, 0x40, 0x80, 0x44, 0x80, 0x50, 0x80, 0x42, 0x80, 0x40,
+  0x83, 0x41, 0x80, 0x50, 0x80, 0x42, 0x80, 0x40, 0x83, 0x41, 0x80, 0x50, 0x80, 0x42, 0x80, 0x40,
+  0x80, 0x44, 0x80, 0x50, 0x80, 0x42, 0x80, 0x40, 0x80, 0x44, 0x80, 0x4A, 0x00, 0x44, 0x80, 0x42,
+  0x80, 0x40, 0x80, 0x44, 0x80, 0x42, 0x80, 0x45, 0x01, 0x44, 0x80, 0x42, 0x80, 0x40, 0x80, 0x44,
+  0x80, 0x42, 0x80, 0x45, 0x02, 0x43, 0x83, 0x41, 0x84, 0x41, 0x82, 0x45, 0x03, 0x43, 0x83, 0x41,
+  0x84, 0x41, 0x82, 0x45, 0x05, 0x55, 0x03
+};
+
+const uint8_t asset_tag_2[155] = {                                             // "HEX" tag, 30x16
+  0x03, 0x55, 0x05, 0x43, 0x80, 0x42, 0x80, 0x40, 0x84, 0x40, 0x80, 0x42, 0x80, 0x44, 0x03, 0x43,
+  0x80, 0x42, 0x80, 0x40, 0x84, 0x40, 0x80, 0x42, 0x80, 0x44, 0x02, 0x44, 0x80, 0x42, 0x80, 0x40,
+  0x80, 0x44, 0x80, 0x42, 0x80, 0x45, 0x01, 0x44, 0x80, 0x42, 0x80, 0x40, 0x80, 0x44, 0x80, 0x42,
+  0x80, 0x45, 0x00, 0x45, 0x80, 0x42, 0x80, 0x40, 0x80, 0x45, 0x80, 0x40, 0x80, 0x4D, 0x80, 0x42,
+  0x80, 0x40, 0x80, 0x45, 0x80, 0x40, 0x80, 0x4D, 0x84, 0x40, 0x83, 0x43, 0x80, 0x4E, 0x84, 0x40,
+  0x83, 0x43, 0x80, 0x4E, 0x80, 0x42, 0x80, 0x40, 0x80, 0x45, 0x80, 0x40, 0x80, 0x4D, 0x80, 0x42,
+  0x80, 0x40, 0x80, 0x45, 0x80, 0x40, 0x80, 0x47, 0x00, 0x44, 0x80, 0x42, 0x80, 0x40, 0x80, 0x44,
+  0x80, 0x42, 0x80, 0x45, 0x01, 0x44, 0x80, 0x42, 0x80, 0x40, 0x80, 0x44, 0x80, 0x42, 0x80, 0x45,
+  0x02, 0x43, 0x80, 0x42, 0x80, 0x40, 0x84, 0x40, 0x80, 0x42, 0x80, 0x44, 0x03, 0x43, 0x80, 0x42,
+  0x80, 0x40, 0x84, 0x40, 0x80, 0x42, 0x80, 0x44, 0x05, 0x55, 0x03
+};
+
+const uint8_t asset_tag_3[155] = {                                             // "888" tag, 30x16
+  0x03, 0x55, 0x05, 0x44, 0x82, 0x42, 0x82, 0x42, 0x82, 0x45, 0x03, 0x44, 0x82, 0x42, 0x82, 0x42,
+  0x82, 0x45, 0x02, 0x44, 0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x45,
+  0x01, 0x44, 0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x45, 0x00, 0x45,
+  0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x4C, 0x80, 0x42, 0x80, 0x40,
+  0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x4D, 0x82, 0x42, 0x82, 0x42, 0x82, 0x4E, 0x82, 0x42,
+  0x82, 0x42, 0x82, 0x4D, 0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x4C,
+  0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x46, 0x00, 0x44, 0x80, 0x42,
+  0x80, 0x40, 0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x45, 0x01, 0x44, 0x80, 0x42, 0x80, 0x40,
+  0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x45, 0x02, 0x44, 0x82, 0x42, 0x82, 0x42, 0x82, 0x45,
+  0x03, 0x44, 0x82, 0x42, 0x82, 0x42, 0x82, 0x45, 0x05, 0x55, 0x03
+};
+
+const uint8_t asset_tag_4[123] = {                                             // "565" tag, 30x16
+  0x03, 0x55, 0x05, 0x43, 0x84, 0x42, 0x82, 0x40, 0x84, 0x44, 0x03, 0x43, 0x84, 0x42, 0x82, 0x40,
+  0x84, 0x44, 0x02, 0x44, 0x80, 0x45, 0x80, 0x43, 0x80, 0x49, 0x01, 0x44, 0x80, 0x45, 0x80, 0x43,
+  0x80, 0x49, 0x00, 0x45, 0x83, 0x41, 0x80, 0x44, 0x83, 0x4D, 0x83, 0x41, 0x80, 0x44, 0x83, 0x51,
+  0x80, 0x40, 0x83, 0x45, 0x80, 0x50, 0x80, 0x40, 0x83, 0x45, 0x80, 0x50, 0x80, 0x40, 0x80, 0x42,
+  0x80, 0x44, 0x80, 0x50, 0x80, 0x40, 0x80, 0x42, 0x80, 0x44, 0x80, 0x46, 0x00, 0x44, 0x80, 0x42,
+  0x80, 0x40, 0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x45, 0x01, 0x44, 0x80, 0x42, 0x80, 0x40,
+  0x80, 0x42, 0x80, 0x40, 0x80, 0x42, 0x80, 0x45, 0x02, 0x44, 0x82, 0x42, 0x82, 0x42, 0x82, 0x45,
+  0x03, 0x44, 0x82, 0x42, 0x82, 0x42, 0x82, 0x45, 0x05, 0x55, 0x03
+};
+
+const uint8_t asset_op_0[25] = {                                             // " " operator tag, 24x16
+  0x03, 0x4F, 0x05, 0x53, 0x03, 0x53, 0x02, 0x55, 0x01, 0x55, 0x00, 0x7F, 0x7F, 0x4F, 0x00, 0x55,
+  0x01, 0x55, 0x02, 0x53, 0x03, 0x53, 0x05, 0x4F, 0x03
+};
+
+const uint8_t asset_op_1[43] = {                                             // "+" operator tag, 24x16
+  0x03, 0x4F, 0x05, 0x53, 0x03, 0x53, 0x02, 0x48, 0x81, 0x4A, 0x01, 0x48, 0x81, 0x4A, 0x00, 0x49,
+  0x81, 0x55, 0x81, 0x51, 0x89, 0x4D, 0x89, 0x51, 0x81, 0x55, 0x81, 0x4B, 0x00, 0x48, 0x81, 0x4A,
+  0x01, 0x48, 0x81, 0x4A, 0x02, 0x53, 0x03, 0x53, 0x05, 0x4F, 0x03
+};
+
+const uint8_t asset_op_2[27] = {                                             // "-" operator tag, 24x16
+  0x03, 0x4F, 0x05, 0x53, 0x03, 0x53, 0x02, 0x55, 0x01, 0x55, 0x00, 0x75, 0x89, 0x4D, 0x89, 0x77,
+  0x00, 0x55, 0x01, 0x55, 0x02, 0x53, 0x03, 0x53, 0x05, 0x4F, 0x03
+};
+
+const uint8_t asset_op_3[75] = {                                             // "X" operator tag, 24x16
+  0x03, 0x4F, 0x05, 0x43, 0x81, 0x45, 0x81, 0x45, 0x03, 0x43, 0x81, 0x45, 0x81, 0x45, 0x02, 0x44,
+  0x81, 0x45, 0x81, 0x46, 0x01, 0x44, 0x81, 0x45, 0x81, 0x46, 0x00, 0x47, 0x81, 0x41, 0x81, 0x51,
+  0x81, 0x41, 0x81, 0x53, 0x81, 0x55, 0x81, 0x53, 0x81, 0x41, 0x81, 0x51, 0x81, 0x41, 0x81, 0x49,
+  0x00, 0x44, 0x81, 0x45, 0x81, 0x46, 0x01, 0x44, 0x81, 0x45, 0x81, 0x46, 0x02, 0x43, 0x81, 0x45,
+  0x81, 0x45, 0x03, 0x43, 0x81, 0x45, 0x81, 0x45, 0x05, 0x4F, 0x03
+};
+
+const uint8_t asset_op_4[43] = {                                             // "/" operator tag, 24x16
+  0x03, 0x4F, 0x05, 0x53, 0x03, 0x53, 0x02, 0x4C, 0x81, 0x46, 0x01, 0x4C, 0x81, 0x46, 0x00, 0x4B,
+  0x81, 0x55, 0x81, 0x53, 0x81, 0x55, 0x81, 0x53, 0x81, 0x55, 0x81, 0x4D, 0x00, 0x44, 0x81, 0x4E,
+  0x01, 0x44, 0x81, 0x4E, 0x02, 0x53, 0x03, 0x53, 0x05, 0x4F, 0x03
+};
+
+const uint8_t asset_op_5[187] = {                                             // "MOD" operator tag, 48x16
+  0x03, 0x67, 0x05, 0x43, 0x81, 0x45, 0x81, 0x43, 0x85, 0x43, 0x87, 0x47, 0x03, 0x43, 0x81, 0x45,
+  0x81, 0x43, 0x85, 0x43, 0x87, 0x47, 0x02, 0x44, 0x83, 0x41, 0x83, 0x41, 0x81, 0x45, 0x81, 0x41,
+  0x81, 0x45, 0x81, 0x46, 0x01, 0x44, 0x83, 0x41, 0x83, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45,
+  0x81, 0x46, 0x00, 0x45, 0x81, 0x41, 0x81, 0x41, 0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45,
+  0x81, 0x4D, 0x81, 0x41, 0x81, 0x41, 0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x4D,
+  0x81, 0x41, 0x81, 0x41, 0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x4D, 0x81, 0x41,
+  0x81, 0x41, 0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x4D, 0x81, 0x41, 0x81, 0x41,
+  0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x4D, 0x81, 0x41, 0x81, 0x41, 0x81, 0x41,
+  0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x47, 0x00, 0x44, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45,
+  0x81, 0x41, 0x81, 0x45, 0x81, 0x46, 0x01, 0x44, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x41,
+  0x81, 0x45, 0x81, 0x46, 0x02, 0x43, 0x81, 0x45, 0x81, 0x43, 0x85, 0x43, 0x87, 0x47, 0x03, 0x43,
+  0x81, 0x45, 0x81, 0x43, 0x85, 0x43, 0x87, 0x47, 0x05, 0x67, 0x03
+};
+
+const uint8_t asset_op_6[131] = {                                             // "RoL" operator tag, 48x16
+  0x03, 0x67, 0x05, 0x43, 0x87, 0x4F, 0x81, 0x4D, 0x03, 0x43, 0x87, 0x4F, 0x81, 0x4D, 0x02, 0x44,
+  0x81, 0x45, 0x81, 0x4D, 0x81, 0x4E, 0x01, 0x44, 0x81, 0x45, 0x81, 0x4D, 0x81, 0x4E, 0x00, 0x45,
+  0x81, 0x45, 0x81, 0x43, 0x85, 0x43, 0x81, 0x55, 0x81, 0x45, 0x81, 0x43, 0x85, 0x43, 0x81, 0x55,
+  0x87, 0x43, 0x81, 0x45, 0x81, 0x41, 0x81, 0x55, 0x87, 0x43, 0x81, 0x45, 0x81, 0x41, 0x81, 0x55,
+  0x81, 0x41, 0x81, 0x45, 0x81, 0x45, 0x81, 0x41, 0x81, 0x55, 0x81, 0x41, 0x81, 0x45, 0x81, 0x45,
+  0x81, 0x41, 0x81, 0x4F, 0x00, 0x44, 0x81, 0x43, 0x81, 0x43, 0x81, 0x45, 0x81, 0x41, 0x81, 0x4E,
+  0x01, 0x44, 0x81, 0x43, 0x81, 0x43, 0x81, 0x45, 0x81, 0x41, 0x81, 0x4E, 0x02, 0x43, 0x81, 0x45,
+  0x81, 0x43, 0x85, 0x43, 0x89, 0x45, 0x03, 0x43, 0x81, 0x45, 0x81, 0x43, 0x85, 0x43, 0x89, 0x45,
+  0x05, 0x67, 0x03
+};
+
+const uint8_t asset_op_7[151] = {                                             // "RoR" operator tag, 48x16
+  0x03, 0x67, 0x05, 0x43, 0x87, 0x4F, 0x87, 0x47, 0x03, 0x43, 0x87, 0x4F, 0x87, 0x47, 0x02, 0x44,
+  0x81, 0x45, 0x81, 0x4D, 0x81, 0x45, 0x81, 0x46, 0x01, 0x44, 0x81, 0x45, 0x81, 0x4D, 0x81, 0x45,
+  0x81, 0x46, 0x00, 0x45, 0x81, 0x45, 0x81, 0x43, 0x85, 0x43, 0x81, 0x45, 0x81, 0x4D, 0x81, 0x45,
+  0x81, 0x43, 0x85, 0x43, 0x81, 0x45, 0x81, 0x4D, 0x87, 0x43, 0x81, 0x45, 0x81, 0x41, 0x87, 0x4F,
+  0x87, 0x43, 0x81, 0x45, 0x81, 0x41, 0x87, 0x4F, 0x81, 0x41, 0x81, 0x45, 0x81, 0x45, 0x81, 0x41,
+  0x81, 0x41, 0x81, 0x51, 0x81, 0x41, 0x81, 0x45, 0x81, 0x45, 0x81, 0x41, 0x81, 0x41, 0x81, 0x4B,
+  0x00, 0x44, 0x81, 0x43, 0x81, 0x43, 0x81, 0x45, 0x81, 0x41, 0x81, 0x43, 0x81, 0x48, 0x01, 0x44,
+  0x81, 0x43, 0x81, 0x43, 0x81, 0x45, 0x81, 0x41, 0x81, 0x43, 0x81, 0x48, 0x02, 0x43, 0x81, 0x45,
+  0x81, 0x43, 0x85, 0x43, 0x81, 0x45, 0x81, 0x45, 0x03, 0x43, 0x81, 0x45, 0x81, 0x43, 0x85, 0x43,
+  0x81, 0x45, 0x81, 0x45, 0x05, 0x67, 0x03
+};
+
+const uint8_t asset_op_8[79] = {                                             // "<<" operator tag, 36x16
+  0x03, 0x5B, 0x05, 0x4B, 0x81, 0x49, 0x81, 0x45, 0x03, 0x4B, 0x81, 0x49, 0x81, 0x45, 0x02, 0x4A,
+  0x81, 0x49, 0x81, 0x48, 0x01, 0x4A, 0x81, 0x49, 0x81, 0x48, 0x00, 0x49, 0x81, 0x49, 0x81, 0x55,
+  0x81, 0x49, 0x81, 0x53, 0x81, 0x49, 0x81, 0x55, 0x81, 0x49, 0x81, 0x57, 0x81, 0x49, 0x81, 0x55,
+  0x81, 0x49, 0x81, 0x4B, 0x00, 0x4A, 0x81, 0x49, 0x81, 0x48, 0x01, 0x4A, 0x81, 0x49, 0x81, 0x48,
+  0x02, 0x4B, 0x81, 0x49, 0x81, 0x45, 0x03, 0x4B, 0x81, 0x49, 0x81, 0x45, 0x05, 0x5B, 0x03
+};
+
+const uint8_t asset_op_9[79] = {                                             // ">>" operator tag, 36x16
+  0x03, 0x5B, 0x05, 0x45, 0x81, 0x49, 0x81, 0x4B, 0x03, 0x45, 0x81, 0x49, 0x81, 0x4B, 0x02, 0x48,
+  0x81, 0x49, 0x81, 0x4A, 0x01, 0x48, 0x81, 0x49, 0x81, 0x4A, 0x00, 0x4B, 0x81, 0x49, 0x81, 0x55,
+  0x81, 0x49, 0x81, 0x57, 0x81, 0x49, 0x81, 0x55, 0x81, 0x49, 0x81, 0x53, 0x81, 0x49, 0x81, 0x55,
+  0x81, 0x49, 0x81, 0x49, 0x00, 0x48, 0x81, 0x49, 0x81, 0x4A, 0x01, 0x48, 0x81, 0x49, 0x81, 0x4A,
+  0x02, 0x45, 0x81, 0x49, 0x81, 0x4B, 0x03, 0x45, 0x81, 0x49, 0x81, 0x4B, 0x05, 0x5B, 0x03
+};
+
+const uint8_t asset_op_10[179] = {                                             // "AND" operator tag, 48x16
+  0x03, 0x67, 0x05, 0x47, 0x81, 0x45, 0x81, 0x45, 0x81, 0x41, 0x87, 0x47, 0x03, 0x47, 0x81, 0x45,
+  0x81, 0x45, 0x81, 0x41, 0x87, 0x47, 0x02, 0x46, 0x81, 0x41, 0x81, 0x43, 0x81, 0x45, 0x81, 0x41,
+  0x81, 0x45, 0x81, 0x46, 0x01, 0x46, 0x81, 0x41, 0x81, 0x43, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45,
+  0x81, 0x46, 0x00, 0x45, 0x81, 0x45, 0x81, 0x41, 0x83, 0x43, 0x81, 0x41, 0x81, 0x45, 0x81, 0x4D,
+  0x81, 0x45, 0x81, 0x41, 0x83, 0x43, 0x81, 0x41, 0x81, 0x45, 0x81, 0x4D, 0x81, 0x45, 0x81, 0x41,
+  0x81, 0x41, 0x81, 0x41, 0x81, 0x41, 0x81, 0x45, 0x81, 0x4D, 0x81, 0x45, 0x81, 0x41, 0x81, 0x41,
+  0x81, 0x41, 0x81, 0x41, 0x81, 0x45, 0x81, 0x4D, 0x89, 0x41, 0x81, 0x43, 0x83, 0x41, 0x81, 0x45,
+  0x81, 0x4D, 0x89, 0x41, 0x81, 0x43, 0x83, 0x41, 0x81, 0x45, 0x81, 0x47, 0x00, 0x44, 0x81, 0x45,
+  0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x46, 0x01, 0x44, 0x81, 0x45, 0x81, 0x41,
+  0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x46, 0x02, 0x43, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45,
+  0x81, 0x41, 0x87, 0x47, 0x03, 0x43, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x87, 0x47,
+  0x05, 0x67, 0x03
+};
+
+const uint8_t asset_op_11[119] = {                                             // "OR" operator tag, 36x16
+  0x03, 0x5B, 0x05, 0x45, 0x85, 0x43, 0x87, 0x47, 0x03, 0x45, 0x85, 0x43, 0x87, 0x47, 0x02, 0x44,
+  0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x46, 0x01, 0x44, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45,
+  0x81, 0x46, 0x00, 0x45, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x4D, 0x81, 0x45, 0x81, 0x41,
+  0x81, 0x45, 0x81, 0x4D, 0x81, 0x45, 0x81, 0x41, 0x87, 0x4F, 0x81, 0x45, 0x81, 0x41, 0x87, 0x4F,
+  0x81, 0x45, 0x81, 0x41, 0x81, 0x41, 0x81, 0x51, 0x81, 0x45, 0x81, 0x41, 0x81, 0x41, 0x81, 0x4B,
+  0x00, 0x44, 0x81, 0x45, 0x81, 0x41, 0x81, 0x43, 0x81, 0x48, 0x01, 0x44, 0x81, 0x45, 0x81, 0x41,
+  0x81, 0x43, 0x81, 0x48, 0x02, 0x45, 0x85, 0x43, 0x81, 0x45, 0x81, 0x45, 0x03, 0x45, 0x85, 0x43,
+  0x81, 0x45, 0x81, 0x45, 0x05, 0x5B, 0x03
+};
+
+const uint8_t asset_op_12[179] = {                                             // "NOR" operator tag, 48x16
+  0x03, 0x67, 0x05, 0x43, 0x81, 0x45, 0x81, 0x43, 0x85, 0x43, 0x87, 0x47, 0x03, 0x43, 0x81, 0x45,
+  0x81, 0x43, 0x85, 0x43, 0x87, 0x47, 0x02, 0x44, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x41,
+  0x81, 0x45, 0x81, 0x46, 0x01, 0x44, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45,
+  0x81, 0x46, 0x00, 0x45, 0x83, 0x43, 0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x4D,
+  0x83, 0x43, 0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x4D, 0x81, 0x41, 0x81, 0x41,
+  0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x87, 0x4F, 0x81, 0x41, 0x81, 0x41, 0x81, 0x41, 0x81, 0x45,
+  0x81, 0x41, 0x87, 0x4F, 0x81, 0x43, 0x83, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x41, 0x81, 0x51,
+  0x81, 0x43, 0x83, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x41, 0x81, 0x4B, 0x00, 0x44, 0x81, 0x45,
+  0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x43, 0x81, 0x48, 0x01, 0x44, 0x81, 0x45, 0x81, 0x41,
+  0x81, 0x45, 0x81, 0x41, 0x81, 0x43, 0x81, 0x48, 0x02, 0x43, 0x81, 0x45, 0x81, 0x43, 0x85, 0x43,
+  0x81, 0x45, 0x81, 0x45, 0x03, 0x43, 0x81, 0x45, 0x81, 0x43, 0x85, 0x43, 0x81, 0x45, 0x81, 0x45,
+  0x05, 0x67, 0x03
+};
+
+const uint8_t asset_op_13[171] = {                                             // "XOR" operator tag, 48x16
+  0x03, 0x67, 0x05, 0x43, 0x81, 0x45, 0x81, 0x43, 0x85, 0x43, 0x87, 0x47, 0x03, 0x43, 0x81, 0x45,
+  0x81, 0x43, 0x85, 0x43, 0x87, 0x47, 0x02, 0x44, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x41,
+  0x81, 0x45, 0x81, 0x46, 0x01, 0x44, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45,
+  0x81, 0x46, 0x00, 0x47, 0x81, 0x41, 0x81, 0x43, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x4F,
+  0x81, 0x41, 0x81, 0x43, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x51, 0x81, 0x45, 0x81, 0x45,
+  0x81, 0x41, 0x87, 0x53, 0x81, 0x45, 0x81, 0x45, 0x81, 0x41, 0x87, 0x51, 0x81, 0x41, 0x81, 0x43,
+  0x81, 0x45, 0x81, 0x41, 0x81, 0x41, 0x81, 0x53, 0x81, 0x41, 0x81, 0x43, 0x81, 0x45, 0x81, 0x41,
+  0x81, 0x41, 0x81, 0x4B, 0x00, 0x44, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x43,
+  0x81, 0x48, 0x01, 0x44, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x43, 0x81, 0x48,
+  0x02, 0x43, 0x81, 0x45, 0x81, 0x43, 0x85, 0x43, 0x81, 0x45, 0x81, 0x45, 0x03, 0x43, 0x81, 0x45,
+  0x81, 0x43, 0x85, 0x43, 0x81, 0x45, 0x81, 0x45, 0x05, 0x67, 0x03
+};
+
+const uint8_t asset_op_error[147] = {                                             // "ERR" operator tag, 48x16
+  0x03, 0x67, 0x05, 0x43, 0x89, 0x41, 0x87, 0x43, 0x87, 0x47, 0x03, 0x43, 0x89, 0x41, 0x87, 0x43,
+  0x87, 0x47, 0x02, 0x44, 0x81, 0x49, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x46, 0x01, 0x44,
+  0x81, 0x49, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x46, 0x00, 0x45, 0x81, 0x49, 0x81, 0x45,
+  0x81, 0x41, 0x81, 0x45, 0x81, 0x4D, 0x81, 0x49, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x4D,
+  0x87, 0x43, 0x87, 0x43, 0x87, 0x4F, 0x87, 0x43, 0x87, 0x43, 0x87, 0x4F, 0x81, 0x49, 0x81, 0x41,
+  0x81, 0x45, 0x81, 0x41, 0x81, 0x51, 0x81, 0x49, 0x81, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x4B,
+  0x00, 0x44, 0x81, 0x49, 0x81, 0x43, 0x81, 0x43, 0x81, 0x43, 0x81, 0x48, 0x01, 0x44, 0x81, 0x49,
+  0x81, 0x43, 0x81, 0x43, 0x81, 0x43, 0x81, 0x48, 0x02, 0x43, 0x89, 0x41, 0x81, 0x45, 0x81, 0x41,
+  0x81, 0x45, 0x81, 0x45, 0x03, 0x43, 0x89, 0x41, 0x81, 0x45, 0x81, 0x41, 0x81, 0x45, 0x81, 0x45,
+  0x05, 0x67, 0x03
+};
+
+const uint8_t asset_dec_label_0[213] = {                                             // "HEX:" label, 60x24
+  0xBF, 0xBF, 0xB9, 0x41, 0x85, 0x41, 0x83, 0x49, 0x83, 0x41, 0x85, 0x41, 0x95, 0x41, 0x85, 0x41,
+  0x83, 0x49, 0x83, 0x41, 0x85, 0x41, 0x95, 0x41, 0x85, 0x41, 0x83, 0x49, 0x83, 0x41, 0x85, 0x41,
+  0x95, 0x41, 0x85, 0x41, 0x83, 0x41, 0x8B, 0x41, 0x85, 0x41, 0x95, 0x41, 0x85, 0x41, 0x83, 0x41,
+  0x8B, 0x41, 0x85, 0x41, 0x95, 0x41, 0x85, 0x41, 0x83, 0x41, 0x8B, 0x41, 0x85, 0x41, 0x95, 0x41,
+  0x85, 0x41, 0x83, 0x41, 0x8D, 0x41, 0x81, 0x41, 0x89, 0x41, 0x8B, 0x41, 0x85, 0x41, 0x83, 0x41,
+  0x8D, 0x41, 0x81, 0x41, 0x89, 0x41, 0x8B, 0x41, 0x85, 0x41, 0x83, 0x41, 0x8D, 0x41, 0x81, 0x41,
+  0x89, 0x41, 0x8B, 0x49, 0x83, 0x47, 0x89, 0x41, 0x99, 0x49, 0x83, 0x47, 0x89, 0x41, 0x99, 0x49,
+  0x83, 0x47, 0x89, 0x41, 0x99, 0x41, 0x85, 0x41, 0x83, 0x41, 0x8D, 0x41, 0x81, 0x41, 0x89, 0x41,
+  0x8B, 0x41, 0x85, 0x41, 0x83, 0x41, 0x8D, 0x41, 0x81, 0x41, 0x89, 0x41, 0x8B, 0x41, 0x85, 0x41,
+  0x83, 0x41, 0x8D, 0x41, 0x81, 0x41, 0x89, 0x41, 0x8B, 0x41, 0x85, 0x41, 0x83, 0x41, 0x8B, 0x41,
+  0x85, 0x41, 0x95, 0x41, 0x85, 0x41, 0x83, 0x41, 0x8B, 0x41, 0x85, 0x41, 0x95, 0x41, 0x85, 0x41,
+  0x83, 0x41, 0x8B, 0x41, 0x85, 0x41, 0x95, 0x41, 0x85, 0x41, 0x83, 0x49, 0x83, 0x41, 0x85, 0x41,
+  0x95, 0x41, 0x85, 0x41, 0x83, 0x49, 0x83, 0x41, 0x85, 0x41, 0x95, 0x41, 0x85, 0x41, 0x83, 0x49,
+  0x83, 0x41, 0x85, 0x41, 0x8F
+};
+
+const uint8_t asset_dec_label_1[195] = {                                             // "OCT:" label, 60x24
+  0xBF, 0xBF, 0xBB, 0x45, 0x87, 0x45, 0x85, 0x49, 0x97, 0x45, 0x87, 0x45, 0x85, 0x49, 0x97, 0x45,
+  0x87, 0x45, 0x85, 0x49, 0x95, 0x41, 0x85, 0x41, 0x83, 0x41, 0x85, 0x41, 0x83, 0x41, 0x81, 0x41,
+  0x81, 0x41, 0x95, 0x41, 0x85, 0x41, 0x83, 0x41, 0x85, 0x41, 0x83, 0x41, 0x81, 0x41, 0x81, 0x41,
+  0x95, 0x41, 0x85, 0x41, 0x83, 0x41, 0x85, 0x41, 0x83, 0x41, 0x81, 0x41, 0x81, 0x41, 0x95, 0x41,
+  0x85, 0x41, 0x83, 0x41, 0x8F, 0x41, 0x8B, 0x41, 0x8B, 0x41, 0x85, 0x41, 0x83, 0x41, 0x8F, 0x41,
+  0x8B, 0x41, 0x8B, 0x41, 0x85, 0x41, 0x83, 0x41, 0x8F, 0x41, 0x8B, 0x41, 0x8B, 0x41, 0x85, 0x41,
+  0x83, 0x41, 0x8F, 0x41, 0x99, 0x41, 0x85, 0x41, 0x83, 0x41, 0x8F, 0x41, 0x99, 0x41, 0x85, 0x41,
+  0x83, 0x41, 0x8F, 0x41, 0x99, 0x41, 0x85, 0x41, 0x83, 0x41, 0x8F, 0x41, 0x8B, 0x41, 0x8B, 0x41,
+  0x85, 0x41, 0x83, 0x41, 0x8F, 0x41, 0x8B, 0x41, 0x8B, 0x41, 0x85, 0x41, 0x83, 0x41, 0x8F, 0x41,
+  0x8B, 0x41, 0x8B, 0x41, 0x85, 0x41, 0x83, 0x41, 0x85, 0x41, 0x87, 0x41, 0x99, 0x41, 0x85, 0x41,
+  0x83, 0x41, 0x85, 0x41, 0x87, 0x41, 0x99, 0x41, 0x85, 0x41, 0x83, 0x41, 0x85, 0x41, 0x87, 0x41,
+  0x9B, 0x45, 0x87, 0x45, 0x89, 0x41, 0x9B, 0x45, 0x87, 0x45, 0x89, 0x41, 0x9B, 0x45, 0x87, 0x45,
+  0x89, 0x41, 0x93
+};
+
+const Asset tag_assets[5] = {                                                   // By tag_label
+  { 30, 16, 143, asset_tag_0 },
+  { 30, 16, 135, asset_tag_1 },
+  { 30, 16, 155, asset_tag_2 },
+  { 30, 16, 155, asset_tag_3 },
+  { 30, 16, 123, asset_tag_4 }
+};
+const Asset op_assets[14] = {                                                  // By op_command
+  { 24, 16, 25, asset_op_0 },
+  { 24, 16, 43, asset_op_1 },
+  { 24, 16, 27, asset_op_2 },
+  { 24, 16, 75, asset_op_3 },
+  { 24, 16, 43, asset_op_4 },
+  { 48, 16, 187, asset_op_5 },
+  { 48, 16, 131, asset_op_6 },
+  { 48, 16, 151, asset_op_7 },
+  { 36, 16, 79, asset_op_8 },
+  { 36, 16, 79, asset_op_9 },
+  { 48, 16, 179, asset_op_10 },
+  { 36, 16, 119, asset_op_11 },
+  { 48, 16, 179, asset_op_12 },
+  { 48, 16, 171, asset_op_13 }
+};
+const Asset op_error_asset = { 48, 16, 147, asset_op_error };
+const Asset dec_label_assets[2] = {                                             // HEX: and OCT:
+  { 60, 24, 213, asset_dec_label_0 },
+  { 60, 24, 195, asset_dec_label_1 }
+};
+
+// 2754 bytes of runs in all
+
+#endif
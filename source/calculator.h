@@ -32,6 +32,9 @@ the state of the current calculations on a button by button level.
 */
 
 
+#include "format.h"
+#include "wideint.h"
+
 /*******************************************
 * Calculator Class Definition              *
 *******************************************/
@@ -51,6 +54,7 @@ the state of the current calculations on a button by button level.
 #define OP_OR          11                                                      // Logically OR each bit of stored val with each bit of current val
 #define OP_NOR         12                                                      // Logically NOR each bit of stored val with each bit of current val
 #define OP_XOR         13                                                      // Logically XOR each bit of stored val with each bit of current val
+#define OP_COUNT       14                                                      // Number of operation identifiers
 
 // Bit Depth Modes:
 #define BIT_DEPTH_8  0x00000000000000FF                                        // Bit-mask for an 8-bit number
@@ -59,10 +63,160 @@ the state of the current calculations on a button by button level.
 #define BIT_DEPTH_32 0x00000000FFFFFFFF                                        // Bit-mask for an 32-bit number
 #define BIT_DEPTH_64 0xFFFFFFFFFFFFFFFF                                        // Bit-mask for an 64-bit number
 
+// Extended Precision:
+// KEY_128_BIT switches to WIDE_BITS-bit words held in WideInts (see wideint.h). They are too wide for
+// the display, so they are shown a page at a time: a 64-bit word per page in hex and octal, and
+// WIDE_DEC_PAGE digits per page in decimal. val_current and val_stored follow the low 64 bits of
+// the wide values, so anything that only looks at those keeps working in this mode.
+#ifndef WIDE_BITS
+#define WIDE_BITS 128                                                          // Width of the extended precision mode (128, 192 or 256)
+#endif
+static_assert( WIDE_BITS == 128 || WIDE_BITS == 192 || WIDE_BITS == 256, "WIDE_BITS must be 128, 192 or 256" );
+#define WIDE_DEC_DIGITS (WIDE_BITS * 30103UL / 100000 + 1)                     // Decimal digits of the largest wide value (log10(2) = 0.30103)
+#define WIDE_DEC_PAGE   18                                                     // Decimal digits per page (six groups of three)
+#define WIDE_DEC_LIMB   1000000000000000000ull                                 // 10^WIDE_DEC_PAGE
+typedef WideInt<WIDE_BITS / 8> WideWord;
+
 // RGB Color Modes:
 #define RGB_888 0                                                              // 24-bit color mode flag (8 bits each for red, green and blue)
 #define RGB_565 1                                                              // 16-bit color mode flag (5 bits red, 6 bits green, 5 bits blue)
 
+// Decimal Shadow:
+// The calculator can keep a packed-BCD copy of val_current and val_stored next to the binary values.
+// Digit entry, clear and allClear keep them up to date directly, so typing a decimal number never
+// has to convert the value back from binary. Anything else that changes a value leaves its shadow
+// behind, and decimal() converts it again the next time it is asked for.
+#ifndef BCD_SHADOW
+#define BCD_SHADOW 1                                                           // Set to 0 to convert from binary every time (saves a little RAM)
+#endif
+#define BCD_SHIFT_LIMIT 1844674407370955161ull                                 // Largest value that can take another decimal digit without passing 2^64 (if the digit is 5 or less)
+
+struct BCDShadow{
+  uint64_t value = 0;                                                          // The binary value the digits were made from
+  uint8_t  digits[BCD_BYTES] = {0};                                            // Packed BCD digits of value
+  bool     valid = true;                                                       // False once the digits no longer follow value
+};
+
+/*******************************************
+* Division                                 *
+*******************************************/
+// The AVR has no divide instruction. Every division is a library routine that takes a
+// shift/subtract step per bit of the word, so a 64-bit divide costs thousands of cycles even when
+// both operands are small. divideAdaptive() looks at the operands it is actually given and runs the
+// narrowest division that holds both of them. A power-of-two divisor is just a shift (or a mask for
+// the remainder), and a dividend smaller than the divisor needs no division at all.
+//
+// Dividing by zero is defined: the quotient is all ones and the remainder is the dividend, so
+// l == q * r + rem still holds. equals() raises CALC_ERROR_DIV_BY_ZERO so the display can show it.
+#define CALC_ERROR_NONE        0                                               // The last result is good
+#define CALC_ERROR_DIV_BY_ZERO 1                                               // The last result divided (or took the remainder) by zero
+
+template< typename N >
+inline N divideWords( N l, N r, bool remainder ){ return remainder ? l % r : l / r; } // One library division on N-sized words
+
+template< typename W >
+W divideAdaptive( W l, W r, bool remainder ){                                  // l / r, or l % r if remainder is set
+  if( r == 0 ) return remainder ? l : (W)~(W)0;                                // Division by zero (see above)
+  if( l < r ) return remainder ? l : 0;
+  if( (r & (r - 1)) == 0 ) return remainder ? l & (r - 1) : l >> __builtin_ctzll( r ); // Power of two: shift and mask
+  W both = l | r;                                                              // Run the narrowest division that holds both operands
+  if constexpr( sizeof(W) > 1 ) if( (both >> 8)  == 0 ) return divideWords<uint8_t>(  l, r, remainder );
+  if constexpr( sizeof(W) > 2 ) if( (both >> 16) == 0 ) return divideWords<uint16_t>( l, r, remainder );
+  if constexpr( sizeof(W) > 4 ) if( (both >> 32) == 0 ) return divideWords<uint32_t>( l, r, remainder );
+  return divideWords<W>( l, r, remainder );
+}
+
+/*******************************************
+* Width Kernels                            *
+*******************************************/
+// Each operation has a kernel for every bit depth, stamped out from the template below with the
+// smallest word type that holds the depth (24 bits rides in a uint32_t). The operands are cut down
+// to that word on the way in, so an 8-bit multiply is a single 8x8 multiply and a 16-bit divide
+// calls the 16-bit library routine, instead of everything running through 64-bit code and being
+// masked afterwards. setBitDepth*() points the Calculator at the table for its depth.
+//
+// Because the operands are truncated first, a result only ever depends on the bits the display
+// shows. Shifts by the word size or more give 0, and rotates wrap the count around the word.
+typedef uint64_t (*BinaryKernel)( uint64_t l_operand, uint64_t r_operand );   // Two-step operation
+typedef uint64_t (*UnaryKernel)( uint64_t val );                              // One-step operation
+
+struct CalcKernels{                                                            // All of the kernels for one bit depth
+  BinaryKernel binary[OP_COUNT];                                               // Indexed by op_command (OP_NONE has none)
+  UnaryKernel  leftShift, rightShift, rol, ror;
+  UnaryKernel  onesCompliment, twosCompliment, byteFlip, wordFlip;
+};
+
+template< typename W, uint8_t BITS >
+struct WidthKernels{
+  typedef decltype( (W)0 + 0u ) U;                                             // W, widened to at least unsigned int so the math never goes through (signed) int
+  static constexpr W MASK = (W)(~0ull >> (64 - BITS));                         // Mask for the bit depth (all of W except for 24 bits)
+
+  static W word( uint64_t val ){ return (W)val & MASK; }                       // Cuts an operand down to the bit depth
+
+  static uint64_t plus(     uint64_t l, uint64_t r ){ return (W)((U)word(l) + word(r)) & MASK; }
+  static uint64_t minus(    uint64_t l, uint64_t r ){ return (W)((U)word(l) - word(r)) & MASK; }
+  static uint64_t multiply( uint64_t l, uint64_t r ){ return (W)((U)word(l) * word(r)) & MASK; }
+  static uint64_t divide(   uint64_t l, uint64_t r ){ return divideAdaptive<W>( word(l), word(r), false ) & MASK; }
+  static uint64_t mod(      uint64_t l, uint64_t r ){ return divideAdaptive<W>( word(l), word(r), true ); }
+  static uint64_t andWith(  uint64_t l, uint64_t r ){ return word(l) & word(r); }
+  static uint64_t orWith(   uint64_t l, uint64_t r ){ return word(l) | word(r); }
+  static uint64_t norWith(  uint64_t l, uint64_t r ){ return (W)~(word(l) | word(r)) & MASK; }
+  static uint64_t xorWith(  uint64_t l, uint64_t r ){ return word(l) ^ word(r); }
+
+  static uint64_t leftShiftBy( uint64_t l, uint64_t r ){                       // Bits shifted past the top are gone
+    W n = word(r);
+    return n >= BITS ? 0 : (W)((U)word(l) << n) & MASK;
+  }
+  static uint64_t rightShiftBy( uint64_t l, uint64_t r ){
+    W n = word(r);
+    return n >= BITS ? 0 : word(l) >> n;
+  }
+  static uint64_t rolBy( uint64_t l, uint64_t r ){                             // Rotates wrap the count around the word
+    uint8_t n = word(r) % BITS;
+    W v = word(l);
+    return n == 0 ? v : (W)(((U)v << n) | (v >> (BITS - n))) & MASK;
+  }
+  static uint64_t rorBy( uint64_t l, uint64_t r ){
+    uint8_t n = word(r) % BITS;
+    W v = word(l);
+    return n == 0 ? v : (W)((v >> n) | ((U)v << (BITS - n))) & MASK;
+  }
+
+  static uint64_t leftShift( uint64_t val ){  return (W)((U)word(val) << 1) & MASK; }
+  static uint64_t rightShift( uint64_t val ){ return word(val) >> 1; }
+  static uint64_t rol( uint64_t val ){ W v = word(val); return (W)(((U)v << 1) | (v >> (BITS - 1))) & MASK; }
+  static uint64_t ror( uint64_t val ){ W v = word(val); return (W)((v >> 1) | ((U)v << (BITS - 1))) & MASK; }
+  static uint64_t onesCompliment( uint64_t val ){ return (W)~word(val) & MASK; }
+  static uint64_t twosCompliment( uint64_t val ){ return (W)(0u - (U)word(val)) & MASK; }
+
+  static uint64_t byteFlip( uint64_t val ){                                    // Reverses the order of the bytes (an 8-bit value is left alone)
+    if constexpr( BITS == 8 ) return val;
+    else {
+      W v = word(val), flipped = 0;
+      for( uint8_t i = 0; i < BITS / 8; i++ ){ flipped = (U)flipped << 8 | (v & 0xFF); v = (U)v >> 8; }
+      return flipped;
+    }
+  }
+  static uint64_t wordFlip( uint64_t val ){                                    // Reverses the order of the two-byte words (8 and 16-bit values are left alone)
+    if constexpr( BITS <= 16 ) return val;
+    else if constexpr( BITS == 24 ) return (W)((word(val) >> 16) | ((U)word(val) << 8)) & MASK; // Not a real word flip, but rotating the color channels is handy in 24-bit mode
+    else {
+      W v = word(val), flipped = 0;
+      for( uint8_t i = 0; i < BITS / 16; i++ ){ flipped = (U)flipped << 16 | (v & 0xFFFF); v = (U)v >> 16; }
+      return flipped;
+    }
+  }
+
+  static const CalcKernels table;
+};
+
+template< typename W, uint8_t BITS >
+const CalcKernels WidthKernels<W, BITS>::table = {
+  { NULL, plus, minus, multiply, divide, mod, rolBy, rorBy,                   // In OP_* order
+    leftShiftBy, rightShiftBy, andWith, orWith, norWith, xorWith },
+  leftShift, rightShift, rol, ror,
+  onesCompliment, twosCompliment, byteFlip, wordFlip
+};
 
 
 
@@ -72,28 +226,62 @@ class Calculator{
     uint64_t val_stored  = 0;                                                  // Value currently stored for an operation
     uint64_t val_result  = 0;                                                  // Value storing the result of the last operation
     uint8_t  op_command = OP_NONE;                                             // Currently selected operator
+    uint8_t  error = CALC_ERROR_NONE;                                          // CALC_ERROR_* of the last result (the key after it clears it)
 
     uint64_t bitMask = BIT_DEPTH_16;                                           // bitMask for the currently selected bit-depth
-    uint8_t  bitDepth = 16;                                                    // currently selected bitDepth (can be 8, 16, 24, 32, 64)
+    uint16_t bitDepth = 16;                                                    // currently selected bitDepth (can be 8, 16, 24, 32, 64 or WIDE_BITS)
+    const CalcKernels *kernels = &WidthKernels<uint16_t, 16>::table;           // Operation kernels for the selected bitDepth
     uint8_t  base = 16;                                                        // currently selected base (can be 8-octal, 10-decimal, 16-hexidecimal)
 
     uint8_t  color_mode = RGB_888;                                             // currently selected color mode (RGB_888 or RGB_565)
     bool     store_flag = false;                                               // Flag that indicates whether new number keys should trigger a store of the current value
     bool     result_active = false;                                            // Flag that indicates if the equals was just pressed
 
+    BCDShadow bcd_current;                                                     // Packed-BCD shadow of val_current
+    BCDShadow bcd_stored;                                                      // Packed-BCD shadow of val_stored
+    BCDShadow bcd_scratch;                                                     // Holds conversions of any other value
+
+    WideWord wide_current = {};                                                // Extended precision copies of the values (only kept up to date in that mode)
+    WideWord wide_stored  = {};
+    WideWord wide_result  = {};
+    uint8_t  page = 0;                                                         // Page of the wide values on the display (0 is the least significant)
+
   public:
     Calculator(){ setBitDepth16(); setBase16(); setColorMode565(); };          // Constructor
 
     // Mode Selection
-    void setBitDepth8(){  bitDepth = 8;  bitMask = BIT_DEPTH_8;   }            // Select a bitDepth of 8-bits
-    void setBitDepth16(){ bitDepth = 16; bitMask = BIT_DEPTH_16; }             // Select a bitDepth of 16-bits
-    void setBitDepth24(){ bitDepth = 24; bitMask = BIT_DEPTH_24; }             // Select a bitDepth of 24-bits
-    void setBitDepth32(){ bitDepth = 32; bitMask = BIT_DEPTH_32; }             // Select a bitDepth of 32-bits
-    void setBitDepth64(){ bitDepth = 64; bitMask = BIT_DEPTH_64; }             // Select a bitDepth of 64-bits
+    void setBitDepth8(){  bitDepth = 8;  bitMask = BIT_DEPTH_8;  kernels = &WidthKernels<uint8_t,   8>::table; } // Select a bitDepth of 8-bits
+    void setBitDepth16(){ bitDepth = 16; bitMask = BIT_DEPTH_16; kernels = &WidthKernels<uint16_t, 16>::table; } // Select a bitDepth of 16-bits
+    void setBitDepth24(){ bitDepth = 24; bitMask = BIT_DEPTH_24; kernels = &WidthKernels<uint32_t, 24>::table; } // Select a bitDepth of 24-bits
+    void setBitDepth32(){ bitDepth = 32; bitMask = BIT_DEPTH_32; kernels = &WidthKernels<uint32_t, 32>::table; } // Select a bitDepth of 32-bits
+    void setBitDepth64(){ bitDepth = 64; bitMask = BIT_DEPTH_64; kernels = &WidthKernels<uint64_t, 64>::table; } // Select a bitDepth of 64-bits
+    void setBitDepthWide(){                                                    // Select the extended precision mode (WIDE_BITS bits)
+      if( !wide() ){ wide_current.set( val_current ); wide_stored.set( val_stored ); wide_result.set( val_result ); }
+      bitDepth = WIDE_BITS; bitMask = BIT_DEPTH_64; kernels = &WidthKernels<uint64_t, 64>::table; page = 0;
+    }
+
+    void setBase8(){  base =  8; page = 0; }                                   // Set base to 8-bit  (octal)
+    void setBase10(){ base = 10; page = 0; }                                   // Set base to 10-bit (decimal)
+    void setBase16(){ base = 16; page = 0; }                                   // Set base to 16-bit (hexidecimal)
+
+    // Extended Precision Display
+    bool    wide() const { return bitDepth > 64; }                             // True in the extended precision mode
+    uint8_t displayDepth() const { return wide() ? 64 : bitDepth; }            // Bits shown at once (a page's worth in the extended precision mode)
+    uint8_t pages() const {                                                    // Number of pages the value is shown in
+      if( !wide() ) return 1;
+      return base == 10 ? (WIDE_DEC_DIGITS + WIDE_DEC_PAGE - 1) / WIDE_DEC_PAGE : WIDE_BITS / 64;
+    }
+    void    nextPage(){ page = (page + 1) % pages(); }                         // Moves on to the next page (wrapping back around to the first)
 
-    void setBase8(){  base =  8; }                                             // Set base to 8-bit  (octal)
-    void setBase10(){ base = 10; }                                             // Set base to 10-bit (decimal)
-    void setBase16(){ base = 16; }                                             // Set base to 16-bit (hexidecimal)
+    uint64_t pageValue( const WideWord &val ) const {                          // The part of val on the current page (a 64-bit word, or WIDE_DEC_PAGE decimal digits)
+      if( base != 10 ) return val.word( page );
+      WideWord rest = val;
+      for( uint8_t i = 0; i < page; i++ ) rest.divide64( WIDE_DEC_LIMB );
+      return rest.divide64( WIDE_DEC_LIMB );
+    }
+    uint64_t pageWord( const WideWord &val ) const {                           // The 64-bit word of val closest to the current page
+      return val.word( page < WIDE_BITS / 64 ? page : WIDE_BITS / 64 - 1 );
+    }
 
     void setColorMode888(){                                                    // Set color mode to 24-bit color mode
       setBitDepth24();                                                         // Change the bit depth to 24 bits
@@ -123,11 +311,37 @@ class Calculator{
     void enterDigit( uint8_t digit ){                                          // Adds a digit to the current value
       if( store_flag ) store();                                                // If the delayed store flag was set, then we need to store the current value and start a new one
       result_active = false;                                                   // Reset the equals flag so we know that val_current no longer represents the result
+      if( wide() ){                                                            // Extended precision mode: the same thing, on the wide value
+        wide_current.mulSmall( base );
+        wide_current.addSmall( digit );
+        val_current = wide_current.word( 0 );
+        bcd_current.valid = false;
+        return;
+      }
+      bool shift_bcd = BCD_SHADOW && base == 10 && digit <= 9 && shadows( bcd_current, val_current ) && // The decimal shadow can follow along if the digit is decimal, it is up to date
+                       ( val_current < BCD_SHIFT_LIMIT || (val_current == BCD_SHIFT_LIMIT && digit <= 5) ); // and the binary value won't wrap around
       val_current = val_current * base + digit;                                // Multiply by the base to shift the value over one digit and add the new digit
+      if( shift_bcd ){ bcdShiftIn( bcd_current.digits, digit ); bcd_current.value = val_current; }
+      else bcd_current.valid = false;
+    }
+    void store(){    val_stored = val_current; val_current = 0; store_flag    = false; bcd_stored = bcd_current; bcd_current = BCDShadow(); wide_stored = wide_current; wide_current.clear();} // Store the current value 
+    void clear(){                              val_current = 0; result_active = false; bcd_current = BCDShadow(); wide_current.clear();} // Clear the current value
+    void allClear(){ val_stored = 0;           val_current = 0; result_active = false; op_command = OP_NONE; bcd_stored = BCDShadow(); bcd_current = BCDShadow(); wide_stored.clear(); wide_current.clear();} // Clear ALL values
+
+    // Decimal Shadow
+    static bool shadows( const BCDShadow &shadow, uint64_t val ){ return shadow.valid && shadow.value == val; } // True if shadow holds the digits of val
+
+    const uint8_t *decimal( uint64_t val ){                                    // Packed BCD digits of val (straight from a shadow when one is up to date)
+      if( BCD_SHADOW && shadows( bcd_current, val ) ) return bcd_current.digits;
+      if( BCD_SHADOW && shadows( bcd_stored,  val ) ) return bcd_stored.digits;
+      BCDShadow &shadow = !BCD_SHADOW         ? bcd_scratch :                  // Otherwise convert it, and keep the result as the shadow
+                          val == val_current  ? bcd_current :                  // if it belongs to one of the values
+                          val == val_stored   ? bcd_stored  : bcd_scratch;
+      bcdFromBinary( val, shadow.digits );
+      shadow.value = val;
+      shadow.valid = true;
+      return shadow.digits;
     }
-    void store(){    val_stored = val_current; val_current = 0; store_flag    = false;} // Store the current value 
-    void clear(){                              val_current = 0; result_active = false;} // Clear the current value
-    void allClear(){ val_stored = 0;           val_current = 0; result_active = false; op_command = OP_NONE;} // Clear ALL values
 
     // Two-step Math Functions
     void plusBy(){       store_flag = true; result_active = false; op_command = OP_PLUS;        } // Set the operator for addition
@@ -148,61 +362,15 @@ class Calculator{
 
 
     // One-step Math Functions
-    void leftShift(){  val_current = (val_current << 1) & bitMask; }           // Left shift the current value by one bit
-    void rightShift(){ val_current = (val_current >> 1) & bitMask; }           // Right shift the current value by one bit
-    void rol(){ val_current = (val_current << 1) | ((val_current >> (bitDepth-1)) & 0b1); }     // Left rotate by one bit
-    void ror(){ val_current = (val_current >> 1) | ((val_current << (bitDepth-1)) & bitMask); } // Right rotate by one bit
-    void onesCompliment(){ val_current = (~val_current) & bitMask; }           // Calculate the 1's compliment of the current value
-    void twosCompliment(){ val_current = (~val_current + 1) & bitMask; }       // Calculate the 2's compliment of the current value
-
-    void byteFlip(){                                                           // Reverse the order of the bytes in current value
-      switch( bitDepth ){                                                      // The byte flipping depends on the bit depth
-        case 16:                                                               // If 16 bit number, just swap the two bytes. (note: can't byte flip in 8-bit mode)
-          val_current = ((val_current << 8) | (val_current >> 8)) & bitMask;   // Move the last byte left by one byte and the second to last byte right
-          break;
-        case 24:                                                               // If 24 bit number
-          val_current = (( val_current & 0xFF0000 ) >> 24 ) |                  // Move byte 2 into byte 0
-                        (( val_current & 0x00FF00 ) << 0  ) |                  // Move byte 1 into byte 1
-                        (( val_current & 0x0000FF ) << 24 );                   // Move byte 0 into byte 2
-          break;
-        case 32:                                                               // If 32 bit number
-          val_current = (( val_current & 0xFF000000 ) >> 24 ) |                // Move byte 3 into byte 0
-                        (( val_current & 0x00FF0000 ) >> 8  ) |                // Move byte 2 into byte 1
-                        (( val_current & 0x0000FF00 ) << 8  ) |                // Move byte 1 into byte 2
-                        (( val_current & 0x000000FF ) << 24 );                 // Move byte 0 into byte 3
-          break;
-        case 64:                                                               // If 64 bit number
-          val_current = (( val_current & 0xFF00000000000000 ) >> 56 ) |        // Move byte 7 into byte 0
-                        (( val_current & 0x00FF000000000000 ) >> 40 ) |        // Move byte 6 into byte 1
-                        (( val_current & 0x0000FF0000000000 ) >> 24 ) |        // Move byte 5 into byte 2
-                        (( val_current & 0x000000FF00000000 ) >> 8  ) |        // Move byte 4 into byte 3
-                        (( val_current & 0x00000000FF000000 ) << 8  ) |        // Move byte 3 into byte 4
-                        (( val_current & 0x0000000000FF0000 ) << 24 ) |        // Move byte 2 into byte 5
-                        (( val_current & 0x000000000000FF00 ) << 40 ) |        // Move byte 1 into byte 6
-                        (( val_current & 0x00000000000000FF ) << 56 );         // Move byte 0 into byte 7
-          break;
-      }
-      val_current = val_current; 
-    }
-
-    void wordFlip(){                                                           // Reverse the order of two-byte words in current value
-      switch( bitDepth ){                                                      // For 8 and 16 bits, do nothing. But for 32/64 bits:
-        case 24:                                                               // If 24 bits - Not really a real word flip, but useful for color swaps (rotates color channels)
-          val_current = (( val_current & 0xFF0000 ) >> 16 ) |                  // Move bytes 2 into positions 0 
-                        (( val_current & 0x00FFFF ) <<  8 );                   // Move bytes 1 and 0 into positions 2 and 1 
-          break;
-        case 32:                                                               // If 32 bits
-          val_current = (( val_current & 0xFFFF0000 ) >> 16 ) |                // Move bytes 3 and 2 into positions 1 and 0 
-                        (( val_current & 0x0000FFFF ) << 16 );                 // Move bytes 1 and 0 into positions 3 and 2 
-          break;
-        case 64:                                                               // If 64 bits
-          val_current = (( val_current & 0xFFFF000000000000 ) >> 48 ) |        // Move bytes 7 and 6 into positions 1 and 0 
-                        (( val_current & 0x0000FFFF00000000 ) >> 16 ) |        // Move bytes 5 and 4 into positions 3 and 2 
-                        (( val_current & 0x00000000FFFF0000 ) << 16 ) |        // Move bytes 3 and 2 into positions 5 and 4 
-                        (( val_current & 0x000000000000FFFF ) << 48 );         // Move bytes 1 and 0 into positions 7 and 6 
-          break;
-      }
-    }
+    void leftShift(){      if( wide() ){ wide_current.shiftLeft( 1 );   wideDone(); } else val_current = kernels->leftShift( val_current );      } // Left shift the current value by one bit
+    void rightShift(){     if( wide() ){ wide_current.shiftRight( 1 );  wideDone(); } else val_current = kernels->rightShift( val_current );     } // Right shift the current value by one bit
+    void rol(){            if( wide() ){ wide_current.rotateLeft( 1 );  wideDone(); } else val_current = kernels->rol( val_current );            } // Left rotate by one bit
+    void ror(){            if( wide() ){ wide_current.rotateRight( 1 ); wideDone(); } else val_current = kernels->ror( val_current );            } // Right rotate by one bit
+    void onesCompliment(){ if( wide() ){ wide_current.invert();         wideDone(); } else val_current = kernels->onesCompliment( val_current ); } // Calculate the 1's compliment of the current value
+    void twosCompliment(){ if( wide() ){ wide_current.negate();         wideDone(); } else val_current = kernels->twosCompliment( val_current ); } // Calculate the 2's compliment of the current value
+    void byteFlip(){       if( wide() ){ wide_current.byteFlip();       wideDone(); } else val_current = kernels->byteFlip( val_current );       } // Reverse the order of the bytes in current value
+    void wordFlip(){       if( wide() ){ wide_current.wordFlip();       wideDone(); } else val_current = kernels->wordFlip( val_current );       } // Reverse the order of two-byte words in current value (rotates the color channels in 24-bit mode)
+    void wideDone(){ val_current = wide_current.word( 0 ); }                  // Brings val_current back in line with the wide value
 
     void incRed(){                                                                      // Increment the portion of val_current related to the red channel
       if( color_mode == RGB_888 ){                                                      // If 24-bit color mode
@@ -210,6 +378,7 @@ class Calculator{
       } else {                                                                          // If 16-bit color mode
         val_current = ((val_current + 0x0800) & 0xF800) | (val_current & 0x07FF);       // Only increment bits 11 through 15
       }
+      if( wide() ) wide_current.setWord( 0, val_current );                             // Keep the wide value in step
     }
     void decRed(){                                                                      // Decrement the portion of val_current related to the red channel
       if( color_mode == RGB_888 ){                                                      // If 24-bit color mode
@@ -217,6 +386,7 @@ class Calculator{
       } else {                                                                          // If 16-bit color mode
         val_current = ((val_current - 0x0800) & 0xF800) | (val_current & 0x07FF);       // Only decrement bits 11 through 15 
       }
+      if( wide() ) wide_current.setWord( 0, val_current );                             // Keep the wide value in step
     }
     void incGreen(){                                                                    // Increment the portion of val_current related to the green channel
       if( color_mode == RGB_888 ){                                                      // If 24-bit color mode
@@ -224,6 +394,7 @@ class Calculator{
       } else {                                                                          // If 16-bit color mode
         val_current = ((val_current + 0x0020) & 0x07E0) | (val_current & 0xF81F);       // Only increment bits 5 through 10
       }
+      if( wide() ) wide_current.setWord( 0, val_current );                             // Keep the wide value in step
     }
     void decGreen(){                                                                    // Decrement the portion of val_current related to the green channel
       if( color_mode == RGB_888 ){                                                      // If 24-bit color mode
@@ -231,6 +402,7 @@ class Calculator{
       } else {                                                                          // If 16-bit color mode
         val_current = ((val_current - 0x0020) & 0x07E0) | (val_current & 0xF81F);       // Only decrement bits 5 through 10
       }
+      if( wide() ) wide_current.setWord( 0, val_current );                             // Keep the wide value in step
     }
     void incBlue(){                                                                     // Increment the portion of val_current related to the blue channel
       if( color_mode == RGB_888 ){                                                      // If 24-bit color mode
@@ -238,6 +410,7 @@ class Calculator{
       } else {                                                                          // If 16-bit color mode
         val_current = ((val_current + 0x0001) & 0x001F) | (val_current & 0xFFE0);       // Only increment bits 0 through 4
       }
+      if( wide() ) wide_current.setWord( 0, val_current );                             // Keep the wide value in step
     }
     void decBlue(){                                                                     // Decrement the portion of val_current related to the blue channel
       if( color_mode == RGB_888 ){                                                      // If 24-bit color mode
@@ -245,9 +418,11 @@ class Calculator{
       } else {                                                                          // If 16-bit color mode
         val_current = ((val_current - 0x0001) & 0x001F) | (val_current & 0xFFE0);       // Only decrement bits 0 through 4
       }
+      if( wide() ) wide_current.setWord( 0, val_current );                             // Keep the wide value in step
     }
 
     void equals(){                                                                      // Perform the op_command on val_current and val_stored, and save in val_result
+      if( wide() ){ wideEquals(); return; }                                             // The extended precision mode has its own version
       uint64_t l_operand, r_operand;                                                    // Temporary stores for the left and right operands
       if( result_active ){                                                              // See if the result of the last calculation is still stored in val_current
         r_operand = val_stored;                                                         // If it is, then the use the val_stored as the right operand
@@ -256,26 +431,50 @@ class Calculator{
         l_operand = val_stored;                                                         // Use val_stored as the left operand
         r_operand = val_current;                                                        // and val_current as the right operand so it functions like a calculator normally would.
       }
-      switch( op_command ){                                                             // Based on the op_command, execute operations that require both the current and stored operators
-        case OP_PLUS:        val_result =  (l_operand +  r_operand) & bitMask; break;   // Add two numbers together and truncate based on the bit-depth
-        case OP_MINUS:       val_result =  (l_operand -  r_operand) & bitMask; break;   // Subtract right number from left and truncate based on the bit-depth
-        case OP_MULTIPLY:    val_result =  (l_operand *  r_operand) & bitMask; break;   // Multiply two numbers together and truncate based on the bit-depth
-        case OP_DIVIDE:      val_result =  (l_operand /  r_operand) & bitMask; break;   // Divide right number from left and truncate based on the bit-depth
-        case OP_MOD:         val_result =  (l_operand %  r_operand) & bitMask; break;   // Mod right number from left number and truncate based on the bit-depth
-        case OP_LEFT_SHIFT:  val_result =  (l_operand << r_operand) & bitMask; break;   // Left shift the left number by right number's bits and truncate based on the bit-depth
-        case OP_RIGHT_SHIFT: val_result =  (l_operand >> r_operand) & bitMask; break;   // Right shift the left number by right number's bits and truncate based on the bit-depth
-        case OP_AND:         val_result =  (l_operand &  r_operand) & bitMask; break;   // AND two numbers together and truncate based on the bit-depth
-        case OP_OR:          val_result =  (l_operand |  r_operand) & bitMask; break;   // OR  two numbers together and truncate based on the bit-depth
-        case OP_NOR:         val_result = ~(l_operand |  r_operand) & bitMask; break;   // NOR two numbers together and truncate based on the bit-depth
-        case OP_XOR:         val_result =  (l_operand ^  r_operand) & bitMask; break;   // XOR two numbers together and truncate based on the bit-depth
-        case OP_ROL: val_result = ((l_operand << r_operand) & bitMask) | ((l_operand >> (bitDepth - r_operand)) & bitMask); break; // Left rotate right number by left number digits
-        case OP_ROR: val_result = ((l_operand >> r_operand) & bitMask) | ((l_operand << (bitDepth - r_operand)) & bitMask); break; // Right rotate the right number by left number digits
-      }
-      if( !result_active ) val_stored = val_current;                                    // If the result isn't already active, then save the current value into the stored value
+      bool divides = op_command == OP_DIVIDE || op_command == OP_MOD;
+      error = divides && (r_operand & bitMask) == 0 ? CALC_ERROR_DIV_BY_ZERO : CALC_ERROR_NONE; // Flag a division by zero (the kernel still gives a defined result)
+      if( op_command != OP_NONE ) val_result = kernels->binary[op_command]( l_operand, r_operand ); // Run the op_command's kernel for the current bit-depth
+      if( !result_active ){ val_stored = val_current; bcd_stored = bcd_current; }       // If the result isn't already active, then save the current value into the stored value
       result_active = true;                                                             // Set the result_active flag to true
       val_current = val_result;                                                         // Save the result into the val_current
     }
 
+    void wideEquals(){                                                                  // equals() for the extended precision mode
+      const WideWord &l_operand = result_active ? wide_current : wide_stored;           // Operands are picked the same way as in equals()
+      const WideWord &r_operand = result_active ? wide_stored  : wide_current;
+      bool divides = op_command == OP_DIVIDE || op_command == OP_MOD;
+      error = divides && r_operand.isZero() ? CALC_ERROR_DIV_BY_ZERO : CALC_ERROR_NONE;
+      WideWord rem, count;
+      switch( op_command ){
+        case OP_PLUS:        wide_result = l_operand; wide_result.add( r_operand );     break;
+        case OP_MINUS:       wide_result = l_operand; wide_result.sub( r_operand );     break;
+        case OP_MULTIPLY:    wide_result.mul( l_operand, r_operand );                   break;
+        case OP_DIVIDE:
+        case OP_MOD:
+          wide_result = l_operand;
+          if( r_operand.isZero() ){                                                     // Same defined result as divideAdaptive(): all ones, remainder = dividend
+            if( op_command == OP_DIVIDE ){ wide_result.clear(); wide_result.invert(); }
+            break;
+          }
+          wide_result.divide( r_operand, rem );
+          if( op_command == OP_MOD ) wide_result = rem;
+          break;
+        case OP_LEFT_SHIFT:  wide_result = l_operand; wide_result.shiftLeft(  r_operand.below( WIDE_BITS ) ? r_operand.b[0] | (r_operand.b[1] << 8) : WIDE_BITS ); break;
+        case OP_RIGHT_SHIFT: wide_result = l_operand; wide_result.shiftRight( r_operand.below( WIDE_BITS ) ? r_operand.b[0] | (r_operand.b[1] << 8) : WIDE_BITS ); break;
+        case OP_ROL:         count = r_operand; wide_result = l_operand; wide_result.rotateLeft(  count.divide64( WIDE_BITS ) ); break; // Rotates wrap the count around the word
+        case OP_ROR:         count = r_operand; wide_result = l_operand; wide_result.rotateRight( count.divide64( WIDE_BITS ) ); break;
+        case OP_AND:         wide_result = l_operand; wide_result.andWith( r_operand ); break;
+        case OP_OR:          wide_result = l_operand; wide_result.orWith( r_operand );  break;
+        case OP_NOR:         wide_result = l_operand; wide_result.orWith( r_operand ); wide_result.invert(); break;
+        case OP_XOR:         wide_result = l_operand; wide_result.xorWith( r_operand ); break;
+      }
+      if( !result_active ){ wide_stored = wide_current; val_stored = val_current; bcd_stored = bcd_current; } // Same bookkeeping as equals()
+      result_active = true;
+      wide_current = wide_result;
+      val_result   = wide_result.word( 0 );
+      val_current  = val_result;
+    }
+
 };
 
 
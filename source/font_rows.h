@@ -0,0 +1,341 @@
+#ifndef _FONT_ROWS_H_
+#define _FONT_ROWS_H_
+
+// Generated by host/fontgen.cpp from font.h. Do not edit, run make in host/ instead.
+//
+// The glyphs are stored row-major: glyph c's rows are font_rows[c*CHAR_HEIGHT] onwards, with
+// column 0 in the top bit of each row, so a rasterizer reads one byte per glyph row and walks the
+// columns with a left shift. DxCore keeps const data in the memory-mapped flash, so none of this
+// takes up RAM. Define FONT_SUBSET to build with only the characters in FONT_SUBSET_CHARS
+// (anything else draws as a space, which blanks most of the ASCII column of the binary menu).
+
+#include <stdint.h>
+
+#define CHAR_WIDTH  6
+#define CHAR_HEIGHT 7
+
+#define FONT_SUBSET_CHARS " +,-/0123456789:<>ABCDEFHLMNORTXo"
+
+const uint8_t font_rows[256 * CHAR_HEIGHT] = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 0x00
+  0x70, 0xF8, 0xA8, 0xF8, 0xD8, 0x88, 0x70,  // 0x01
+  0x70, 0xF8, 0xA8, 0xF8, 0x88, 0xD8, 0x70,  // 0x02
+  0x00, 0x50, 0xF8, 0xF8, 0xF8, 0x70, 0x20,  // 0x03
+  0x00, 0x20, 0x70, 0xF8, 0xF8, 0x70, 0x20,  // 0x04
+  0x70, 0x50, 0xF8, 0xA8, 0xF8, 0x20, 0x70,  // 0x05
+  0x20, 0x70, 0xF8, 0xF8, 0xF8, 0x20, 0x70,  // 0x06
+  0x00, 0x00, 0x20, 0x70, 0x70, 0x20, 0x00,  // 0x07
+  0xF8, 0xF8, 0xD8, 0x88, 0x88, 0xD8, 0xF8,  // 0x08
+  0x00, 0x00, 0x20, 0x50, 0x50, 0x20, 0x00,  // 0x09
+  0xF8, 0xF8, 0xD8, 0xA8, 0xA8, 0xD8, 0xF8,  // 0x0A
+  0x00, 0x38, 0x18, 0x68, 0xA0, 0xA0, 0x40,  // 0x0B
+  0x70, 0x88, 0x88, 0x70, 0x20, 0xF8, 0x20,  // 0x0C
+  0x78, 0x48, 0x78, 0x40, 0x40, 0x40, 0xC0,  // 0x0D
+  0x78, 0x48, 0x78, 0x48, 0x48, 0x58, 0xC0,  // 0x0E
+  0x20, 0xA8, 0x70, 0xD8, 0xD8, 0x70, 0xA8,  // 0x0F
+  0x80, 0xC0, 0xF0, 0xF8, 0xF0, 0xC0, 0x80,  // 0x10
+  0x08, 0x18, 0x78, 0xF8, 0x78, 0x18, 0x08,  // 0x11
+  0x20, 0x70, 0xA8, 0x20, 0xA8, 0x70, 0x20,  // 0x12
+  0xD8, 0xD8, 0xD8, 0xD8, 0xD8, 0x00, 0xD8,  // 0x13
+  0x78, 0xA8, 0xA8, 0x68, 0x28, 0x28, 0x28,  // 0x14
+  0x30, 0x48, 0x50, 0x28, 0x10, 0x48, 0x48,  // 0x15
+  0x00, 0x00, 0x00, 0x00, 0x00, 0xF8, 0xF8,  // 0x16
+  0x20, 0x70, 0xA8, 0x20, 0xA8, 0x70, 0x20,  // 0x17
+  0x00, 0x20, 0x70, 0xA8, 0x20, 0x20, 0x20,  // 0x18
+  0x00, 0x20, 0x20, 0x20, 0xA8, 0x70, 0x20,  // 0x19
+  0x00, 0x20, 0x10, 0xF8, 0x10, 0x20, 0x00,  // 0x1A
+  0x00, 0x20, 0x40, 0xF8, 0x40, 0x20, 0x00,  // 0x1B
+  0x00, 0x80, 0x80, 0x80, 0xF8, 0x00, 0x00,  // 0x1C
+  0x00, 0x50, 0xF8, 0xF8, 0x50, 0x00, 0x00,  // 0x1D
+  0x00, 0x20, 0x20, 0x70, 0xF8, 0xF8, 0x00,  // 0x1E
+  0x00, 0xF8, 0xF8, 0x70, 0x20, 0x20, 0x00,  // 0x1F
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 0x20 ' '
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x00, 0x20,  // 0x21 '!'
+  0x50, 0x50, 0x50, 0x00, 0x00, 0x00, 0x00,  // 0x22 '"'
+  0x50, 0x50, 0xF8, 0x50, 0xF8, 0x50, 0x50,  // 0x23 '#'
+  0x20, 0x78, 0xA0, 0x70, 0x28, 0xF0, 0x20,  // 0x24 '$'
+  0xC0, 0xC8, 0x10, 0x20, 0x40, 0x98, 0x18,  // 0x25 '%'
+  0x40, 0xA0, 0xA0, 0x40, 0xA8, 0x90, 0x68,  // 0x26 '&'
+  0x30, 0x30, 0x20, 0x40, 0x00, 0x00, 0x00,  // 0x27 '''
+  0x10, 0x20, 0x40, 0x40, 0x40, 0x20, 0x10,  // 0x28 '('
+  0x40, 0x20, 0x10, 0x10, 0x10, 0x20, 0x40,  // 0x29 ')'
+  0x20, 0xA8, 0x70, 0xF8, 0x70, 0xA8, 0x20,  // 0x2A '*'
+  0x00, 0x20, 0x20, 0xF8, 0x20, 0x20, 0x00,  // 0x2B '+'
+  0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x20,  // 0x2C ','
+  0x00, 0x00, 0x00, 0xF8, 0x00, 0x00, 0x00,  // 0x2D '-'
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30,  // 0x2E '.'
+  0x00, 0x08, 0x10, 0x20, 0x40, 0x80, 0x00,  // 0x2F '/'
+  0x70, 0x88, 0x98, 0xA8, 0xC8, 0x88, 0x70,  // 0x30 '0'
+  0x20, 0x60, 0x20, 0x20, 0x20, 0x20, 0x70,  // 0x31 '1'
+  0x70, 0x88, 0x08, 0x70, 0x80, 0x80, 0xF8,  // 0x32 '2'
+  0xF8, 0x08, 0x10, 0x30, 0x08, 0x88, 0x70,  // 0x33 '3'
+  0x10, 0x30, 0x50, 0x90, 0xF8, 0x10, 0x10,  // 0x34 '4'
+  0xF8, 0x80, 0xF0, 0x08, 0x08, 0x88, 0x70,  // 0x35 '5'
+  0x38, 0x40, 0x80, 0xF0, 0x88, 0x88, 0x70,  // 0x36 '6'
+  0xF8, 0x08, 0x08, 0x10, 0x20, 0x40, 0x80,  // 0x37 '7'
+  0x70, 0x88, 0x88, 0x70, 0x88, 0x88, 0x70,  // 0x38 '8'
+  0x70, 0x88, 0x88, 0x78, 0x08, 0x10, 0xE0,  // 0x39 '9'
+  0x00, 0x00, 0x20, 0x00, 0x20, 0x00, 0x00,  // 0x3A ':'
+  0x00, 0x00, 0x20, 0x00, 0x20, 0x20, 0x40,  // 0x3B ';'
+  0x08, 0x10, 0x20, 0x40, 0x20, 0x10, 0x08,  // 0x3C '<'
+  0x00, 0x00, 0xF8, 0x00, 0xF8, 0x00, 0x00,  // 0x3D '='
+  0x40, 0x20, 0x10, 0x08, 0x10, 0x20, 0x40,  // 0x3E '>'
+  0x70, 0x88, 0x08, 0x30, 0x20, 0x00, 0x20,  // 0x3F '?'
+  0x70, 0x88, 0xA8, 0xB8, 0xB0, 0x80, 0x78,  // 0x40 '@'
+  0x20, 0x50, 0x88, 0x88, 0xF8, 0x88, 0x88,  // 0x41 'A'
+  0xF0, 0x88, 0x88, 0xF0, 0x88, 0x88, 0xF0,  // 0x42 'B'
+  0x70, 0x88, 0x80, 0x80, 0x80, 0x88, 0x70,  // 0x43 'C'
+  0xF0, 0x88, 0x88, 0x88, 0x88, 0x88, 0xF0,  // 0x44 'D'
+  0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0xF8,  // 0x45 'E'
+  0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0x80,  // 0x46 'F'
+  0x78, 0x88, 0x80, 0x80, 0x98, 0x88, 0x78,  // 0x47 'G'
+  0x88, 0x88, 0x88, 0xF8, 0x88, 0x88, 0x88,  // 0x48 'H'
+  0x70, 0x20, 0x20, 0x20, 0x20, 0x20, 0x70,  // 0x49 'I'
+  0x38, 0x10, 0x10, 0x10, 0x10, 0x90, 0x60,  // 0x4A 'J'
+  0x88, 0x90, 0xA0, 0xC0, 0xA0, 0x90, 0x88,  // 0x4B 'K'
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0xF8,  // 0x4C 'L'
+  0x88, 0xD8, 0xA8, 0xA8, 0xA8, 0x88, 0x88,  // 0x4D 'M'
+  0x88, 0x88, 0xC8, 0xA8, 0x98, 0x88, 0x88,  // 0x4E 'N'
+  0x70, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70,  // 0x4F 'O'
+  0xF0, 0x88, 0x88, 0xF0, 0x80, 0x80, 0x80,  // 0x50 'P'
+  0x70, 0x88, 0x88, 0x88, 0xA8, 0x90, 0x68,  // 0x51 'Q'
+  0xF0, 0x88, 0x88, 0xF0, 0xA0, 0x90, 0x88,  // 0x52 'R'
+  0x70, 0x88, 0x80, 0x70, 0x08, 0x88, 0x70,  // 0x53 'S'
+  0xF8, 0xA8, 0x20, 0x20, 0x20, 0x20, 0x20,  // 0x54 'T'
+  0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70,  // 0x55 'U'
+  0x88, 0x88, 0x88, 0x88, 0x88, 0x50, 0x20,  // 0x56 'V'
+  0x88, 0x88, 0x88, 0xA8, 0xA8, 0xA8, 0x50,  // 0x57 'W'
+  0x88, 0x88, 0x50, 0x20, 0x50, 0x88, 0x88,  // 0x58 'X'
+  0x88, 0x88, 0x50, 0x20, 0x20, 0x20, 0x20,  // 0x59 'Y'
+  0xF8, 0x08, 0x10, 0x70, 0x40, 0x80, 0xF8,  // 0x5A 'Z'
+  0x78, 0x40, 0x40, 0x40, 0x40, 0x40, 0x78,  // 0x5B '['
+  0x00, 0x80, 0x40, 0x20, 0x10, 0x08, 0x00,  // 0x5C
+  0x78, 0x08, 0x08, 0x08, 0x08, 0x08, 0x78,  // 0x5D ']'
+  0x20, 0x50, 0x88, 0x00, 0x00, 0x00, 0x00,  // 0x5E '^'
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8,  // 0x5F '_'
+  0x60, 0x60, 0x20, 0x10, 0x00, 0x00, 0x00,  // 0x60 '`'
+  0x00, 0x00, 0x60, 0x10, 0x70, 0x90, 0x78,  // 0x61 'a'
+  0x80, 0x80, 0xB0, 0xC8, 0x88, 0xC8, 0xB0,  // 0x62 'b'
+  0x00, 0x00, 0x70, 0x88, 0x80, 0x88, 0x70,  // 0x63 'c'
+  0x08, 0x08, 0x68, 0x98, 0x88, 0x98, 0x68,  // 0x64 'd'
+  0x00, 0x00, 0x70, 0x88, 0xF8, 0x80, 0x70,  // 0x65 'e'
+  0x10, 0x28, 0x20, 0x70, 0x20, 0x20, 0x20,  // 0x66 'f'
+  0x00, 0x00, 0x70, 0x98, 0x98, 0x68, 0x08,  // 0x67 'g'
+  0x80, 0x80, 0xB0, 0xC8, 0x88, 0x88, 0x88,  // 0x68 'h'
+  0x20, 0x00, 0x60, 0x20, 0x20, 0x20, 0x70,  // 0x69 'i'
+  0x10, 0x00, 0x10, 0x10, 0x10, 0x90, 0x60,  // 0x6A 'j'
+  0x80, 0x80, 0x90, 0xA0, 0xC0, 0xA0, 0x90,  // 0x6B 'k'
+  0x60, 0x20, 0x20, 0x20, 0x20, 0x20, 0x70,  // 0x6C 'l'
+  0x00, 0x00, 0xD0, 0xA8, 0xA8, 0xA8, 0xA8,  // 0x6D 'm'
+  0x00, 0x00, 0xB0, 0xC8, 0x88, 0x88, 0x88,  // 0x6E 'n'
+  0x00, 0x00, 0x70, 0x88, 0x88, 0x88, 0x70,  // 0x6F 'o'
+  0x00, 0x00, 0xB0, 0xC8, 0xC8, 0xB0, 0x80,  // 0x70 'p'
+  0x00, 0x00, 0x68, 0x98, 0x98, 0x68, 0x08,  // 0x71 'q'
+  0x00, 0x00, 0xB0, 0xC8, 0x80, 0x80, 0x80,  // 0x72 'r'
+  0x00, 0x00, 0x78, 0x80, 0x70, 0x08, 0xF0,  // 0x73 's'
+  0x20, 0x20, 0xF8, 0x20, 0x20, 0x28, 0x10,  // 0x74 't'
+  0x00, 0x00, 0x88, 0x88, 0x88, 0x98, 0x68,  // 0x75 'u'
+  0x00, 0x00, 0x88, 0x88, 0x88, 0x50, 0x20,  // 0x76 'v'
+  0x00, 0x00, 0x88, 0x88, 0xA8, 0xA8, 0x50,  // 0x77 'w'
+  0x00, 0x00, 0x88, 0x50, 0x20, 0x50, 0x88,  // 0x78 'x'
+  0x00, 0x00, 0x88, 0x88, 0x78, 0x08, 0x88,  // 0x79 'y'
+  0x00, 0x00, 0xF8, 0x10, 0x20, 0x40, 0xF8,  // 0x7A 'z'
+  0x10, 0x20, 0x20, 0x40, 0x20, 0x20, 0x10,  // 0x7B '{'
+  0x20, 0x20, 0x20, 0x00, 0x20, 0x20, 0x20,  // 0x7C '|'
+  0x40, 0x20, 0x20, 0x10, 0x20, 0x20, 0x40,  // 0x7D '}'
+  0x40, 0xA8, 0x10, 0x00, 0x00, 0x00, 0x00,  // 0x7E '~'
+  0x20, 0x70, 0xD8, 0x88, 0x88, 0xF8, 0x00,  // 0x7F
+  0x70, 0x88, 0x80, 0x80, 0x88, 0x70, 0x10,  // 0x80
+  0x00, 0x88, 0x00, 0x88, 0x88, 0x98, 0x68,  // 0x81
+  0x18, 0x00, 0x70, 0x88, 0xF8, 0x80, 0x78,  // 0x82
+  0xF8, 0x00, 0x60, 0x10, 0x70, 0x90, 0x78,  // 0x83
+  0x00, 0x88, 0x60, 0x10, 0x70, 0x90, 0x78,  // 0x84
+  0xC0, 0x00, 0x60, 0x10, 0x70, 0x90, 0x78,  // 0x85
+  0x30, 0x00, 0x60, 0x10, 0x70, 0x90, 0x78,  // 0x86
+  0x00, 0x78, 0xC0, 0xC0, 0x78, 0x10, 0x30,  // 0x87
+  0xF8, 0x00, 0x70, 0x88, 0xF8, 0x80, 0x78,  // 0x88
+  0x88, 0x00, 0x70, 0x88, 0xF8, 0x80, 0x78,  // 0x89
+  0xC0, 0x00, 0x70, 0x88, 0xF8, 0x80, 0x78,  // 0x8A
+  0x28, 0x00, 0x30, 0x10, 0x10, 0x10, 0x38,  // 0x8B
+  0x30, 0x48, 0x30, 0x10, 0x10, 0x10, 0x38,  // 0x8C
+  0x60, 0x00, 0x30, 0x10, 0x10, 0x10, 0x38,  // 0x8D
+  0xA8, 0x50, 0x88, 0x88, 0xF8, 0x88, 0x88,  // 0x8E
+  0x20, 0x00, 0x20, 0x50, 0x88, 0xF8, 0x88,  // 0x8F
+  0x30, 0x00, 0xF0, 0x80, 0xE0, 0x80, 0xF0,  // 0x90
+  0x00, 0x00, 0x78, 0x10, 0x78, 0x90, 0x78,  // 0x91
+  0x38, 0x50, 0x90, 0xF8, 0x90, 0x90, 0x98,  // 0x92
+  0x70, 0x88, 0x00, 0x70, 0x88, 0x88, 0x70,  // 0x93
+  0x00, 0x88, 0x70, 0x88, 0x88, 0x88, 0x70,  // 0x94
+  0x00, 0xC0, 0x00, 0x70, 0x88, 0x88, 0x70,  // 0x95
+  0x70, 0x88, 0x00, 0x88, 0x88, 0x98, 0x68,  // 0x96
+  0x00, 0xC0, 0x00, 0x88, 0x88, 0x98, 0x68,  // 0x97
+  0x48, 0x00, 0x48, 0x48, 0x48, 0x38, 0x08,  // 0x98
+  0x88, 0x70, 0x88, 0x88, 0x88, 0x88, 0x70,  // 0x99
+  0x88, 0x00, 0x88, 0x88, 0x88, 0x88, 0x70,  // 0x9A
+  0x20, 0x20, 0xF8, 0xA0, 0xA0, 0xF8, 0x20,  // 0x9B
+  0x30, 0x58, 0x48, 0xE0, 0x40, 0x48, 0xF8,  // 0x9C
+  0xD8, 0xD8, 0x70, 0xF8, 0x20, 0xF8, 0x20,  // 0x9D
+  0xE0, 0x90, 0x90, 0xE0, 0x90, 0xB8, 0x90,  // 0x9E
+  0x18, 0x28, 0x20, 0x70, 0x20, 0x20, 0xA0,  // 0x9F
+  0x18, 0x00, 0x60, 0x10, 0x70, 0x90, 0x78,  // 0xA0
+  0x18, 0x00, 0x30, 0x10, 0x10, 0x10, 0x38,  // 0xA1
+  0x00, 0x18, 0x00, 0x70, 0x88, 0x88, 0x70,  // 0xA2
+  0x00, 0x18, 0x00, 0x88, 0x88, 0x98, 0x68,  // 0xA3
+  0x00, 0x78, 0x00, 0x70, 0x48, 0x48, 0x48,  // 0xA4
+  0xF8, 0x00, 0xC8, 0xE8, 0xB8, 0x98, 0x88,  // 0xA5
+  0x70, 0x90, 0x90, 0x78, 0x00, 0xF8, 0x00,  // 0xA6
+  0x70, 0x88, 0x88, 0x70, 0x00, 0xF8, 0x00,  // 0xA7
+  0x20, 0x00, 0x20, 0x60, 0x80, 0x88, 0x70,  // 0xA8
+  0x00, 0x00, 0x00, 0xF8, 0x80, 0x80, 0x00,  // 0xA9
+  0x00, 0x00, 0x00, 0xF8, 0x08, 0x08, 0x00,  // 0xAA
+  0x80, 0x88, 0x90, 0xB8, 0x48, 0x98, 0x20,  // 0xAB
+  0x80, 0x88, 0x90, 0xA8, 0x58, 0xB8, 0x08,  // 0xAC
+  0x20, 0x20, 0x00, 0x20, 0x20, 0x20, 0x20,  // 0xAD
+  0x00, 0x28, 0x50, 0xA0, 0x50, 0x28, 0x00,  // 0xAE
+  0x00, 0xA0, 0x50, 0x28, 0x50, 0xA0, 0x00,  // 0xAF
+  0xA8, 0x00, 0xA8, 0x00, 0xA8, 0x00, 0xA8,  // 0xB0
+  0x54, 0xA8, 0x54, 0xA8, 0x54, 0xA8, 0x54,  // 0xB1
+  0xFC, 0xA8, 0xFC, 0xA8, 0xFC, 0xA8, 0xFC,  // 0xB2
+  0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,  // 0xB3
+  0x10, 0x10, 0x10, 0x10, 0xF0, 0x10, 0x10,  // 0xB4
+  0x10, 0x10, 0xF0, 0x10, 0xF0, 0x10, 0x10,  // 0xB5
+  0x28, 0x28, 0x28, 0x28, 0xE8, 0x28, 0x28,  // 0xB6
+  0x00, 0x00, 0x00, 0x00, 0xF8, 0x28, 0x28,  // 0xB7
+  0x00, 0x00, 0xF0, 0x10, 0xF0, 0x10, 0x10,  // 0xB8
+  0x28, 0x28, 0xE8, 0x08, 0xE8, 0x28, 0x28,  // 0xB9
+  0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,  // 0xBA
+  0x00, 0x00, 0xF8, 0x08, 0xE8, 0x28, 0x28,  // 0xBB
+  0x28, 0x28, 0xE8, 0x08, 0xF8, 0x00, 0x00,  // 0xBC
+  0x28, 0x28, 0x28, 0x28, 0xF8, 0x00, 0x00,  // 0xBD
+  0x10, 0x10, 0xF0, 0x10, 0xF0, 0x00, 0x00,  // 0xBE
+  0x00, 0x00, 0x00, 0x00, 0xF0, 0x10, 0x10,  // 0xBF
+  0x10, 0x10, 0x10, 0x10, 0x1C, 0x00, 0x00,  // 0xC0
+  0x10, 0x10, 0x10, 0x10, 0xFC, 0x00, 0x00,  // 0xC1
+  0x00, 0x00, 0x00, 0x00, 0xFC, 0x10, 0x10,  // 0xC2
+  0x10, 0x10, 0x10, 0x10, 0x1C, 0x10, 0x10,  // 0xC3
+  0x00, 0x00, 0x00, 0x00, 0xFC, 0x00, 0x00,  // 0xC4
+  0x10, 0x10, 0x10, 0x10, 0xFC, 0x10, 0x10,  // 0xC5
+  0x10, 0x10, 0x18, 0x10, 0x18, 0x10, 0x10,  // 0xC6
+  0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,  // 0xC7
+  0x2C, 0x2C, 0x2C, 0x20, 0x3C, 0x00, 0x00,  // 0xC8
+  0x00, 0x00, 0x3C, 0x20, 0x2C, 0x2C, 0x2C,  // 0xC9
+  0x2C, 0x2C, 0xEC, 0x00, 0xFC, 0x00, 0x00,  // 0xCA
+  0x00, 0x00, 0xFC, 0x00, 0xEC, 0x2C, 0x2C,  // 0xCB
+  0x2C, 0x2C, 0x2C, 0x20, 0x2C, 0x2C, 0x2C,  // 0xCC
+  0x00, 0x00, 0xFC, 0x00, 0xFC, 0x00, 0x00,  // 0xCD
+  0x2C, 0x2C, 0xEC, 0x00, 0xEC, 0x2C, 0x2C,  // 0xCE
+  0x10, 0x10, 0xF8, 0x00, 0xF8, 0x00, 0x00,  // 0xCF
+  0x28, 0x28, 0x28, 0x28, 0xF8, 0x00, 0x00,  // 0xD0
+  0x00, 0x00, 0xF8, 0x00, 0xF8, 0x10, 0x10,  // 0xD1
+  0x00, 0x00, 0x00, 0x00, 0xF8, 0x28, 0x28,  // 0xD2
+  0x28, 0x28, 0x28, 0x28, 0x38, 0x00, 0x00,  // 0xD3
+  0x10, 0x10, 0x18, 0x10, 0x18, 0x00, 0x00,  // 0xD4
+  0x00, 0x00, 0x18, 0x10, 0x18, 0x10, 0x10,  // 0xD5
+  0x00, 0x00, 0x00, 0x00, 0x38, 0x28, 0x28,  // 0xD6
+  0x28, 0x28, 0x28, 0x28, 0xF8, 0x28, 0x28,  // 0xD7
+  0x10, 0x10, 0xF8, 0x10, 0xF8, 0x10, 0x10,  // 0xD8
+  0x10, 0x10, 0x10, 0x10, 0xF0, 0x00, 0x00,  // 0xD9
+  0x00, 0x00, 0x00, 0x00, 0x1C, 0x10, 0x10,  // 0xDA
+  0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC,  // 0xDB
+  0x00, 0x00, 0x00, 0x00, 0xFC, 0xFC, 0xFC,  // 0xDC
+  0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0,  // 0xDD
+  0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,  // 0xDE
+  0xFC, 0xFC, 0xFC, 0xFC, 0x00, 0x00, 0x00,  // 0xDF
+  0x00, 0x00, 0x68, 0x90, 0x90, 0x90, 0x68,  // 0xE0
+  0x00, 0x70, 0x88, 0xF0, 0x88, 0x88, 0xF0,  // 0xE1
+  0x00, 0xF8, 0x98, 0x80, 0x80, 0x80, 0x80,  // 0xE2
+  0x00, 0xF8, 0x50, 0x50, 0x50, 0x50, 0x50,  // 0xE3
+  0xF8, 0x88, 0x40, 0x20, 0x40, 0x88, 0xF8,  // 0xE4
+  0x00, 0x00, 0x78, 0x90, 0x90, 0x90, 0x60,  // 0xE5
+  0x00, 0x50, 0x50, 0x50, 0x50, 0x68, 0xC0,  // 0xE6
+  0x00, 0xF8, 0xA0, 0x20, 0x20, 0x20, 0x20,  // 0xE7
+  0xF8, 0x20, 0x70, 0x88, 0x88, 0x70, 0x20,  // 0xE8
+  0x20, 0x50, 0x88, 0xF8, 0x88, 0x50, 0x20,  // 0xE9
+  0x20, 0x50, 0x88, 0x88, 0x50, 0x50, 0xD8,  // 0xEA
+  0x30, 0x40, 0x30, 0x70, 0x88, 0x88, 0x70,  // 0xEB
+  0x00, 0x00, 0x00, 0x70, 0xA8, 0xA8, 0x70,  // 0xEC
+  0x08, 0x70, 0x98, 0xA8, 0xA8, 0xC8, 0x70,  // 0xED
+  0x70, 0x80, 0x80, 0xF0, 0x80, 0x80, 0x70,  // 0xEE
+  0x70, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88,  // 0xEF
+  0x00, 0xF8, 0x00, 0xF8, 0x00, 0xF8, 0x00,  // 0xF0
+  0x20, 0x20, 0xF8, 0x20, 0x20, 0x00, 0xF8,  // 0xF1
+  0x40, 0x20, 0x10, 0x20, 0x40, 0x00, 0xF8,  // 0xF2
+  0x10, 0x20, 0x40, 0x20, 0x10, 0x00, 0xF8,  // 0xF3
+  0x38, 0x28, 0x20, 0x20, 0x20, 0x20, 0x20,  // 0xF4
+  0x20, 0x20, 0x20, 0x20, 0x20, 0xA0, 0xA0,  // 0xF5
+  0x30, 0x30, 0x00, 0xF8, 0x00, 0x30, 0x30,  // 0xF6
+  0x00, 0xE8, 0xB8, 0x00, 0xE8, 0xB8, 0x00,  // 0xF7
+  0x70, 0xD8, 0xD8, 0x70, 0x00, 0x00, 0x00,  // 0xF8
+  0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00,  // 0xF9
+  0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00,  // 0xFA
+  0x38, 0x20, 0x20, 0x20, 0xA0, 0xA0, 0x60,  // 0xFB
+  0x70, 0x48, 0x48, 0x48, 0x48, 0x00, 0x00,  // 0xFC
+  0x70, 0x18, 0x30, 0x60, 0x78, 0x00, 0x00,  // 0xFD
+  0x00, 0x00, 0x7C, 0x7C, 0x7C, 0x7C, 0x00,  // 0xFE
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  // 0xFF
+};
+
+const uint8_t font_subset_slot[256] = {                                        // Glyph slot in font_subset_rows of each character
+   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  2,  3,  0,  4,
+   5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,  0, 16,  0, 17,  0,
+   0, 18, 19, 20, 21, 22, 23,  0, 24,  0,  0,  0, 25, 26, 27, 28,
+   0,  0, 29,  0, 30,  0,  0,  0, 31,  0,  0,  0,  0,  0,  0,  0,
+   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 32,
+   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+};
+
+const uint8_t font_subset_rows[33 * CHAR_HEIGHT] = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 0x20 ' '
+  0x00, 0x20, 0x20, 0xF8, 0x20, 0x20, 0x00,  // 0x2B '+'
+  0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x20,  // 0x2C ','
+  0x00, 0x00, 0x00, 0xF8, 0x00, 0x00, 0x00,  // 0x2D '-'
+  0x00, 0x08, 0x10, 0x20, 0x40, 0x80, 0x00,  // 0x2F '/'
+  0x70, 0x88, 0x98, 0xA8, 0xC8, 0x88, 0x70,  // 0x30 '0'
+  0x20, 0x60, 0x20, 0x20, 0x20, 0x20, 0x70,  // 0x31 '1'
+  0x70, 0x88, 0x08, 0x70, 0x80, 0x80, 0xF8,  // 0x32 '2'
+  0xF8, 0x08, 0x10, 0x30, 0x08, 0x88, 0x70,  // 0x33 '3'
+  0x10, 0x30, 0x50, 0x90, 0xF8, 0x10, 0x10,  // 0x34 '4'
+  0xF8, 0x80, 0xF0, 0x08, 0x08, 0x88, 0x70,  // 0x35 '5'
+  0x38, 0x40, 0x80, 0xF0, 0x88, 0x88, 0x70,  // 0x36 '6'
+  0xF8, 0x08, 0x08, 0x10, 0x20, 0x40, 0x80,  // 0x37 '7'
+  0x70, 0x88, 0x88, 0x70, 0x88, 0x88, 0x70,  // 0x38 '8'
+  0x70, 0x88, 0x88, 0x78, 0x08, 0x10, 0xE0,  // 0x39 '9'
+  0x00, 0x00, 0x20, 0x00, 0x20, 0x00, 0x00,  // 0x3A ':'
+  0x08, 0x10, 0x20, 0x40, 0x20, 0x10, 0x08,  // 0x3C '<'
+  0x40, 0x20, 0x10, 0x08, 0x10, 0x20, 0x40,  // 0x3E '>'
+  0x20, 0x50, 0x88, 0x88, 0xF8, 0x88, 0x88,  // 0x41 'A'
+  0xF0, 0x88, 0x88, 0xF0, 0x88, 0x88, 0xF0,  // 0x42 'B'
+  0x70, 0x88, 0x80, 0x80, 0x80, 0x88, 0x70,  // 0x43 'C'
+  0xF0, 0x88, 0x88, 0x88, 0x88, 0x88, 0xF0,  // 0x44 'D'
+  0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0xF8,  // 0x45 'E'
+  0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0x80,  // 0x46 'F'
+  0x88, 0x88, 0x88, 0xF8, 0x88, 0x88, 0x88,  // 0x48 'H'
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0xF8,  // 0x4C 'L'
+  0x88, 0xD8, 0xA8, 0xA8, 0xA8, 0x88, 0x88,  // 0x4D 'M'
+  0x88, 0x88, 0xC8, 0xA8, 0x98, 0x88, 0x88,  // 0x4E 'N'
+  0x70, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70,  // 0x4F 'O'
+  0xF0, 0x88, 0x88, 0xF0, 0xA0, 0x90, 0x88,  // 0x52 'R'
+  0xF8, 0xA8, 0x20, 0x20, 0x20, 0x20, 0x20,  // 0x54 'T'
+  0x88, 0x88, 0x50, 0x20, 0x50, 0x88, 0x88,  // 0x58 'X'
+  0x00, 0x00, 0x70, 0x88, 0x88, 0x88, 0x70  // 0x6F 'o'
+};
+
+inline const uint8_t *glyphRows( uint8_t c ){                                   // Points at the first row of a character's glyph
+#ifdef FONT_SUBSET
+  return &font_subset_rows[ font_subset_slot[c] * CHAR_HEIGHT ];
+#else
+  return &font_rows[ c * CHAR_HEIGHT ];
+#endif
+}
+
+#endif
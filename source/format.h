@@ -0,0 +1,183 @@
+#ifndef FORMAT_H
+#define FORMAT_H
+
+/*
+  ___ ___                _________        .__          
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____  
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\ 
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___ 
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/ 
+        
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+--- Description: ---
+This library turns the calculator's 64-bit values into the character
+strings that the draw functions put on the screen, without leaning on
+the AVR's (very slow) software 64-bit division or the printf family.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+/*******************************************
+* Number Text                              *
+*******************************************/
+// The formatters write their characters right-aligned into a NumberText, along with the metadata
+// drawString() needs: how many characters there are, and how many of the leading ones are
+// zeros (or separators between them) that get drawn in the ghost color.
+
+#define NUM_TEXT_SIZE 27                                                       // 22 octal digits plus 5 separators, or 20 decimal digits plus 6 commas
+
+struct NumberText{
+  char    chars[NUM_TEXT_SIZE];                                                // The characters, right-aligned (only the last length of them are used)
+  uint8_t length;                                                              // Number of characters
+  uint8_t ghosts;                                                              // Number of leading characters that are zeros or separators
+
+  const char *str() const { return chars + NUM_TEXT_SIZE - length; }           // First character of the text
+};
+
+inline uint8_t leadingGhosts( const char *str, uint8_t length ){               // Counts the leading zeros (and the spaces among them) of a string
+  uint8_t ghosts = 0;
+  while( ghosts < length && (str[ghosts] == '0' || str[ghosts] == ' ') ) ghosts++;
+  return ghosts;
+}
+
+inline void finishText( NumberText &text, const char *first ){                 // Fills in the metadata once the characters from first onwards are written
+  text.length = text.chars + NUM_TEXT_SIZE - first;
+  text.ghosts = leadingGhosts( first, text.length );
+}
+
+
+/*******************************************
+* Hex & Octal Conversion                   *
+*******************************************/
+// Hex and octal digits are just groups of 4 or 3 bits, so the value is walked a byte at a time from
+// the bottom: each byte is added to a small bit accumulator and digits are peeled off the bottom of
+// it with a mask and a table lookup. Nothing wider than 16 bits is ever shifted, which matters on an
+// 8-bit core where every 64-bit shift is a loop. Octal digits straddle byte boundaries, which the
+// accumulator takes care of, so all 22 digits of a 64-bit value come out.
+
+const char radix_digits[16] = { '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F' };
+
+inline uint8_t digitValue( char c ){                                           // Value of a digit character in any base up to 16 (either case), 0xFF if it isn't one
+  if( c >= '0' && c <= '9' ) return c - '0';
+  if( c >= 'A' && c <= 'F' ) return c - 'A' + 10;
+  if( c >= 'a' && c <= 'f' ) return c - 'a' + 10;
+  return 0xFF;
+}
+
+// Writes the lowest `digits` digits of val, bits_per_digit bits each (4 for hex, 3 for octal), with a
+// space between every group of `group` digits counted from the right (0 for no spaces).
+inline void formatRadix( uint64_t val, uint8_t bits_per_digit, uint8_t digits, uint8_t group, NumberText &text ){
+  uint8_t  bytes[8];                                                           // The value's bytes, least significant first
+  memcpy( bytes, &val, sizeof(bytes) );                                        // (both the AVR and the host are little-endian)
+  uint8_t  mask = (1 << bits_per_digit) - 1;
+  uint16_t acc = 0;                                                            // Bits waiting to become digits
+  uint8_t  acc_bits = 0;                                                       // Number of bits in acc
+  uint8_t  next_byte = 0;
+  char    *p = text.chars + NUM_TEXT_SIZE;                                     // Characters are written backwards from the end
+
+  for( uint8_t i = 0; i < digits; i++ ){
+    if( acc_bits < bits_per_digit ){                                           // Top up the accumulator with the next byte
+      if( next_byte < 8 ) acc |= uint16_t( bytes[next_byte++] ) << acc_bits;
+      acc_bits += 8;
+    }
+    if( group && i && i % group == 0 ) *--p = ' ';
+    *--p = radix_digits[ acc & mask ];
+    acc >>= bits_per_digit;
+    acc_bits -= bits_per_digit;
+  }
+  finishText( text, p );
+}
+
+constexpr uint8_t hexDigits( uint8_t bit_depth ){   return bit_depth >> 2;      } // Digits needed to show bit_depth bits in hex
+constexpr uint8_t octalDigits( uint8_t bit_depth ){ return (bit_depth + 2) / 3; } // Digits needed to show bit_depth bits in octal
+
+
+/*******************************************
+* Decimal Conversion                       *
+*******************************************/
+// A 64-bit value is converted four decimal digits at a time. Each pass divides the value by 10000
+// using long division over its four 16-bit words, so every step is a 32-bit by 16-bit division
+// (the remainder is below 10000, so remainder:word always fits in 32 bits). Words that have already
+// dropped to zero are skipped. The four digits of each chunk are then split off with a multiply by
+// the reciprocal of 10, which needs only the hardware multiplier.
+//
+// The full 20 digit value takes 5 passes and no 64-bit divisions, where the plain
+// "% 10, / 10" loop needs 40 of them. The digits come out as packed BCD, which the Calculator
+// also keeps as a shadow of its values so that typing a decimal number needs no conversion at all.
+
+inline uint16_t divmod10000( uint16_t words[4], uint8_t top ){                 // Divides words[top..3] (most significant first) by 10000 in place and returns the remainder
+  uint32_t rem = 0;
+  for( uint8_t i = top; i < 4; i++ ){
+    uint32_t n = (rem << 16) | words[i];                                       // rem < 10000, so this is below 2^30
+    words[i] = n / 10000;
+    rem      = n - uint32_t(words[i]) * 10000;
+  }
+  return rem;
+}
+
+#define BCD_BYTES 10                                                           // Packed BCD bytes needed for any 64-bit value (20 digits)
+
+// Packed BCD holds two decimal digits per byte, least significant pair first (bcd[0] = tens:ones).
+
+inline void bcdFromBinary( uint64_t val, uint8_t bcd[BCD_BYTES] ){             // Converts val into packed BCD
+  uint16_t words[4] = { uint16_t(val >> 48), uint16_t(val >> 32), uint16_t(val >> 16), uint16_t(val) };
+  uint8_t  top = 0;                                                            // First non-zero word
+  while( top < 4 && words[top] == 0 ) top++;
+  for( uint8_t i = 0; i < BCD_BYTES; i += 2 ){
+    if( top == 4 ){ bcd[i] = 0; bcd[i + 1] = 0; continue; }                    // Nothing left, so the rest are leading zeros
+    uint16_t chunk = divmod10000( words, top );                                // The next four digits
+    while( top < 4 && words[top] == 0 ) top++;
+    for( uint8_t k = 0; k < 2; k++ ){
+      uint16_t q1 = (uint32_t(chunk) * 0xCCCD) >> 19;                          // chunk / 10 (exact for any 16-bit value)
+      uint16_t q2 = (uint32_t(q1)    * 0xCCCD) >> 19;
+      bcd[i + k] = ((q1 - q2 * 10) << 4) | (chunk - q1 * 10);
+      chunk = q2;
+    }
+  }
+}
+
+inline bool bcdShiftIn( uint8_t bcd[BCD_BYTES], uint8_t digit ){               // Multiplies bcd by ten and adds digit (returns false if a digit fell off the top)
+  bool overflow = bcd[BCD_BYTES - 1] >> 4;
+  for( uint8_t i = BCD_BYTES - 1; i > 0; i-- ) bcd[i] = (bcd[i] << 4) | (bcd[i - 1] >> 4);
+  bcd[0] = (bcd[0] << 4) | digit;
+  return !overflow;
+}
+
+// Writes the packed BCD value with a comma between every group of three digits (at least one
+// digit, for "0").
+inline void formatBCD( const uint8_t bcd[BCD_BYTES], NumberText &text, uint8_t min_digits = 1 ){ // Writes at least min_digits digits (padding with zeros)
+  int8_t digits = BCD_BYTES * 2;                                               // Find the most significant non-zero digit
+  while( digits > min_digits && ((bcd[(digits - 1) >> 1] >> (((digits - 1) & 1) * 4)) & 0x0F) == 0 ) digits--;
+  char *p = text.chars + NUM_TEXT_SIZE;                                        // Characters are written backwards from the end
+  for( int8_t i = 0; i < digits; i++ ){
+    if( i && i % 3 == 0 ) *--p = ',';
+    *--p = radix_digits[ (i & 1) ? (bcd[i >> 1] >> 4) : (bcd[i >> 1] & 0x0F) ];
+  }
+  finishText( text, p );
+}
+
+inline void formatDecimal( uint64_t val, NumberText &text ){                   // Same as formatBCD, straight from a binary value
+  uint8_t bcd[BCD_BYTES];
+  bcdFromBinary( val, bcd );
+  formatBCD( bcd, text );
+}
+
+#endif
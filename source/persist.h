@@ -0,0 +1,153 @@
+#ifndef PERSIST_H
+#define PERSIST_H
+
+/*
+  ___ ___                _________        .__
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/
+
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+--- Description: ---
+Keeps the calculator's state in the EEPROM so it comes back where it was
+left after a power cycle. Records go round a ring of slots, so each save
+wears a different part of the EEPROM, and are written a byte at a time
+in the background once the keys have been idle for a while.
+*/
+
+#include <stddef.h>
+#include <EEPROM.h>
+#include "calculator.h"
+
+/*******************************************
+* Record Ring                              *
+*******************************************/
+// The whole EEPROM is a ring of fixed-size slots. Each save goes into the slot after the newest
+// one with the next sequence number, so a byte is rewritten at most once every PERSIST_SLOTS saves
+// (less, as bytes that already hold the right value are skipped). At boot every slot is read, the
+// ones whose CRC fails are ignored, and the valid one with the newest sequence number wins. A slot
+// whose write was cut short by a power loss fails its CRC (written last), so the one before it
+// takes over.
+//
+// A byte of EEPROM takes milliseconds to write, so the writer never waits for one: persistPoll()
+// starts the next byte only when the EEPROM is idle, and loop() calls it on every pass.
+
+#ifndef HEXCALC_PERSIST
+#define HEXCALC_PERSIST 1                                                      // Set to 0 to start from scratch at every power up
+#endif
+#ifndef PERSIST_IDLE_MS
+#define PERSIST_IDLE_MS 2000                                                   // Keys idle this long before the state is saved
+#endif
+
+#define PERSIST_FORMAT 1                                                       // Change when the record changes, so old records fail their CRC
+#define PERSIST_VALUE_BYTES (WIDE_BITS / 8)                                    // Room for a value (extended precision ones included)
+
+struct PersistRecord{
+  uint16_t seq;                                                                // Sequence number (newer is larger, wrapping around)
+  uint8_t  mode;                                                               // op_command (bits 0-3), base (4-5: 0 octal, 1 decimal, 2 hex), color_mode (6)
+  uint8_t  depth;                                                              // Bit depth (bits 0-2, PERSIST_DEPTH_*), store_flag (3), result_active (4)
+  uint8_t  menu;                                                               // menu_mode (bits 0-1), base_color (2-3: color, octal, decimal, hex)
+  uint8_t  spare;                                                              // (0; keeps crc 16-bit aligned, so the layout is the same on the host)
+  uint8_t  current[PERSIST_VALUE_BYTES];                                       // val_current (or the wide value), least significant byte first
+  uint8_t  stored[PERSIST_VALUE_BYTES];                                        // val_stored
+  uint16_t crc;                                                                // CRC-16 of everything above
+};
+
+#define PERSIST_DEPTH_8    0
+#define PERSIST_DEPTH_16   1
+#define PERSIST_DEPTH_24   2
+#define PERSIST_DEPTH_32   3
+#define PERSIST_DEPTH_64   4
+#define PERSIST_DEPTH_WIDE 5
+
+#define PERSIST_SLOTS (EEPROM_SIZE / sizeof(PersistRecord))                    // 12 of 40 bytes in the AVR128DA28's 512
+static_assert( PERSIST_SLOTS >= 2, "the ring needs a slot to fall back on" );
+
+#if HEXCALC_PERSIST
+
+PersistRecord persist_record;                                                  // The newest record (being written, or in the EEPROM)
+uint8_t       persist_slot;                                                    // Slot of persist_record
+uint8_t       persist_written = sizeof(PersistRecord);                         // Bytes of it written so far (all of them when idle)
+
+uint16_t persistCrc( const PersistRecord &r ){                                 // CRC-16/CCITT of a record, up to its crc
+  const uint8_t *p = (const uint8_t *)&r;
+  uint16_t crc = 0xFFFF ^ PERSIST_FORMAT;
+  for( uint8_t i = 0; i < offsetof( PersistRecord, crc ); i++ ){
+    crc ^= uint16_t( p[i] ) << 8;
+    for( uint8_t b = 0; b < 8; b++ ) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+bool persistLoad( PersistRecord &r ){                                          // Finds the newest valid record (false if there isn't one)
+  bool found = false;
+  for( uint8_t slot = 0; slot < PERSIST_SLOTS; slot++ ){
+    PersistRecord candidate;
+    uint8_t *p = (uint8_t *)&candidate;
+    for( uint8_t i = 0; i < sizeof(PersistRecord); i++ ) p[i] = EEPROM.read( slot * sizeof(PersistRecord) + i );
+    if( candidate.crc != persistCrc( candidate ) ) continue;
+    if( found && (int16_t)(candidate.seq - persist_record.seq) <= 0 ) continue; // (every valid record is within PERSIST_SLOTS of the others)
+    persist_record = candidate;
+    persist_slot = slot;
+    found = true;
+  }
+  if( found ) r = persist_record;
+  else persist_slot = PERSIST_SLOTS - 1;                                       // (the first save goes into slot 0)
+  return found;
+}
+
+bool persistWriting(){ return persist_written < sizeof(PersistRecord); }
+
+bool persistSave( PersistRecord &r ){                                          // Starts writing r into the next slot, unless it holds what the newest record does (false if a write is still going)
+  if( persistWriting() ) return false;
+  r.seq = persist_record.seq;
+  r.crc = persist_record.crc;
+  if( !memcmp( &r, &persist_record, sizeof(PersistRecord) ) ) return true;     // Nothing has changed
+  r.seq = persist_record.seq + 1;
+  r.crc = persistCrc( r );
+  persist_record = r;
+  persist_slot = (persist_slot + 1) % PERSIST_SLOTS;
+  persist_written = 0;
+  return true;
+}
+
+bool persistEEPROMBusy(){                                                      // True while the EEPROM is still writing a byte
+#ifdef NVMCTRL_EEBUSY_bm
+  return NVMCTRL.STATUS & NVMCTRL_EEBUSY_bm;
+#else
+  return false;
+#endif
+}
+
+void persistPoll(){                                                            // Writes the next byte that needs it, if the EEPROM is free (called from loop())
+  const uint8_t *p = (const uint8_t *)&persist_record;
+  while( persistWriting() && !persistEEPROMBusy() ){
+    uint16_t address = persist_slot * sizeof(PersistRecord) + persist_written;
+    uint8_t  val = p[persist_written++];                                      // In order, so the CRC goes last
+    if( EEPROM.read( address ) == val ) continue;                              // Already there: no wear, no wait
+    EEPROM.write( address, val );
+    break;
+  }
+}
+
+#endif
+
+#endif
@@ -0,0 +1,274 @@
+#ifndef REMOTE_H
+#define REMOTE_H
+
+/*
+  ___ ___                _________        .__
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/
+
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+--- Description: ---
+Remote control over the serial port, for test rigs: key codes and
+calculator operations come in as lines of short commands and the values
+go back out in every base, without touching the keypad. Build with
+HEXCALC_REMOTE set to 1 to turn it on. The port is the one stats.h uses
+(and its commands still work on it).
+*/
+
+#include "stats.h"
+#include "calculator.h"
+#include "format.h"
+#include "stream.h"
+
+/*******************************************
+* Protocol                                 *
+*******************************************/
+// Every line holds one or more commands separated by spaces and gets exactly one line back:
+//
+//   b8 b10 b16              Base
+//   w8 w16 w32 w64 w128     Width (bit depth, w128 being the extended precision mode)
+//   v<digits>               Enters a value in the current base (a new number, or the right operand
+//                           after an operator)
+//   + - * / % & | ^ nor     Operators: the next value is the right operand, = runs it
+//   rol ror << >>           Rotate / shift by the next value
+//   rol1 ror1 shl1 shr1     Rotate / shift the current value by one bit (as the keys do)
+//   not neg bswap wswap     1's / 2's complement, byte / word flip of the current value
+//   = c ac                  Equals, clear, all clear
+//   rgb565 rgb888           Color modes
+//   k<code>                 Any key code (KEY_* in hardware.h), as if it had been typed
+//   ?                       The current value in every base: "h:FF d:255 o:377 b:11111111"
+//                           (plus " e:div0" after a division by zero)
+//   ?h ?d ?o ?b             The current value in one base, digits only
+//   { }                     Start / end a batch
+//   stream ...              Bulk conversion of the values that follow (see stream.h), taking the rest
+//                           of the line as its settings
+//
+// The answer is what the ? commands printed, separated by spaces, or "ok" if there weren't any. A
+// command that makes no sense answers "! <command>" and the rest of its line is skipped.
+//
+// The screen is redrawn once the commands waiting on the port have been run, so a line (or a burst
+// of lines) costs one frame at most. Between { and } nothing is redrawn at all, and a frame that is
+// being drawn stops as soon as the next byte comes in, so the port's receive buffer never has to
+// wait out a whole frame. At REMOTE_BAUD a rig can get a conversion like "v1234 ?d" through in well
+// under a millisecond.
+
+#ifndef REMOTE_BAUD
+#define REMOTE_BAUD 1000000                                                    // Most USB serial adapters manage 1Mbaud (F_CPU / 24, an exact divisor)
+#endif
+#define REMOTE_LINE 160                                                        // Longest line (room for a 128-bit binary value)
+
+#define REMOTE_SERIAL STATS_SERIAL                                             // (both share USART2 on PF0 / PF1)
+
+#if HEXCALC_REMOTE
+
+struct RemoteCommand{ char name[7]; uint8_t key; };                            // A command that is just a key
+
+const RemoteCommand remote_commands[] = {                                      // (the keys labelled ROL / ROR rotate the other way, see applyKey)
+  { "b8",   KEY_BASE_8 },    { "b10",   KEY_BASE_10 },   { "b16",  KEY_BASE_16 },
+  { "w8",   KEY_8_BIT },     { "w16",   KEY_16_BIT },    { "w32",  KEY_32_BIT },   { "w64", KEY_64_BIT },
+  { "+",    KEY_PLUS },      { "-",     KEY_MINUS },     { "*",    KEY_MULT },     { "/",   KEY_DIV },  { "%", KEY_MOD },
+  { "&",    KEY_AND },       { "|",     KEY_OR },        { "^",    KEY_XOR },      { "nor", KEY_NOR },
+  { "rol",  KEY_X_ROL_Y },   { "ror",   KEY_X_ROR_Y },   { "<<",   KEY_X_LS_Y },   { ">>",  KEY_X_RS_Y },
+  { "rol1", KEY_ROR },       { "ror1",  KEY_ROL },       { "shl1", KEY_LSHIFT },   { "shr1", KEY_RSHIFT },
+  { "not",  KEY_1S },        { "neg",   KEY_2S },        { "bswap", KEY_BYTE_FLIP }, { "wswap", KEY_WORD_FLIP },
+  { "=",    KEY_EQUALS },    { "c",     KEY_CLR },       { "ac",   KEY_ALL_CLEAR },
+  { "rgb565", KEY_RGB_565 }, { "rgb888", KEY_RGB_888 },
+};
+#define NUM_REMOTE_COMMANDS (sizeof(remote_commands) / sizeof(remote_commands[0]))
+
+Calculator *remote_calc;                                                       // The calculator being driven
+bool      (*remote_key)( uint8_t key );                                        // Runs a key code (returns false if it did nothing)
+char        remote_line[REMOTE_LINE];                                          // Line being received
+uint8_t     remote_line_length;
+bool        remote_line_overflow;                                              // The line being received didn't fit
+bool        remote_batch;                                                      // True between { and }
+bool        remote_answered;                                                   // Something has been printed for the current line
+
+void remoteBegin( Calculator &calc, bool (*key)( uint8_t ) ){
+  remote_calc = &calc;
+  remote_key = key;
+  REMOTE_SERIAL.begin( REMOTE_BAUD );
+}
+
+bool remotePending(){ return REMOTE_SERIAL.available() > 0; }                  // True if there is input a frame should make way for
+
+void remoteSeparate(){                                                         // Space between the answers of one line
+  if( remote_answered ) REMOTE_SERIAL.write( ' ' );
+  remote_answered = true;
+}
+
+// Values are printed from their little-endian bytes, so the 64-bit and the wide values share the
+// code. The value shown is the one on the screen: the current value masked to the bit depth.
+void remoteRadix( const uint8_t *bytes, uint16_t bits, uint8_t bits_per_digit ){ // Prints the value in base 2^bits_per_digit (no leading zeros)
+  bool started = false;
+  for( int16_t digit = (bits + bits_per_digit - 1) / bits_per_digit - 1; digit >= 0; digit-- ){
+    uint8_t val = 0;
+    for( uint8_t b = bits_per_digit; b-- > 0; ){
+      uint16_t bit = digit * bits_per_digit + b;
+      val = (val << 1) | (bit < bits ? (bytes[bit >> 3] >> (bit & 7)) & 1 : 0);
+    }
+    if( !val && !started && digit ) continue;
+    started = true;
+    REMOTE_SERIAL.write( radix_digits[val] );
+  }
+}
+
+void remoteDecimal( const Calculator &c ){                                     // Prints the value in decimal (18 digits at a time in extended precision)
+  char    text[(WIDE_DEC_DIGITS / WIDE_DEC_PAGE + 1) * WIDE_DEC_PAGE];         // Written backwards from the end (whole chunks of extended precision digits)
+  uint8_t length = 0;
+  uint8_t bcd[BCD_BYTES];
+  WideWord rest = c.wide_current;
+  do {
+    uint8_t digits = BCD_BYTES * 2;
+    if( c.wide() ){
+      bcdFromBinary( rest.divide64( WIDE_DEC_LIMB ), bcd );
+      digits = WIDE_DEC_PAGE;
+    } else {
+      bcdFromBinary( c.val_current & c.bitMask, bcd );
+    }
+    for( uint8_t i = 0; i < digits; i++ ) text[sizeof(text) - 1 - length++] = '0' + ((i & 1) ? (bcd[i >> 1] >> 4) : (bcd[i >> 1] & 0x0F));
+  } while( c.wide() && !rest.isZero() );
+  uint8_t first = sizeof(text) - length;
+  while( first < sizeof(text) - 1 && text[first] == '0' ) first++;
+  for( ; first < sizeof(text); first++ ) REMOTE_SERIAL.write( text[first] );
+}
+
+void remoteValue( char base ){                                                 // Prints the current value in base 'h', 'd', 'o' or 'b'
+  const Calculator &c = *remote_calc;
+  if( base == 'd' ){ remoteDecimal( c ); return; }
+  uint64_t val = c.val_current & c.bitMask;
+  const uint8_t *bytes = c.wide() ? c.wide_current.b : (const uint8_t *)&val;  // (the AVR is little-endian too)
+  uint16_t bits = c.bitDepth;
+  remoteRadix( bytes, bits, base == 'h' ? 4 : base == 'o' ? 3 : 1 );
+}
+
+bool remoteEnterValue( const char *digits ){                                   // v<digits>: false if a digit isn't one of the current base's
+  Calculator &c = *remote_calc;
+  if( !*digits ) return false;
+  for( const char *d = digits; *d; d++ ){
+    if( digitValue( *d ) >= c.base ) return false;
+  }
+  if( !c.store_flag ) remote_key( KEY_CLR );                                   // A new number, unless an operator has already set the old one aside
+  for( ; *digits; digits++ ){
+    remote_key( KEY_0 + digitValue( *digits ) );                               // (KEY_0 to KEY_F are 0 to 15)
+  }
+  return true;
+}
+
+bool remoteRun( const char *cmd ){                                             // Runs one command, false if it isn't one
+  Calculator &c = *remote_calc;
+  for( uint8_t n = 0; n < NUM_REMOTE_COMMANDS; n++ ){
+    if( !strcmp( cmd, remote_commands[n].name ) ){ remote_key( remote_commands[n].key ); return true; }
+  }
+  switch( cmd[0] ){
+    case 'v': return remoteEnterValue( cmd + 1 );
+    case 'k': {
+      char *end;
+      unsigned long key = strtoul( cmd + 1, &end, 10 );
+      if( end == cmd + 1 || *end || key > 69 ) return false;
+      remote_key( key );
+      return true;
+    }
+    case '{': if( cmd[1] ) return false; remote_batch = true;  return true;
+    case '}': if( cmd[1] ) return false; remote_batch = false; return true;
+    case '?':
+      if( !cmd[1] ){                                                           // Every base
+        remoteSeparate();
+        REMOTE_SERIAL.print( "h:" ); remoteValue( 'h' );
+        REMOTE_SERIAL.print( " d:" ); remoteValue( 'd' );
+        REMOTE_SERIAL.print( " o:" ); remoteValue( 'o' );
+        REMOTE_SERIAL.print( " b:" ); remoteValue( 'b' );
+        if( c.error == CALC_ERROR_DIV_BY_ZERO ) REMOTE_SERIAL.print( " e:div0" );
+        return true;
+      }
+      if( cmd[2] || !strchr( "hdob", cmd[1] ) ) return false;
+      remoteSeparate();
+      remoteValue( cmd[1] );
+      return true;
+  }
+  if( !strcmp( cmd, "w128" ) ){                                                // (the 128-bit key pages through the value once it is in that mode)
+    if( !c.wide() ) remote_key( KEY_128_BIT );
+    return true;
+  }
+  return false;
+}
+
+void remoteLine( char *line ){                                                 // Runs a line of commands and answers it
+  remote_answered = false;
+  if( remote_line_overflow ){
+    REMOTE_SERIAL.println( "! line too long" );
+    return;
+  }
+#if HEXCALC_STATS
+  if( statsCommand( line ) ) return;                                           // (stats, mem and reset answer for themselves)
+#endif
+  for( char *cmd = strtok( line, " \t" ); cmd; cmd = strtok( NULL, " \t" ) ){
+    if( !strcmp( cmd, "stream" ) ){                                            // (takes the rest of the line)
+      const char *bad = streamBegin( *remote_calc );
+      if( !bad ) break;
+      cmd = (char *)bad;
+    } else if( remoteRun( cmd ) ) continue;
+    remoteSeparate();
+    REMOTE_SERIAL.print( "! " );
+    REMOTE_SERIAL.print( cmd );
+    break;
+  }
+  if( !remote_answered ) REMOTE_SERIAL.print( "ok" );
+  REMOTE_SERIAL.println();
+}
+
+void remotePoll(){                                                             // Runs every complete line waiting on the port (called from loop())
+  if( stream_active ){
+    streamPoll();
+    if( stream_active ) return;
+  }
+  while( !stream_active && REMOTE_SERIAL.available() ){
+    char ch = REMOTE_SERIAL.read();
+    if( ch == '\r' ) continue;
+    if( ch != '\n' ){
+      if( remote_line_length < REMOTE_LINE - 1 ) remote_line[remote_line_length++] = ch;
+      else remote_line_overflow = true;
+      continue;
+    }
+    remote_line[remote_line_length] = 0;
+    if( remote_line_length || remote_line_overflow ) remoteLine( remote_line );
+    remote_line_length = 0;
+    remote_line_overflow = false;
+  }
+}
+
+// Hooks
+#define REMOTE_SETUP( calc, key )  remoteBegin( calc, key )
+#define REMOTE_POLL()              remotePoll()
+#define REMOTE_PENDING()           remotePending()                             // Input a frame should stop for
+#define REMOTE_HOLD()              (remote_batch || stream_active)             // True while a batch or a stream holds off the redraw
+
+#else
+
+#define REMOTE_SETUP( calc, key )  ((void)0)
+#define REMOTE_POLL()              ((void)0)
+#define REMOTE_PENDING()           false
+#define REMOTE_HOLD()              false
+
+#endif
+
+#endif
@@ -0,0 +1,372 @@
+#ifndef STATS_H
+#define STATS_H
+
+/*
+  ___ ___                _________        .__
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/
+
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+--- Description: ---
+Field instrumentation: how long each stage of a frame takes, how many
+pixel words it sends, how long a keypad scan takes, how long a key
+waits to reach the screen, and how much of the RAM the stack, the heap
+and the static data use. Build with HEXCALC_STATS set to 1 to turn it
+on, then send "stats" or "mem" over the serial port for a CSV dump of
+the counters or the memory use and "reset" to clear them. With
+HEXCALC_STATS at 0 (the default) every hook below compiles to nothing.
+*/
+
+#include <Arduino.h>
+
+#ifndef HEXCALC_STATS
+#define HEXCALC_STATS 0                                                        // Set to 1 to build the instrumentation in
+#endif
+
+/*******************************************
+* Counters                                 *
+*******************************************/
+// Every counter keeps its count, minimum, maximum and sum (for the average), plus a histogram of
+// powers of two: bucket n counts values below 2^n (and at least 2^(n-1)), and the last bucket takes
+// everything bigger. Times are in microseconds, the frame's pixel words in words.
+//
+// The render stages are summed over a frame and recorded once the frame is done, so the tags stage
+// is what all five tags (and the page tag) cost together in that frame. Stages that had nothing to
+// draw in a frame are not recorded for it. The key scan is recorded from the scan interrupt, so a dump
+// taken while keys are held can catch that one line half updated.
+#define STAT_TAGS          0                                                   // Mode and page tags
+#define STAT_LARGE_NUMBER  1                                                   // The current value
+#define STAT_SMALL_NUMBER  2                                                   // The stored value
+#define STAT_OP_TAG        3                                                   // Operator / error tag
+#define STAT_MENU          4                                                   // Bottom menu (binary, decimal or color widgets)
+#define STAT_CLEAR         5                                                   // Blanking out widgets that went away or moved
+#define STAT_FRAME         6                                                   // A whole renderScreen() call
+#define STAT_SPI_WORDS     7                                                   // Pixel words a frame sends
+#define STAT_KEY_SCAN      8                                                   // One scan of the keypad matrix
+#define STAT_KEY_LATENCY   9                                                   // From the scan that saw a key to the end of the frame that shows it
+#define STAT_BOOT          10                                                  // From reset to the end of the first frame (with the backlight on)
+#define STAT_COUNT         11
+#define STAT_STAGES        6                                                   // STAT_TAGS .. STAT_CLEAR are summed per frame
+
+#define STAT_BUCKETS       16                                                  // Histogram buckets (the last one takes 2^14 and up)
+
+#ifndef STATS_SERIAL
+#define STATS_SERIAL Serial2                                                   // USART2 on PF0 (TX) / PF1 (RX), the only USART whose pins are free
+#endif
+#define STATS_BAUD 115200
+#define STATS_LINE 16                                                          // Longest command line
+
+#ifndef HEXCALC_REMOTE
+#define HEXCALC_REMOTE 0                                                       // Set to 1 for the remote control protocol (remote.h), which then owns the port
+#endif
+
+#if HEXCALC_STATS
+
+struct StatCounter{
+  uint32_t count;
+  uint32_t min, max;
+  uint64_t sum;
+  uint16_t buckets[STAT_BUCKETS];                                              // (stop at 65535 rather than wrap)
+};
+
+const char *const stat_names[STAT_COUNT] = {
+  "tags", "large_number", "small_number", "op_tag", "menu", "clear", "frame", "spi_words", "key_scan", "key_latency", "boot"
+};
+
+StatCounter stats[STAT_COUNT];                                                 // The stats block
+uint32_t    stats_stage_us[STAT_STAGES];                                       // Stage times of the frame being drawn
+uint8_t     stats_stages_drawn;                                                // Stages (bit n = stage n) that drew something in it
+uint32_t    stats_frame_words;                                                 // Pixel words queued in it
+uint32_t    stats_key_us;                                                      // micros() of the oldest key the screen doesn't show yet
+bool        stats_key_waiting;                                                 // Whether there is one
+char        stats_line[STATS_LINE];                                            // Command being received
+uint8_t     stats_line_length;
+
+void statsRecord( uint8_t stat, uint32_t val ){
+  StatCounter &s = stats[stat];
+  if( s.count == 0 || val < s.min ) s.min = val;
+  if( s.count == 0 || val > s.max ) s.max = val;
+  s.count++;
+  s.sum += val;
+  uint8_t bucket = 0;
+  for( uint32_t v = val; v && bucket < STAT_BUCKETS - 1; v >>= 1 ) bucket++;
+  if( s.buckets[bucket] != 0xFFFF ) s.buckets[bucket]++;
+}
+
+void statsReset(){
+  memset( stats, 0, sizeof(stats) );
+  stats_key_waiting = false;
+}
+
+void statsStage( uint8_t stage, uint32_t us ){ stats_stage_us[stage] += us; stats_stages_drawn |= 1 << stage; }
+
+void statsFrameDone( uint32_t frame_us, bool complete ){                       // Records the frame's stages, and the key latency if it finished
+  for( uint8_t stage = 0; stage < STAT_STAGES; stage++ ){
+    if( stats_stages_drawn & (1 << stage) ) statsRecord( stage, stats_stage_us[stage] );
+    stats_stage_us[stage] = 0;
+  }
+  stats_stages_drawn = 0;
+  statsRecord( STAT_FRAME, frame_us );
+  statsRecord( STAT_SPI_WORDS, stats_frame_words );
+  stats_frame_words = 0;
+  if( complete && stats_key_waiting ){
+    statsRecord( STAT_KEY_LATENCY, micros() - stats_key_us );
+    stats_key_waiting = false;
+  }
+}
+
+void statsKey( uint32_t seen_us ){                                             // A key changed the state (the latency runs from the first one the screen hasn't caught up with)
+  if( stats_key_waiting ) return;
+  stats_key_us = seen_us;
+  stats_key_waiting = true;
+}
+
+#endif
+
+
+/*******************************************
+* Memory                                   *
+*******************************************/
+// Every free byte between the static data (or the heap, if anything mallocs) and the stack is painted
+// with MEM_PAINT before main() runs. The stack only ever overwrites it, so the lowest byte that lost the
+// paint is the deepest the stack has been: its high-water mark. loop() rescans every MEM_CHECK_MS.
+//
+// The widget draw functions are probed one at a time. Right before one runs, the MEM_PROBE_WINDOW bytes
+// below the stack pointer are repainted, and the lowest byte it overwrote gives its peak stack use. A
+// draw that reports the whole window went at least that deep. (Like any paint check, a local array that
+// happens to end in MEM_PAINT bytes makes the numbers read a little low.)
+//
+// The host build has no AVR memory map, so it paints MEM_HOST_STACK bytes below setup()'s frame and
+// its stack numbers are those of the host's code. Its static total is the whole host program's .data
+// and .bss (the mock panel's framebuffer included), and its heap is what glibc's malloc has handed out.
+#define MEM_PAINT    0xC5                                                      // What an unused stack byte holds
+#define MEM_CHECK_MS 1000                                                      // Time between high-water checks
+#define MEM_PROBES   16                                                        // Draw functions that can be probed (see mem_probe_names)
+
+#ifdef HEXCALC_HOST
+#define MEM_GUARD        256                                                   // Bytes left alone below the stack pointer when painting (x86-64 leaf functions use 128 without moving it)
+#define MEM_PROBE_WINDOW 4096
+#define MEM_HOST_STACK   32768
+#define MEM_SP()         ((uint8_t *)__builtin_frame_address( 0 ))             // Stack pointer (near enough)
+#include <malloc.h>
+extern uint8_t __data_start, _end;                                             // From the linker (start of .data, end of .bss)
+#else
+#define MEM_GUARD        16
+#define MEM_PROBE_WINDOW 512
+#define MEM_SP()         ((uint8_t *)SP)
+extern uint8_t __data_start, __bss_end, __heap_start;                          // From the linker script
+extern char *__brkval;                                                         // Top of the heap (0 until the first malloc)
+#endif
+
+#if HEXCALC_STATS
+
+extern const char *const mem_probe_names[MEM_PROBES];                          // Names of the probes, next to the widget table (NULL for unused ones)
+
+uint8_t  *mem_top;                                                             // Where the stack starts
+uint8_t  *mem_lowest;                                                          // Lowest byte the stack has overwritten so far
+uint16_t  mem_probe_peak[MEM_PROBES];                                          // Deepest each probed function went below its caller
+uint32_t  mem_next_check;                                                      // millis() of the next high-water check
+
+#ifndef HEXCALC_HOST
+void memPaintAtBoot() __attribute__(( naked, used, section( ".init3" ) ));
+void memPaintAtBoot(){                                                         // Runs before main(), while the stack is still empty (and before .data / .bss are set up)
+  for( uint8_t *p = &__heap_start; p <= (uint8_t *)RAMEND; p++ ) *p = MEM_PAINT;
+}
+#endif
+
+uint8_t *memFloor(){                                                           // Lowest address the stack can grow down to
+#ifdef HEXCALC_HOST
+  return mem_top - MEM_HOST_STACK;
+#else
+  return __brkval ? (uint8_t *)__brkval : &__heap_start;
+#endif
+}
+uint32_t memStatic(){                                                          // Bytes of .data and .bss
+#ifdef HEXCALC_HOST
+  return &_end - &__data_start;
+#else
+  return &__bss_end - &__data_start;
+#endif
+}
+uint32_t memHeap(){                                                            // Bytes malloc has handed out
+#ifdef HEXCALC_HOST
+  return mallinfo2().uordblks;
+#else
+  return __brkval ? (uint8_t *)__brkval - &__heap_start : 0;
+#endif
+}
+
+void memPaint( uint8_t *from, uint8_t *to ){                                   // Paints [from, to), stopping MEM_GUARD short of its own frame
+  uint8_t *limit = MEM_SP() - MEM_GUARD;
+  if( to > limit ) to = limit;
+  for( volatile uint8_t *p = from; p < to; p++ ) *p = MEM_PAINT;              // (volatile, so it can't become a call to memset that would have a frame of its own)
+}
+uint8_t *memScan( uint8_t *from, uint8_t *to ){                                // Lowest byte in [from, to) that lost the paint (to if none did)
+  volatile uint8_t *p = from;
+  while( p < to && *p == MEM_PAINT ) p++;
+  return (uint8_t *)p;
+}
+
+void memCheck(){                                                               // Moves the high-water mark down if the stack went deeper
+  mem_lowest = memScan( memFloor(), mem_lowest );
+}
+
+void memBegin(){
+#ifdef HEXCALC_HOST
+  mem_top = MEM_SP();
+  memPaint( memFloor(), mem_top );
+#else
+  mem_top = (uint8_t *)RAMEND + 1;                                             // (painted by memPaintAtBoot)
+#endif
+  mem_lowest = mem_top;
+  memCheck();
+}
+
+void memReset(){                                                               // Repaints the free stack and forgets the probe peaks
+  memPaint( memFloor(), MEM_SP() );
+  mem_lowest = mem_top;
+  memCheck();
+  memset( mem_probe_peak, 0, sizeof(mem_probe_peak) );
+}
+
+uint8_t *memProbeWindow( uint8_t *sp ){                                        // Bottom of the probe window below sp
+  uint8_t *floor = memFloor();
+  return sp - floor > MEM_PROBE_WINDOW ? sp - MEM_PROBE_WINDOW : floor;
+}
+uint8_t *memProbeBegin( uint8_t *sp ){                                         // Repaints the window below the caller's stack pointer sp (returns sp)
+  uint8_t *from = memProbeWindow( sp );
+  uint8_t *low  = memScan( from, sp );                                         // Keep the high-water mark the repaint is about to cover up
+  if( low < mem_lowest ) mem_lowest = low;
+  memPaint( from, sp );
+  return sp;
+}
+void memProbeEnd( uint8_t probe, uint8_t *sp ){                                // Records how far below sp the probed call went
+  uint8_t *low = memScan( memProbeWindow( sp ), sp );
+  if( low < mem_lowest ) mem_lowest = low;
+  uint16_t used = sp - low;
+  if( used > mem_probe_peak[probe] ) mem_probe_peak[probe] = used;
+}
+
+void memPrint(){                                                               // Memory use as CSV, in bytes
+  memCheck();
+  STATS_SERIAL.println( "mem,bytes" );
+  STATS_SERIAL.print( "static," );      STATS_SERIAL.print( memStatic() );                  STATS_SERIAL.println();
+  STATS_SERIAL.print( "heap," );        STATS_SERIAL.print( memHeap() );                    STATS_SERIAL.println();
+  STATS_SERIAL.print( "stack_now," );   STATS_SERIAL.print( (uint32_t)(mem_top - MEM_SP()) );       STATS_SERIAL.println();
+  STATS_SERIAL.print( "stack_peak," );  STATS_SERIAL.print( (uint32_t)(mem_top - mem_lowest) );     STATS_SERIAL.println();
+  STATS_SERIAL.print( "stack_free," );  STATS_SERIAL.print( (uint32_t)(mem_lowest - memFloor()) );  STATS_SERIAL.println(); // Never touched: the headroom left
+  for( uint8_t n = 0; n < MEM_PROBES; n++ ){
+    if( !mem_probe_names[n] ) continue;
+    STATS_SERIAL.print( mem_probe_names[n] ); STATS_SERIAL.print( "," ); STATS_SERIAL.print( (uint32_t)mem_probe_peak[n] ); STATS_SERIAL.println();
+  }
+}
+
+#endif
+
+
+/*******************************************
+* Serial Commands                          *
+*******************************************/
+
+#if HEXCALC_STATS
+
+void statsPrint(){                                                             // The stats block as CSV, one counter per line
+  STATS_SERIAL.print( "stat,count,min,max,avg" );
+  for( uint8_t b = 0; b < STAT_BUCKETS - 1; b++ ){ STATS_SERIAL.print( ",lt" ); STATS_SERIAL.print( (uint32_t)1 << b ); }
+  STATS_SERIAL.print( ",ge" ); STATS_SERIAL.print( (uint32_t)1 << (STAT_BUCKETS - 2) );
+  STATS_SERIAL.println();
+  for( uint8_t n = 0; n < STAT_COUNT; n++ ){
+    const StatCounter &s = stats[n];
+    STATS_SERIAL.print( stat_names[n] );
+    STATS_SERIAL.print( "," ); STATS_SERIAL.print( s.count );
+    STATS_SERIAL.print( "," ); STATS_SERIAL.print( s.min );
+    STATS_SERIAL.print( "," ); STATS_SERIAL.print( s.max );
+    STATS_SERIAL.print( "," ); STATS_SERIAL.print( s.count ? (uint32_t)(s.sum / s.count) : 0 );
+    for( uint8_t b = 0; b < STAT_BUCKETS; b++ ){ STATS_SERIAL.print( "," ); STATS_SERIAL.print( (uint32_t)s.buckets[b] ); }
+    STATS_SERIAL.println();
+  }
+}
+
+void statsBegin(){
+  memBegin();
+#if !HEXCALC_REMOTE
+  STATS_SERIAL.begin( STATS_BAUD );                                            // (remote.h opens the port at its own speed)
+#endif
+}
+
+bool statsCommand( const char *line ){                                         // Answers a stats command line (false if it isn't one)
+  if( !strcmp( line, "stats" ) ) statsPrint();
+  else if( !strcmp( line, "mem" ) ) memPrint();
+  else if( !strcmp( line, "reset" ) ){ statsReset(); memReset(); STATS_SERIAL.println( "ok" ); }
+  else return false;
+  return true;
+}
+
+void statsPoll(){                                                              // Reads commands off the serial port (called from loop())
+  if( (int32_t)(millis() - mem_next_check) >= 0 ){
+    mem_next_check = millis() + MEM_CHECK_MS;
+    memCheck();
+  }
+#if !HEXCALC_REMOTE                                                            // (otherwise remote.h reads the lines and hands these on)
+  while( STATS_SERIAL.available() ){
+    char c = STATS_SERIAL.read();
+    if( c != '\r' && c != '\n' ){
+      if( stats_line_length < STATS_LINE - 1 ) stats_line[stats_line_length++] = c;
+      continue;
+    }
+    stats_line[stats_line_length] = 0;
+    if( !statsCommand( stats_line ) && stats_line_length ) STATS_SERIAL.println( "?" );
+    stats_line_length = 0;
+  }
+#endif
+}
+
+// Hooks
+#define STATS_BEGIN( t )           uint32_t t = micros()                       // Starts a timer
+#define STATS_END( stat, t )       statsRecord( stat, micros() - (t) )         // Records the time since STATS_BEGIN
+#define STATS_STAGE( stage, t )    statsStage( stage, micros() - (t) )         // Adds the time since STATS_BEGIN to a render stage
+#define STATS_FRAME( t, complete ) statsFrameDone( micros() - (t), complete )
+#define STATS_WORDS( n )           (stats_frame_words += (n))
+#define STATS_KEY( seen_us )       statsKey( seen_us )
+#define STATS_SETUP()              statsBegin()
+#define STATS_POLL()               statsPoll()
+#define STATS_BOOT()               statsRecord( STAT_BOOT, micros() )          // (micros() counts from reset)
+#define MEM_PROBE_BEGIN( sp )      uint8_t *sp = memProbeBegin( MEM_SP() )     // Starts a stack probe
+#define MEM_PROBE_END( probe, sp ) memProbeEnd( probe, sp )                    // Records the probed call's peak under mem_probe_names[probe]
+
+#else
+
+#define STATS_BEGIN( t )
+#define STATS_END( stat, t )       ((void)0)
+#define STATS_STAGE( stage, t )    ((void)0)
+#define STATS_FRAME( t, complete ) ((void)0)
+#define STATS_WORDS( n )           ((void)0)
+#define STATS_KEY( seen_us )       ((void)0)
+#define STATS_SETUP()              ((void)0)
+#define STATS_POLL()               ((void)0)
+#define STATS_BOOT()               ((void)0)
+#define MEM_PROBE_BEGIN( sp )
+#define MEM_PROBE_END( probe, sp ) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,309 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+/*
+  ___ ___                _________        .__
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/
+
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+--- Description: ---
+Streaming bulk conversion over the remote control's serial port, for
+pasting register dumps: values flow in as text in any base and bit depth,
+go through one fixed operation (a byte flip, a mask, a shift...) using
+the Calculator's own kernels, and flow back out in hex, decimal, octal
+and ASCII, without touching the calculator or the display. Built in
+along with remote.h (HEXCALC_REMOTE).
+*/
+
+#include "stats.h"
+#include "calculator.h"
+#include "format.h"
+
+/*******************************************
+* Protocol                                 *
+*******************************************/
+// The remote command "stream" switches the port over, taking the rest of its line as settings:
+//
+//   b8 b10 b16              Base of the values coming in (default: the calculator's)
+//   w8 w16 w32 w64          Bit depth (default: the calculator's, or 64 in the extended precision mode)
+//   not neg bswap wswap     One-step operation to apply to every value
+//   &X |X ^X +X -X *X /X %X Two-step operation with a fixed right operand X (in the base above)
+//   <<X >>X rolX rorX       Shift / rotate every value by X
+//   =hdoa                   Fields to send back, in order: hex, decimal, octal, ASCII (default =hd)
+//
+// e.g. "stream b16 w32 bswap =ha". It answers "ok", and from then on every value that comes in gets
+// one line back with its fields separated by spaces, or "!" if it isn't a value of that base and
+// depth. Values are separated by spaces, tabs, commas, semicolons or line breaks, may start with
+// 0x to be read as hex whatever the base, and a word ending in ':' (an address) is skipped. A "."
+// or a Ctrl-D (EOT) ends the stream; "ok" comes back once everything before it has been answered.
+//
+// The work is split into three stages with bounded buffers between them, and each pass of loop()
+// runs whatever each stage has room for: the parser turns bytes from the port into values
+// (STREAM_VALUES of them), the kernel and formatters turn values into lines of text (STREAM_OUT
+// bytes), and the writer hands the text to the port, never more than STREAM_TX_DEPTH bytes ahead of
+// the wire. An answer is usually longer than the value it came from, so the answers set the pace:
+// once the stages are full the port's receive buffer starts to fill, and the sender is asked to
+// pause with XOFF at STREAM_XOFF_AT bytes and to go on with XON at STREAM_XON_AT. Keeping the
+// transmit side shallow keeps the XOFF from queueing behind a full buffer of answers, so the bytes
+// still on their way when the sender hears it fit in what is left of the receive buffer.
+
+#ifndef SERIAL_RX_BUFFER_SIZE
+#define SERIAL_RX_BUFFER_SIZE 64                                               // DxCore's receive buffer (parts with 4K or more of RAM)
+#endif
+#ifndef SERIAL_TX_BUFFER_SIZE
+#define SERIAL_TX_BUFFER_SIZE 64                                               // DxCore's transmit buffer
+#endif
+
+#define STREAM_VALUES   8                                                      // Values parsed but not yet converted
+#define STREAM_OUT      128                                                    // Bytes of answers waiting for the port (a power of two)
+#define STREAM_LINE     72                                                     // Longest answer: 16 hex + 20 decimal + 22 octal + 8 ASCII, 3 spaces and "\r\n"
+#define STREAM_TOKEN    25                                                     // Longest value: 0x and 22 octal digits
+#define STREAM_TX_DEPTH 16                                                     // Bytes the writer lets the port's transmit buffer hold
+#define STREAM_XOFF_AT  (SERIAL_RX_BUFFER_SIZE / 2)                            // Bytes waiting on the port that pause the sender
+#define STREAM_XON_AT   8                                                      // ... and that let it go on again
+
+#define STREAM_SERIAL STATS_SERIAL                                             // The remote control's port
+
+#define STREAM_XON  0x11                                                       // DC1
+#define STREAM_XOFF 0x13                                                       // DC3
+#define STREAM_EOT  0x04                                                       // Ctrl-D
+
+static_assert( (STREAM_OUT & (STREAM_OUT - 1)) == 0 && STREAM_OUT <= 256, "STREAM_OUT indexes a uint8_t ring" );
+static_assert( hexDigits( 64 ) + BCD_BYTES * 2 + octalDigits( 64 ) + 8 + 3 + 2 <= STREAM_LINE, "An answer with every field once is longer than STREAM_LINE" );
+
+#if HEXCALC_REMOTE
+
+struct StreamUnary{ char name[6]; UnaryKernel CalcKernels::*kernel; };          // A one-step operation
+struct StreamBinary{ char name[4]; uint8_t op; };                              // A two-step operation (OP_*)
+struct StreamValue{ uint64_t val; bool ok; };                                  // A parsed value (ok is false if it wasn't one)
+
+const StreamUnary stream_unary_ops[] = {
+  { "not", &CalcKernels::onesCompliment }, { "neg", &CalcKernels::twosCompliment },
+  { "bswap", &CalcKernels::byteFlip },     { "wswap", &CalcKernels::wordFlip },
+};
+const StreamBinary stream_binary_ops[] = {                                     // (<< and >> before the others, so they aren't mistaken for operands)
+  { "<<", OP_LEFT_SHIFT }, { ">>", OP_RIGHT_SHIFT }, { "rol", OP_ROL },    { "ror", OP_ROR },
+  { "&",  OP_AND },        { "|",  OP_OR },          { "^",   OP_XOR },
+  { "+",  OP_PLUS },       { "-",  OP_MINUS },       { "*",   OP_MULTIPLY }, { "/", OP_DIVIDE }, { "%", OP_MOD },
+};
+
+bool               stream_active;                                              // True while the port belongs to the stream
+bool               stream_ending;                                              // The end has come in, waiting for the answers to go out
+bool               stream_paused;                                              // XOFF has been sent
+uint8_t            stream_base;
+uint8_t            stream_bits;
+const CalcKernels *stream_kernels;                                             // Kernels for stream_bits
+UnaryKernel        stream_unary;                                               // The one-step operation (NULL if none)
+uint8_t            stream_op;                                                  // The two-step operation (OP_NONE if none)
+uint64_t           stream_operand;                                             // ... and its right operand
+char               stream_fields[5];                                           // Fields of an answer ("hdoa" in any order)
+
+char               stream_token[STREAM_TOKEN];                                 // Value being received
+uint8_t            stream_token_length;
+bool               stream_token_overflow;
+StreamValue        stream_values[STREAM_VALUES];                               // Parser -> formatter
+uint8_t            stream_values_head, stream_values_tail;
+char               stream_out[STREAM_OUT];                                     // Formatter -> writer
+uint8_t            stream_out_head, stream_out_tail;
+
+/*******************************************
+* Parser                                   *
+*******************************************/
+// Checked digit by digit without any 64-bit division: hex and octal only need the bits that are
+// about to be shifted out to be clear, and decimal uses the same limit as typing a number in.
+bool streamParse( const char *text, uint8_t base, uint8_t bits, uint64_t &val ){ // False if text isn't a value of base and bits
+  if( text[0] == '0' && (text[1] == 'x' || text[1] == 'X') ){ base = 16; text += 2; }
+  if( !*text ) return false;
+  val = 0;
+  for( ; *text; text++ ){
+    char    c = *text;
+    uint8_t digit = digitValue( c );
+    if( digit >= base ) return false;
+    if( base == 16 ){ if( val >> 60 ) return false; val = (val << 4) | digit; }
+    else if( base == 8 ){ if( val >> 61 ) return false; val = (val << 3) | digit; }
+    else {
+      if( val > BCD_SHIFT_LIMIT || (val == BCD_SHIFT_LIMIT && digit > 5) ) return false;
+      val = val * 10 + digit;
+    }
+  }
+  return bits == 64 || !(val >> bits);
+}
+
+void streamToken(){                                                            // Queues the value that just ended (the queue has room)
+  stream_token[stream_token_length] = 0;
+  bool overflow = stream_token_overflow;
+  stream_token_length = 0;
+  stream_token_overflow = false;
+  if( !stream_token[0] && !overflow ) return;
+  if( !overflow && stream_token[strlen( stream_token ) - 1] == ':' ) return;   // An address
+  if( !overflow && !strcmp( stream_token, "." ) ){ stream_ending = true; return; }
+  StreamValue &v = stream_values[stream_values_head % STREAM_VALUES];
+  v.ok = !overflow && streamParse( stream_token, stream_base, stream_bits, v.val );
+  stream_values_head++;
+}
+
+void streamByte( char ch ){
+  if( ch == STREAM_EOT ){ streamToken(); stream_ending = true; return; }
+  if( ch == ' ' || ch == '\t' || ch == ',' || ch == ';' || ch == '\r' || ch == '\n' ){ streamToken(); return; }
+  if( stream_token_length < STREAM_TOKEN - 1 ) stream_token[stream_token_length++] = ch;
+  else stream_token_overflow = true;
+}
+
+/*******************************************
+* Formatter                                *
+*******************************************/
+uint8_t streamField( uint64_t val, char field, char *p ){                      // Writes one field of an answer at p and returns its length
+  if( field == 'h' || field == 'o' ){                                          // Every digit of the depth, so the columns line up
+    NumberText text;
+    if( field == 'h' ) formatRadix( val, 4, hexDigits( stream_bits ), 0, text );
+    else               formatRadix( val, 3, octalDigits( stream_bits ), 0, text );
+    memcpy( p, text.str(), text.length );
+    return text.length;
+  }
+  uint8_t n = 0;
+  if( field == 'd' ){                                                          // No commas, and no padding
+    uint8_t bcd[BCD_BYTES];
+    bcdFromBinary( val, bcd );
+    uint8_t digits = BCD_BYTES * 2;
+    while( digits > 1 && !((bcd[(digits - 1) >> 1] >> (((digits - 1) & 1) * 4)) & 0x0F) ) digits--;
+    while( digits-- > 0 ) p[n++] = '0' + ((bcd[digits >> 1] >> ((digits & 1) * 4)) & 0x0F);
+  } else {                                                                     // ASCII: most significant byte first, '.' for anything unprintable
+    for( uint8_t i = stream_bits / 8; i-- > 0; ){
+      uint8_t c = val >> (i * 8);
+      p[n++] = (c >= 0x20 && c < 0x7F) ? c : '.';
+    }
+  }
+  return n;
+}
+
+void streamFormat( const StreamValue &v ){                                     // Runs the operation on a value and queues its answer (there is room for a whole line)
+  char    line[STREAM_LINE];
+  uint8_t n = 0;
+  if( !v.ok ) line[n++] = '!';
+  else {
+    uint64_t val = v.val;
+    if( stream_unary ) val = stream_unary( val );
+    if( stream_op != OP_NONE ) val = stream_kernels->binary[stream_op]( val, stream_operand );
+    for( const char *f = stream_fields; *f; f++ ){
+      if( f != stream_fields ) line[n++] = ' ';
+      n += streamField( val, *f, line + n );
+    }
+  }
+  line[n++] = '\r';
+  line[n++] = '\n';
+  for( uint8_t i = 0; i < n; i++ ) stream_out[stream_out_head++ % STREAM_OUT] = line[i];
+}
+
+/*******************************************
+* Stream                                   *
+*******************************************/
+const char *streamBegin( const Calculator &calc ){                             // Takes its settings from the rest of the remote's line (strtok) and starts the stream, or returns the setting that's wrong
+  const StreamUnary *unary = NULL;
+  char   *operand = NULL;                                                      // (read once the base and depth are known)
+  uint8_t operand_at = 0;
+  stream_base = calc.base;
+  stream_bits = calc.wide() ? 64 : calc.bitDepth;
+  stream_op = OP_NONE;
+  strcpy( stream_fields, "hd" );
+  for( char *arg = strtok( NULL, " \t" ); arg; arg = strtok( NULL, " \t" ) ){
+    if( !strcmp( arg, "b8" ) )        stream_base = 8;
+    else if( !strcmp( arg, "b10" ) )  stream_base = 10;
+    else if( !strcmp( arg, "b16" ) )  stream_base = 16;
+    else if( !strcmp( arg, "w8" ) )   stream_bits = 8;
+    else if( !strcmp( arg, "w16" ) )  stream_bits = 16;
+    else if( !strcmp( arg, "w32" ) )  stream_bits = 32;
+    else if( !strcmp( arg, "w64" ) )  stream_bits = 64;
+    else if( arg[0] == '=' ){
+      uint8_t n = strlen( arg + 1 );
+      if( !n || n > 4 || strspn( arg + 1, "hdoa" ) != n ) return arg;
+      for( uint8_t i = 1; i < n; i++ ) if( memchr( arg + 1, arg[1 + i], i ) ) return arg; // Each field once, so a line fits in STREAM_LINE
+      strcpy( stream_fields, arg + 1 );
+    } else {
+      const StreamUnary *u = stream_unary_ops;
+      while( u < stream_unary_ops + sizeof(stream_unary_ops) / sizeof(stream_unary_ops[0]) && strcmp( arg, u->name ) ) u++;
+      if( u < stream_unary_ops + sizeof(stream_unary_ops) / sizeof(stream_unary_ops[0]) ){ unary = u; continue; }
+      const StreamBinary *b = stream_binary_ops;
+      while( b < stream_binary_ops + sizeof(stream_binary_ops) / sizeof(stream_binary_ops[0]) && strncmp( arg, b->name, strlen( b->name ) ) ) b++;
+      if( b == stream_binary_ops + sizeof(stream_binary_ops) / sizeof(stream_binary_ops[0]) ) return arg;
+      stream_op  = b->op;
+      operand    = arg;
+      operand_at = strlen( b->name );
+    }
+  }
+  switch( stream_bits ){
+    case 8:  stream_kernels = &WidthKernels<uint8_t,   8>::table; break;
+    case 16: stream_kernels = &WidthKernels<uint16_t, 16>::table; break;
+    case 24: stream_kernels = &WidthKernels<uint32_t, 24>::table; break;
+    case 32: stream_kernels = &WidthKernels<uint32_t, 32>::table; break;
+    default: stream_kernels = &WidthKernels<uint64_t, 64>::table; break;
+  }
+  stream_unary = unary ? stream_kernels->*(unary->kernel) : NULL;
+  if( operand ){
+    if( !streamParse( operand + operand_at, stream_base, stream_bits, stream_operand ) ) return operand;
+    if( (stream_op == OP_DIVIDE || stream_op == OP_MOD) && !stream_operand ) return operand;
+  }
+  stream_active = true;
+  stream_ending = false;
+  stream_paused = false;
+  stream_token_length = 0;
+  stream_token_overflow = false;
+  stream_values_head = stream_values_tail = 0;
+  stream_out_head = stream_out_tail = 0;
+  return NULL;
+}
+
+void streamWrite(){                                                            // Hands answers to the port while it has less than STREAM_TX_DEPTH bytes to send
+  while( stream_out_tail != stream_out_head && STREAM_SERIAL.availableForWrite() >= SERIAL_TX_BUFFER_SIZE - STREAM_TX_DEPTH ){
+    STREAM_SERIAL.write( stream_out[stream_out_tail++ % STREAM_OUT] );
+  }
+}
+
+void streamPoll(){                                                             // Runs each stage as far as the next one has room (called from remotePoll)
+  streamWrite();
+  while( stream_values_tail != stream_values_head && (uint8_t)(STREAM_OUT - (uint8_t)(stream_out_head - stream_out_tail)) >= STREAM_LINE ){
+    streamFormat( stream_values[stream_values_tail++ % STREAM_VALUES] );
+  }
+  streamWrite();
+  while( !stream_ending && (uint8_t)(stream_values_head - stream_values_tail) < STREAM_VALUES && STREAM_SERIAL.available() ){
+    streamByte( STREAM_SERIAL.read() );
+  }
+
+  int waiting = STREAM_SERIAL.available();                                     // Flow control
+  if( !stream_paused && !stream_ending && waiting >= STREAM_XOFF_AT ){ STREAM_SERIAL.write( STREAM_XOFF ); stream_paused = true; }
+  if( stream_paused && (stream_ending || waiting <= STREAM_XON_AT) ){ STREAM_SERIAL.write( STREAM_XON ); stream_paused = false; }
+
+  if( stream_ending && stream_values_tail == stream_values_head && stream_out_tail == stream_out_head ){
+    STREAM_SERIAL.println( "ok" );
+    stream_active = false;
+  }
+}
+
+#define STREAM_ACTIVE() stream_active
+
+#else
+
+#define STREAM_ACTIVE() false
+
+#endif
+
+#endif
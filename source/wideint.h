@@ -0,0 +1,244 @@
+#ifndef WIDEINT_H
+#define WIDEINT_H
+
+/*
+  ___ ___                _________        .__
+ /   |   \   ____ ___  __\_   ___ \_____  |  |   ____
+/   -~-   \_/ __ \\  \/  /    \  \/\__  \ |  | _/ ___\
+\    |    /\  ___/ >    <\     \____/ __ \|  |_\  \___
+ \___|_  /  \___  >__/\_ \\______  (____  /____/\___  >
+       \/       \/      \/       \/     \/          \/
+
+HexCalc Firmware source code designed to run on the AVR128DA28.
+Copyright (C) 2024 Tyler Klein (Things Made Simple)
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+--- Description: ---
+Fixed-width unsigned integers of up to 256 bits for the calculator's
+extended precision mode (128-bit keys, UUIDs and the like).
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+/*******************************************
+* Wide Integer                             *
+*******************************************/
+// The limbs are single bytes, least significant first, because a byte is what the AVR actually
+// works in. Adds and subtracts are one carry chain over the bytes. Multiplies are shift-and-add a
+// byte at a time, with the hardware 8x8 multiplier making each partial product. Division is the
+// restoring shift/subtract loop, run only over the significant bits of the dividend and the
+// significant bytes of the divisor. Shifts and rotates move whole bytes first and then shift the
+// remaining 0-7 bits in a single pass.
+//
+// The loops call WIDE_STEPS() with the number of limbs each pass touches. It does nothing here; the
+// host benchmark defines it to count the steps and estimate what an operation costs on the AVR.
+
+#ifndef WIDE_STEPS
+#define WIDE_STEPS( limbs )                                                    // Counts limb steps in the host benchmark (nothing on the AVR)
+#endif
+
+template< uint8_t BYTES >
+struct WideInt{
+  static constexpr uint16_t BITS = BYTES * 8;                                  // Width in bits
+  static_assert( BYTES >= 8 && BYTES <= 32, "WideInt holds 64 to 256 bits" );
+
+  uint8_t b[BYTES];                                                            // Limbs, least significant first
+
+  // Conversion
+  void     clear(){ memset( b, 0, BYTES ); }
+  void     set( uint64_t val ){ memcpy( b, &val, 8 ); memset( b + 8, 0, BYTES - 8 ); } // (both the AVR and the host are little-endian)
+  uint64_t word( uint8_t i ) const { uint64_t val; memcpy( &val, b + i * 8, 8 ); return val; } // 64-bit word i (0 is the least significant)
+  void     setWord( uint8_t i, uint64_t val ){ memcpy( b + i * 8, &val, 8 ); }
+
+  uint8_t used() const {                                                       // Number of significant bytes (0 for zero)
+    uint8_t n = BYTES;
+    while( n && !b[n - 1] ) n--;
+    return n;
+  }
+  uint16_t bitLength() const {                                                 // Number of significant bits (0 for zero)
+    uint8_t n = used();
+    if( !n ) return 0;
+    uint16_t bits = (n - 1) * 8;
+    for( uint8_t top = b[n - 1]; top; top >>= 1 ) bits++;
+    return bits;
+  }
+  bool isZero() const { return used() == 0; }
+  bool below( uint16_t limit ) const {                                         // True if the value is less than limit
+    return used() <= 2 && (b[0] | (uint16_t( b[1] ) << 8)) < limit;
+  }
+
+  int8_t compare( const WideInt &o, uint8_t len = BYTES ) const {              // -1, 0 or 1 as this is below, equal to or above o (looking at the low len bytes)
+    for( uint8_t i = len; i-- > 0; ) if( b[i] != o.b[i] ) return b[i] < o.b[i] ? -1 : 1;
+    return 0;
+  }
+
+  // Carry Chains
+  uint8_t add( const WideInt &o ){                                             // this += o, returns the carry out of the top
+    uint8_t carry = 0;
+    for( uint8_t i = 0; i < BYTES; i++ ){
+      uint16_t sum = uint16_t( b[i] ) + o.b[i] + carry;
+      b[i]  = sum;
+      carry = sum >> 8;
+    }
+    WIDE_STEPS( BYTES );
+    return carry;
+  }
+  uint8_t sub( const WideInt &o, uint8_t len = BYTES ){                        // this -= o over the low len bytes, returns the borrow out of the top
+    uint8_t borrow = 0;
+    for( uint8_t i = 0; i < len; i++ ){
+      uint16_t diff = uint16_t( b[i] ) - o.b[i] - borrow;
+      b[i]   = diff;
+      borrow = (diff >> 8) & 1;
+    }
+    WIDE_STEPS( len );
+    return borrow;
+  }
+  void addSmall( uint8_t val ){                                                // this += val
+    for( uint8_t i = 0; val && i < BYTES; i++ ){
+      uint16_t sum = uint16_t( b[i] ) + val;
+      b[i] = sum;
+      val  = sum >> 8;
+    }
+  }
+  uint8_t mulSmall( uint8_t m ){                                               // this *= m, returns the byte that overflowed
+    uint8_t carry = 0;
+    for( uint8_t i = 0; i < BYTES; i++ ){
+      uint16_t p = uint16_t( b[i] ) * m + carry;
+      b[i]  = p;
+      carry = p >> 8;
+    }
+    WIDE_STEPS( BYTES );
+    return carry;
+  }
+  void negate(){ invert(); addSmall( 1 ); }                                    // Two's complement
+
+  // Multiply & Divide
+  void mul( const WideInt &x, const WideInt &y ){                              // this = x * y, keeping the low BYTES bytes (neither x nor y may be this)
+    clear();
+    uint8_t xn = x.used(), yn = y.used();
+    for( uint8_t i = 0; i < xn; i++ ){                                         // Add y, shifted up i bytes, x.b[i] times
+      if( !x.b[i] ) continue;
+      uint8_t carry = 0, j = 0;
+      for( ; j < yn && i + j < BYTES; j++ ){
+        uint16_t p = uint16_t( x.b[i] ) * y.b[j] + b[i + j] + carry;           // At most 255 * 255 + 255 + 255, so it fits
+        b[i + j] = p;
+        carry    = p >> 8;
+      }
+      if( i + j < BYTES ) b[i + j] = carry;                                    // Nothing has been written that high yet
+      WIDE_STEPS( j );
+    }
+  }
+
+  void divide( const WideInt &d, WideInt &rem ){                               // this /= d and rem = the remainder (d must not be zero or this)
+    uint8_t  len = d.used() < BYTES ? d.used() + 1 : BYTES;                    // rem stays below d, so only needs d's bytes plus one for the shift
+    uint16_t bit = bitLength();
+    rem.clear();
+    while( bit-- > 0 ){                                                        // The quotient bit goes where the dividend bit came from
+      uint8_t &byte = b[bit >> 3];
+      uint8_t  mask = 1 << (bit & 7);
+      uint8_t  carry = rem.shiftLeft1( (byte & mask) ? 1 : 0, len );
+      byte &= ~mask;
+      if( carry || rem.compare( d, len ) >= 0 ){                               // A carry out of the top means rem passed d too
+        rem.sub( d, len );
+        byte |= mask;
+      }
+      WIDE_STEPS( 2 * len );
+    }
+  }
+
+  uint64_t divide64( uint64_t d ){                                             // this /= d and returns the remainder (d must be non-zero and below 2^63)
+    uint64_t rem = 0;
+    uint16_t bit = bitLength();
+    while( bit-- > 0 ){
+      uint8_t &byte = b[bit >> 3];
+      uint8_t  mask = 1 << (bit & 7);
+      rem = (rem << 1) | ((byte & mask) ? 1 : 0);
+      byte &= ~mask;
+      if( rem >= d ){ rem -= d; byte |= mask; }
+      WIDE_STEPS( 8 );
+    }
+    return rem;
+  }
+
+  // Shifts & Rotates
+  uint8_t shiftLeft1( uint8_t in, uint8_t len = BYTES ){                       // Shifts the low len bytes left by one bit, shifting in `in` and returning the bit that falls out
+    for( uint8_t i = 0; i < len; i++ ){
+      uint8_t out = b[i] >> 7;
+      b[i] = (b[i] << 1) | in;
+      in   = out;
+    }
+    return in;
+  }
+  void shiftLeft( uint16_t n ){                                                // Bits shifted past the top are gone
+    if( n >= BITS ){ clear(); return; }
+    uint8_t bytes = n >> 3, bits = n & 7;
+    if( bytes ){ memmove( b + bytes, b, BYTES - bytes ); memset( b, 0, bytes ); }
+    if( bits ){
+      uint8_t carry = 0;
+      for( uint8_t i = bytes; i < BYTES; i++ ){
+        uint8_t out = b[i] >> (8 - bits);
+        b[i]  = (b[i] << bits) | carry;
+        carry = out;
+      }
+    }
+    WIDE_STEPS( BYTES );
+  }
+  void shiftRight( uint16_t n ){
+    if( n >= BITS ){ clear(); return; }
+    uint8_t bytes = n >> 3, bits = n & 7;
+    if( bytes ){ memmove( b, b + bytes, BYTES - bytes ); memset( b + BYTES - bytes, 0, bytes ); }
+    if( bits ){
+      uint8_t carry = 0;
+      for( uint8_t i = BYTES - bytes; i-- > 0; ){
+        uint8_t out = b[i] << (8 - bits);
+        b[i]  = (b[i] >> bits) | carry;
+        carry = out;
+      }
+    }
+    WIDE_STEPS( BYTES );
+  }
+  void rotateLeft( uint16_t n ){                                               // n wraps around the width
+    n %= BITS;
+    if( !n ) return;
+    WideInt low = *this;
+    shiftLeft( n );
+    low.shiftRight( BITS - n );
+    orWith( low );
+  }
+  void rotateRight( uint16_t n ){ n %= BITS; if( n ) rotateLeft( BITS - n ); }
+
+  // Bitwise
+  void andWith( const WideInt &o ){ for( uint8_t i = 0; i < BYTES; i++ ) b[i] &= o.b[i]; WIDE_STEPS( BYTES ); }
+  void orWith(  const WideInt &o ){ for( uint8_t i = 0; i < BYTES; i++ ) b[i] |= o.b[i]; WIDE_STEPS( BYTES ); }
+  void xorWith( const WideInt &o ){ for( uint8_t i = 0; i < BYTES; i++ ) b[i] ^= o.b[i]; WIDE_STEPS( BYTES ); }
+  void invert(){ for( uint8_t i = 0; i < BYTES; i++ ) b[i] = ~b[i]; WIDE_STEPS( BYTES ); }
+
+  void byteFlip(){                                                             // Reverses the order of the bytes
+    for( uint8_t i = 0; i < BYTES / 2; i++ ){ uint8_t t = b[i]; b[i] = b[BYTES - 1 - i]; b[BYTES - 1 - i] = t; }
+    WIDE_STEPS( BYTES );
+  }
+  void wordFlip(){                                                             // Reverses the order of the two-byte words
+    for( uint8_t i = 0; i < BYTES / 2; i += 2 ){
+      uint8_t lo = b[i], hi = b[i + 1];
+      b[i] = b[BYTES - 2 - i]; b[i + 1] = b[BYTES - 1 - i];
+      b[BYTES - 2 - i] = lo;   b[BYTES - 1 - i] = hi;
+    }
+    WIDE_STEPS( BYTES );
+  }
+};
+
+#endif